@@ -0,0 +1,48 @@
+#ifndef TACO_COMPONENT_TYPE_H
+#define TACO_COMPONENT_TYPE_H
+
+#include <ostream>
+#include <cassert>
+#include <cstdint>
+
+namespace taco {
+
+/// Tensor component types. These are basic types such as double and int. The
+/// components of pattern tensors (e.g. the adjacency matrix of a graph) are all
+/// one, so pattern tensors store only their nonzero structure and no values.
+class ComponentType {
+public:
+  enum Kind {Bool, Int, Int64, Float, Double, Pattern, Unknown};
+  ComponentType() : ComponentType(Unknown) {}
+  ComponentType(Kind kind) : kind(kind)  {}
+  size_t bytes() const;
+  Kind getKind() const;
+private:
+  Kind kind;
+};
+
+bool operator==(const ComponentType& a, const ComponentType& b);
+bool operator!=(const ComponentType& a, const ComponentType& b);
+std::ostream& operator<<(std::ostream&, const ComponentType&);
+template <typename T> inline ComponentType type() {
+  assert(false && "Unsupported type");
+  return ComponentType::Double;
+}
+template <> inline ComponentType type<bool>() {return ComponentType::Bool;}
+template <> inline ComponentType type<int>() {return ComponentType::Int;}
+template <> inline ComponentType type<int64_t>() {return ComponentType::Int64;}
+template <> inline ComponentType type<float>() {return ComponentType::Float;}
+template <> inline ComponentType type<double>() {return ComponentType::Double;}
+
+/// Returns the component value at position `pos` of a value array with the
+/// given component type, converted to a double. Pattern components are one.
+double getComponentValue(const void* values, ComponentType ctype, size_t pos);
+
+/// Stores a double at position `pos` of a value array with the given
+/// component type, converted to the component type. Pattern components are
+/// not stored.
+void setComponentValue(void* values, ComponentType ctype, size_t pos,
+                       double value);
+
+}
+#endif
@@ -12,9 +12,26 @@ class Level;
 enum DimensionType {
   Dense,      // e.g. first  dimension in CSR
   Sparse,     // e.g. second dimension in CSR
-  Fixed       // e.g. second dimension in ELL
+  Fixed,      // e.g. second dimension in ELL
+  Singleton,  // e.g. second dimension in COO
+  Hashed,     // e.g. a sparse vector stored as a hash table
+  Bitmap,     // e.g. a moderately sparse vector stored as a bitmap
+  Delta       // e.g. second dimension in CSR, with varint-encoded idx deltas
 };
 
+/// The type of the values in the index arrays of a level. Narrow index widths
+/// halve the bytes read per nonzero of levels with small dimensions, and wide
+/// index widths let levels have more than 2^31 positions. Narrow widths apply
+/// to idx arrays only, since positions are not bounded by the dimension size.
+enum IndexWidth {
+  UInt16,     // e.g. the column indices of a matrix with few columns
+  Int32,
+  Int64       // e.g. the pos array of a matrix with more than 2^31 nonzeros
+};
+
+/// Returns the number of bytes of a value of the index width.
+size_t getNumBytes(IndexWidth indexWidth);
+
 class Format {
 public:
   /// Create a format for a tensor with no dimensions
@@ -25,7 +42,14 @@ public:
   Format(const DimensionType& dimensionType);
 
   /// Create a tensor format where the dimensions have the given storage types.
-  /// The dimensions are ordered from first to last.
+  /// The dimensions are ordered from first to last. A singleton level stores
+  /// one coordinate per position of the level above it, which must be a sparse
+  /// or singleton level. A sparse level above a singleton level stores the
+  /// coordinate of every entry below it, so its coordinates are not unique.
+  /// A hashed level stores each segment in a hash table, so that coordinates
+  /// are looked up rather than merged, but iterated in no particular order.
+  /// A bitmap level stores each segment as a bitmap with one bit per
+  /// coordinate, so that bitmaps are intersected a word at a time.
   Format(const std::vector<DimensionType>& dimensionTypes);
 
   /// Create a tensor format where the dimensions have the given storage types and
@@ -33,6 +57,14 @@ public:
   Format(const std::vector<DimensionType>& dimensionTypes,
          const std::vector<int>& dimensionOrder);
 
+  /// Create a tensor format where the dimensions have the given storage types,
+  /// dimension order and index widths. Dense, hashed and bitmap levels store
+  /// 32-bit sizes, tables and words, so their index width must be Int32, and
+  /// fixed levels pad empty segments with index -1, so it cannot be UInt16.
+  Format(const std::vector<DimensionType>& dimensionTypes,
+         const std::vector<int>& dimensionOrder,
+         const std::vector<IndexWidth>& indexWidths);
+
   /// Returns the number of dimensions in the format.
   size_t getOrder() const;
 
@@ -44,6 +76,9 @@ public:
   /// dimension i.
   const std::vector<int>& getDimensionOrder() const;
 
+  /// Get the index widths of the dimensions, which are Int32 unless given.
+  const std::vector<IndexWidth>& getIndexWidths() const;
+
   /// Get the tensor storage levels.
   const std::vector<Level>& getLevels() const {return levels;}
 
@@ -55,6 +90,7 @@ private:
 
   std::vector<DimensionType> dimensionTypes;
   std::vector<int> dimensionOrder;
+  std::vector<IndexWidth> indexWidths;
 };
 
 bool operator==(const Format&, const Format&);
@@ -65,12 +101,24 @@ std::ostream &operator<<(std::ostream&, const Format&);
 
 class Level {
 public:
-  Level(size_t dimension, DimensionType type) : dimension(dimension), type(type) {}
+  Level(size_t dimension, DimensionType type, IndexWidth indexWidth=Int32)
+      : dimension(dimension), type(type), indexWidth(indexWidth) {}
 
   DimensionType getType() const {
     return type;
   }
 
+  IndexWidth getIndexWidth() const {
+    return indexWidth;
+  }
+
+  /// Returns the index width of the level's pos array, or of the segment or
+  /// table size stored in its place. Pos arrays are at least 32-bit, since
+  /// the number of positions of a level is not bounded by its dimension.
+  IndexWidth getPosWidth() const {
+    return (indexWidth == UInt16) ? Int32 : indexWidth;
+  }
+
   size_t getDimension() const {
     return dimension;
   }
@@ -78,9 +126,11 @@ public:
 private:
   size_t dimension;  // The tensor dimension described by the format level
   DimensionType type;
+  IndexWidth indexWidth;
 };
 
 std::ostream& operator<<(std::ostream&, const DimensionType&);
+std::ostream& operator<<(std::ostream&, const IndexWidth&);
 std::ostream& operator<<(std::ostream&, const Level&);
 
 
@@ -90,5 +140,13 @@ extern const Format CSC;
 extern const Format DCSR;
 extern const Format DCSC;
 
+/// Coordinate list: a matrix stored as the row and column of every nonzero.
+extern const Format COO;
+
+/// Blocked CSR: a matrix stored as a 4th-order tensor whose dimensions are the
+/// block row, the block column, and the row and column within a block (see
+/// `block`). Only nonzero blocks are stored, each as a dense block.
+extern const Format BCSR;
+
 }
 #endif
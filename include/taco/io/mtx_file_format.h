@@ -4,10 +4,14 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace taco {
 class TensorBase;
 class Format;
+struct FileInfo;
+struct CoordinateRange;
+enum class Symmetry;
 namespace io {
 namespace mtx {
 
@@ -16,9 +20,40 @@ TensorBase read(std::string filename, const Format& format, bool pack = true);
 
 /// Read an mtx matrix from a stream.
 TensorBase read(std::istream& stream, const Format& format, bool pack = true);
+
+/// Read the entries of an mtx matrix file whose coordinates lie in the given
+/// ranges. The coordinates are made relative to the start of the ranges.
+TensorBase read(std::string filename, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Read the entries of an mtx matrix stream whose coordinates lie in the given
+/// ranges. The coordinates are made relative to the start of the ranges.
+TensorBase read(std::istream& stream, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
 TensorBase readSparse(std::istream& stream, const Format& format);
+
+/// Read the entries of an mtx matrix from a stream that lie in the given
+/// coordinate ranges (all entries if there are no ranges). Symmetric matrices
+/// are expanded to the full matrix and pattern matrices get implicit one
+/// values.
+TensorBase readSparse(std::istream& stream, const Format& format,
+                      Symmetry symmetry, bool pattern,
+                      const std::vector<CoordinateRange>& ranges);
+
 TensorBase readDense(std::istream& stream, const Format& format);
 
+/// Read the values of a dense mtx array from a stream that lie in the given
+/// coordinate ranges (all values if there are no ranges).
+TensorBase readDense(std::istream& stream, const Format& format,
+                     const std::vector<CoordinateRange>& ranges);
+
+/// Read the header of an mtx matrix from a file, without reading the entries.
+FileInfo probe(std::string filename);
+
+/// Read the header of an mtx matrix from a stream, without reading the entries.
+FileInfo probe(std::istream& stream);
+
 /// Write an mtx matrix to a file.
 void write(std::string filename, const TensorBase& tensor);
 
@@ -4,10 +4,13 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace taco {
 class TensorBase;
 class Format;
+struct FileInfo;
+struct CoordinateRange;
 namespace io {
 namespace rb {
 
@@ -48,6 +51,22 @@ TensorBase read(std::string filename, const Format& format, bool pack = true);
 /// Read an hb matrix from a stream
 TensorBase read(std::istream& stream, const Format& format, bool pack = true);
 
+/// Read the entries of a hb matrix file whose coordinates lie in the given
+/// ranges. The coordinates are made relative to the start of the ranges.
+TensorBase read(std::string filename, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Read the entries of a hb matrix stream whose coordinates lie in the given
+/// ranges. The coordinates are made relative to the start of the ranges.
+TensorBase read(std::istream& stream, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Read the header of an hb matrix from a file
+FileInfo probe(std::string filename);
+
+/// Read the header of an hb matrix from a stream
+FileInfo probe(std::istream& stream);
+
 /// Write an hb matrix to a file
 void write(std::string filename, const TensorBase& tensor);
 
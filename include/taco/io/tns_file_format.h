@@ -4,10 +4,13 @@
 #include <istream>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace taco {
 class TensorBase;
 class Format;
+struct FileInfo;
+struct CoordinateRange;
 namespace io {
 namespace tns {
 
@@ -17,6 +20,24 @@ TensorBase read(std::string filename, const Format& format, bool pack = true);
 /// Read a tns tensor from a stream.
 TensorBase read(std::istream& stream, const Format& format, bool pack = true);
 
+/// Read the entries of a tns tensor file whose coordinates lie in the given
+/// ranges. The coordinates are made relative to the start of the ranges.
+TensorBase read(std::string filename, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Read the entries of a tns tensor stream whose coordinates lie in the given
+/// ranges. The coordinates are made relative to the start of the ranges.
+TensorBase read(std::istream& stream, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Scan a tns tensor file for its order, largest coordinates and number of
+/// entries, without storing any of the entries.
+FileInfo probe(std::string filename);
+
+/// Scan a tns tensor stream for its order, largest coordinates and number of
+/// entries, without storing any of the entries.
+FileInfo probe(std::istream& stream);
+
 /// Write a tns tensor to a file.
 void write(std::string filename, const TensorBase& tensor);
 
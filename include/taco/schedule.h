@@ -0,0 +1,109 @@
+#ifndef TACO_SCHEDULE_H
+#define TACO_SCHEDULE_H
+
+#include <vector>
+#include <ostream>
+
+#include "taco/expr.h"
+#include "taco/component_type.h"
+
+namespace taco {
+
+/// A schedule holds the directives that control how the loops that evaluate a
+/// tensor expression are ordered, blocked and executed. Without directives the
+/// loops are ordered by the storage order of the tensors' formats.
+class Schedule {
+public:
+  /// A split of an index variable into an outer loop over blocks of `factor`
+  /// coordinates and an inner loop over the coordinates of each block. The
+  /// inner variable takes on the coordinates of the split variable.
+  struct Split {
+    Var var;
+    Var outer;
+    Var inner;
+    int factor;
+  };
+
+  /// Create a schedule with no directives
+  Schedule();
+
+  /// Order the loops of the index variables as given. The order must agree
+  /// with the order tensors with a sparse or dense level store coordinates of
+  /// the variables in.
+  void reorder(const std::vector<Var>& order);
+
+  /// Split the loop of an index variable into an outer loop over blocks of
+  /// `factor` coordinates and an inner loop over each block. Only loops over
+  /// dense dimensions can be split.
+  void split(Var var, Var outer, Var inner, int factor);
+
+  /// Run the iterations of the loop of an index variable in parallel. The
+  /// loop of a reduction variable can only run in parallel if it is the root
+  /// loop of a scalar or vector result, of which every thread then computes a
+  /// private copy.
+  void parallelize(Var var);
+
+  /// Run the loop of a root index variable in parallel by partitioning the
+  /// nonzeros of the sparse loop below it evenly, rather than its iterations.
+  /// Partitions are found with a merge-path search over the sparse level's
+  /// pos array, so rows with many nonzeros are shared between threads.
+  void parallelizeNonzeros(Var var);
+
+  /// Vectorize the loop of an index variable.
+  void vectorize(Var var);
+
+  /// Compute reductions and other temporaries in values of the given
+  /// component type rather than in the result's, e.g. to sum float values in
+  /// double precision while loading and storing floats.
+  void accumulate(ComponentType ctype);
+
+  /// Returns the loop orders given by reorder directives.
+  const std::vector<std::vector<Var>>& getOrders() const;
+
+  /// Returns the splits given by split directives.
+  const std::vector<Split>& getSplits() const;
+
+  /// Returns true iff the index variable was split.
+  bool isSplit(const Var& var) const;
+
+  /// Returns true iff the index variable is the outer variable of a split.
+  bool isOuterSplitVar(const Var& var) const;
+
+  /// Returns true iff the index variable is the inner variable of a split.
+  bool isInnerSplitVar(const Var& var) const;
+
+  /// Returns the split the index variable was created by.
+  const Split& getSplit(const Var& var) const;
+
+  /// Returns true iff the index variable's loop should run in parallel.
+  bool isParallel(const Var& var) const;
+
+  /// Returns true iff the index variable's loop should run in parallel over
+  /// evenly sized partitions of the nonzeros below it.
+  bool isParallelNonzeros(const Var& var) const;
+
+  /// Returns true iff the index variable's loop should be vectorized.
+  bool isVectorized(const Var& var) const;
+
+  /// Returns true iff an accumulate directive gives the accumulator type.
+  bool hasAccumulatorType() const;
+
+  /// Returns the component type given by the accumulate directive.
+  const ComponentType& getAccumulatorType() const;
+
+  /// Returns true iff the schedule has any parallelize directives.
+  bool hasParallelDirectives() const;
+
+  friend std::ostream& operator<<(std::ostream&, const Schedule&);
+
+private:
+  std::vector<std::vector<Var>> orders;
+  std::vector<Split>            splits;
+  std::vector<Var>              parallelVars;
+  std::vector<Var>              parallelNonzeroVars;
+  std::vector<Var>              vectorizedVars;
+  ComponentType                 accumulatorType;
+};
+
+}
+#endif
@@ -10,6 +10,7 @@
 
 namespace taco {
 class Format;
+class ComponentType;
 namespace ir {
 class Stmt;
 }
@@ -17,12 +18,14 @@ namespace storage {
 class Storage;
 
 /// Pack tensor coordinates into a format. The coordinates must be stored as a
-/// structure of arrays, that is one vector per axis coordinate and one vector
-/// for the values. The coordinates must be sorted lexicographically.
+/// structure of arrays, that is one vector per axis coordinate and one array
+/// for the values, whose type is the component type. The coordinates must be
+/// sorted lexicographically.
 Storage pack(const std::vector<int>&              dimensionSizes,
              const Format&                        format,
              const std::vector<std::vector<int>>& coordinates,
-             const std::vector<double>            values);
+             const void*                          values,
+             const ComponentType&                 ctype);
 
 /// Generate code to pack tensor coordinates into a specific format. In the
 /// generated code the coordinates must be stored as a structure of arrays,
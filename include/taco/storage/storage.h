@@ -3,6 +3,9 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
+
+#include "taco/component_type.h"
 
 namespace taco {
 class Format;
@@ -12,6 +15,8 @@ namespace storage {
 /// contains the tensor values and one index per dimension.  The type of each
 /// dimension index is determined by the dimension type in the format, and the
 /// ordere of the dimension indices is determined by the format dimension order.
+/// The index arrays of a dimension store values of its format's index width,
+/// and the value array stores values of the storage's component type.
 class Storage {
 public:
   class Size;
@@ -19,27 +24,43 @@ public:
   /// Construct an undefined tensor storage.
   Storage();
 
-  /// Construct tensor storage for the given format.
-  Storage(const Format& format);
+  /// Construct tensor storage for the given format and component type.
+  Storage(const Format& format,
+          const ComponentType& ctype=ComponentType::Double);
 
   /// Set the given index of the given dimension.
-  void setDimensionIndex(size_t dimension, std::vector<int*> index);
+  void setDimensionIndex(size_t dimension, std::vector<void*> index);
 
   /// Set the tensor component value array.
-  void setValues(double* vals);
+  void setValues(void* vals);
 
   /// Returns the tensor storage format.
   const Format& getFormat() const;
 
+  /// Returns the type of the tensor components.
+  const ComponentType& getComponentType() const;
+
   /// Returns the index of the given dimension.  The index content is determined
-  /// by the dimension type, which can be read from the format.
-  const std::vector<int*>& getDimensionIndex(size_t dimension) const;
+  /// by the dimension type, and the type of its values by the index width,
+  /// which can both be read from the format.
+  const std::vector<void*>& getDimensionIndex(size_t dimension) const;
 
-  /// Returns the value array that contains the tensor components.
-  const double* getValues() const;
+  /// Returns the value at position `pos` of one of the index arrays of the
+  /// given dimension, whatever the dimension's index width. The idx array of
+  /// a delta dimension is read a byte at a time.
+  int64_t getIndexValue(size_t dimension, size_t indexNumber, size_t pos) const;
+
+  /// Returns the value array that contains the tensor components.  The type
+  /// of its values is the component type. Pattern tensors have no value
+  /// array, so it is null.
+  const void* getValues() const;
 
   /// Returns the tensor component value array.
-  double* getValues();
+  void* getValues();
+
+  /// Returns the component value at position `pos`, whatever the component
+  /// type, converted to a double. The components of pattern tensors are one.
+  double getValue(size_t pos) const;
 
   /// Returns the size of the idx/ptr arrays of each index. The cost of this
   /// function is O(#dimensions).
@@ -72,8 +93,12 @@ public:
   private:
     size_t numVals;
     std::vector<std::vector<size_t>> numIndexVals;
+    size_t numBytesPerVal;
+    std::vector<std::vector<size_t>> numBytesPerIndexVal;
 
-    Size(size_t numVals, std::vector<std::vector<size_t>> numIndexVals);
+    Size(size_t numVals, std::vector<std::vector<size_t>> numIndexVals,
+         size_t numBytesPerVal,
+         std::vector<std::vector<size_t>> numBytesPerIndexVal);
     friend Storage::Size Storage::getSize() const;
   };
 
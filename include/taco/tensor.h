@@ -5,39 +5,17 @@
 #include <string>
 #include <vector>
 #include <cassert>
+#include <cstdint>
 
 #include "taco/expr.h"
+#include "taco/component_type.h"
 #include "taco/format.h"
+#include "taco/schedule.h"
 #include "taco/error.h"
 #include "storage/storage.h"
 
 namespace taco {
 
-/// Tensor component types. These are basic types such as double and int.
-class ComponentType {
-public:
-  enum Kind {Bool, Int, Float, Double, Unknown};
-  ComponentType() : ComponentType(Unknown) {}
-  ComponentType(Kind kind) : kind(kind)  {}
-  size_t bytes() const;
-  Kind getKind() const;
-private:
-  Kind kind;
-};
-
-bool operator==(const ComponentType& a, const ComponentType& b);
-bool operator!=(const ComponentType& a, const ComponentType& b);
-std::ostream& operator<<(std::ostream&, const ComponentType&);
-template <typename T> inline ComponentType type() {
-  assert(false && "Unsupported type");
-  return ComponentType::Double;
-}
-template <> inline ComponentType type<bool>() {return ComponentType::Bool;}
-template <> inline ComponentType type<int>() {return ComponentType::Int;}
-template <> inline ComponentType type<float>() {return ComponentType::Float;}
-template <> inline ComponentType type<double>() {return ComponentType::Double;}
-
-
 /// TensorBase is the super-class for all tensors. You can use it directly to
 /// avoid templates, or you can use the templated `Tensor<T>` that inherits from
 /// `TensorBase`.
@@ -87,11 +65,13 @@ public:
   void reserve(size_t numCoordinates);
 
   /// Insert a value into the tensor. The number of coordinates must match the
-  /// tensor dimension.
+  /// tensor dimension. The value is converted to the component type, and is
+  /// ignored by pattern tensors, whose components are all one.
   void insert(const std::initializer_list<int>& coordinate, double value);
 
   /// Insert a value into the tensor. The number of coordinates must match the
-  /// tensor dimension.
+  /// tensor dimension. The value is converted to the component type, and is
+  /// ignored by pattern tensors, whose components are all one.
   void insert(const std::vector<int>& coordinate, double value);
 
   /// Returns the storage for this tensor. Tensor values are stored according
@@ -129,6 +109,44 @@ public:
   /// Set the expression to be evaluated when calling compute or assemble.
   void setExpr(const std::vector<taco::Var>& indexVars, taco::Expr expr);
 
+  /// Order the loops of the expression's index variables as given. Must be
+  /// called after the expression is set and before it is compiled.
+  void reorder(const std::vector<taco::Var>& order);
+
+  /// Split the loop of an index variable into an outer loop over blocks of
+  /// `factor` coordinates and an inner loop over each block, e.g. to tile
+  /// dense loops when combined with `reorder`.
+  void split(taco::Var var, taco::Var outer, taco::Var inner, int factor);
+
+  /// Run the iterations of the loop of an index variable in parallel. A
+  /// reduction variable can be parallelized if its loop is the root loop of a
+  /// scalar or vector result.
+  void parallelize(taco::Var var);
+
+  /// Run the loop of a free root index variable in parallel over evenly sized
+  /// partitions of the nonzeros of the sparse loop below it (e.g. the rows of
+  /// a CSR matrix-vector product), which balances skewed rows across threads.
+  void parallelizeNonzeros(taco::Var var);
+
+  /// Vectorize the loop of an index variable.
+  void vectorize(taco::Var var);
+
+  /// Compute the expression's reductions in values of the given component
+  /// type, e.g. `double` to sum the products of float tensors in double
+  /// precision. The result is still stored in its own component type.
+  void accumulate(ComponentType ctype);
+
+  /// Fuse the expression of an operand into this tensor's expression, so that
+  /// the operand's values are computed where they are used instead of being
+  /// assembled and stored (e.g. `y(i) = T(i,j) * x(j)` with `T(i,j) = B(i,k) *
+  /// C(k,j)` becomes `y(i) = B(i,k) * C(k,j) * x(j)`). An operand whose
+  /// expression has reduction variables can only be fused if it is only
+  /// multiplied. Fuse operands of the operand first to fuse a chain.
+  void fuse(TensorBase producer);
+
+  /// Get the schedule directives of the expression.
+  const Schedule& getSchedule() const;
+
   /// Compile the tensor expression.
   void compile();
 
@@ -182,6 +200,15 @@ public:
   /// Print a tensor to a stream.
   friend std::ostream& operator<<(std::ostream&, const TensorBase&);
 
+  friend void compile(std::vector<TensorBase> tensors);
+  friend void assemble(std::vector<TensorBase> tensors);
+  friend void compute(std::vector<TensorBase> tensors);
+
+protected:
+  /// Append a coordinate to the coordinates to be packed, and return the
+  /// location its value is to be stored at.
+  void* insertCoordinate(const std::vector<int>& coordinate);
+
 private:
   struct Content;
   std::shared_ptr<Content> content;
@@ -192,8 +219,28 @@ private:
 
   void assembleInternal();
   void computeInternal();
+
+  /// Set the storage to the index assembled into `tensorData`, and allocate
+  /// the values.
+  void setAssembledStorage(void* tensorData);
 };
 
+/// Compile the expressions of several tensors into one kernel that computes
+/// them all. Loops of the expressions that iterate over the same space are
+/// fused, so that operands they share (e.g. `B` and `C` in `A = B*C` and
+/// `D = B*C + E`) are traversed once and common subexpressions are computed
+/// once. The tensors are then assembled and computed together.
+void compile(std::vector<TensorBase> tensors);
+
+/// Assemble the storage of tensors compiled together.
+void assemble(std::vector<TensorBase> tensors);
+
+/// Compute the expressions of tensors compiled together.
+void compute(std::vector<TensorBase> tensors);
+
+/// Compile, assemble and compute the expressions of several tensors together.
+void evaluate(std::vector<TensorBase> tensors);
+
 
 /// A reference to a tensor. Tensor object copies copies the reference, and
 /// subsequent method calls affect both tensor references. To deeply copy a
@@ -208,8 +255,11 @@ public:
   /// Create a scalar with the given name
   explicit Tensor(std::string name) : TensorBase(name, type<CType>()) {}
 
-  /// Create a scalar double
-  explicit Tensor(CType value) : TensorBase(value) {}
+  /// Create a scalar with the given value
+  explicit Tensor(CType value) : TensorBase(type<CType>()) {
+    this->insert({}, value);
+    this->pack();
+  }
 
   /// Create a tensor with the given dimensions and format
   Tensor(std::vector<int> dimensions, Format format=Sparse)
@@ -221,12 +271,33 @@ public:
 
   /// Create a tensor from a TensorBase instance. The Tensor and TensorBase
   /// objects will reference the same underlying tensor so it is a shallow copy.
+  /// Pattern tensors can be referenced as tensors of any component type, whose
+  /// components are all one.
   Tensor(const TensorBase& tensor) : TensorBase(tensor) {
-    taco_uassert(tensor.getComponentType() == type<CType>()) <<
+    taco_uassert(tensor.getComponentType() == type<CType>() ||
+                 tensor.getComponentType() == ComponentType::Pattern) <<
         "Assigning TensorBase with " << tensor.getComponentType() <<
         " components to a Tensor<" << type<CType>() << ">";
   }
 
+  /// Insert a value into the tensor. The number of coordinates must match the
+  /// tensor dimension. The value is stored as is, rather than converted
+  /// through a double, so 64-bit integers above 2^53 are not rounded.
+  void insert(const std::initializer_list<int>& coordinate, CType value) {
+    insert(std::vector<int>(coordinate), value);
+  }
+
+  /// Insert a value into the tensor. The number of coordinates must match the
+  /// tensor dimension. The value is stored as is, rather than converted
+  /// through a double, so 64-bit integers above 2^53 are not rounded.
+  void insert(const std::vector<int>& coordinate, CType value) {
+    if (getComponentType() != type<CType>()) {
+      TensorBase::insert(coordinate, (double)value);
+      return;
+    }
+    *(CType*)insertCoordinate(coordinate) = value;
+  }
+
   class const_iterator {
   public:
     typedef const_iterator self_type;
@@ -257,7 +328,8 @@ public:
     }
 
     bool operator==(const const_iterator& rhs) {
-      return tensor == rhs.tensor && count == rhs.count;
+      return tensor == rhs.tensor && end == rhs.end &&
+             (end || count == rhs.count);
     }
 
     bool operator!=(const const_iterator& rhs) {
@@ -271,14 +343,20 @@ public:
         tensor(tensor),
         coord(std::vector<int>(tensor->getOrder())),
         ptrs(std::vector<int>(tensor->getOrder())),
+        bytes(std::vector<int>(tensor->getOrder())),
         curVal({std::vector<int>(tensor->getOrder()), 0}),
-        count(1 + (size_t)isEnd * tensor->getStorage().getSize().numValues()),
+        count(0),
+        end(isEnd),
         advance(false) {
-      advanceIndex();
+      if (!isEnd) {
+        advanceIndex();
+      }
     }
 
+    // Iteration ends when the loops over the levels are exhausted, since
+    // padded and hashed levels store more values than they have entries
     void advanceIndex() {
-      advanceIndex(0);
+      end = !advanceIndex(0);
       ++count;
     }
 
@@ -293,7 +371,9 @@ public:
         }
 
         const size_t idx = (lvl == 0) ? 0 : ptrs[lvl - 1];
-        curVal.second = tensor->getStorage().getValues()[idx];
+        curVal.second = (tensor->getComponentType() == ComponentType::Pattern)
+            ? CType(1)
+            : ((const CType*)tensor->getStorage().getValues())[idx];
 
         for (size_t i = 0; i < lvl; ++i) {
           const size_t dim = dimOrder[i];
@@ -305,11 +385,14 @@ public:
       }
       
       const auto storage = tensor->getStorage();
-      const auto index = storage.getDimensionIndex(lvl);
+      // Index arrays store values of the level's index width
+      const auto index = [&storage, lvl](size_t n, size_t pos) {
+        return (int)storage.getIndexValue(lvl, n, pos);
+      };
 
       switch (dimTypes[lvl]) {
         case Dense: {
-          const auto dim  = index[0][0];
+          const auto dim  = index(0, 0);
           const auto base = (lvl == 0) ? 0 : (ptrs[lvl - 1] * dim);
 
           if (advance) {
@@ -327,16 +410,15 @@ public:
           break;
         }
         case Sparse: {
-          const auto& segs = index[0];
-          const auto& vals = index[1];
-          const auto  k    = (lvl == 0) ? 0 : ptrs[lvl - 1];
+          const auto k = (lvl == 0) ? 0 : ptrs[lvl - 1];
 
           if (advance) {
             goto resume_sparse;
           }
 
-          for (ptrs[lvl] = segs[k]; ptrs[lvl] < segs[k + 1]; ++ptrs[lvl]) {
-            coord[lvl] = vals[ptrs[lvl]];
+          for (ptrs[lvl] = index(0, k); ptrs[lvl] < index(0, k + 1);
+               ++ptrs[lvl]) {
+            coord[lvl] = index(1, ptrs[lvl]);
 
           resume_sparse:
             if (advanceIndex(lvl + 1)) {
@@ -346,17 +428,21 @@ public:
           break;
         }
         case Fixed: {
-          const auto  elems = index[0][0];
+          const auto  elems = index(0, 0);
           const auto  base  = (lvl == 0) ? 0 : (ptrs[lvl - 1] * elems);
-          const auto& vals  = index[1];
 
           if (advance) {
             goto resume_fixed;
           }
 
-          for (ptrs[lvl] = base; 
-               ptrs[lvl] < base + elems && vals[ptrs[lvl]] >= 0; ++ptrs[lvl]) {
-            coord[lvl] = vals[ptrs[lvl]];
+          // Segments are padded by repeating their last index, and empty
+          // segments are padded with index -1
+          for (ptrs[lvl] = base; ptrs[lvl] < base + elems &&
+               index(1, ptrs[lvl]) >= 0 &&
+               (ptrs[lvl] == base ||
+                index(1, ptrs[lvl]) != index(1, ptrs[lvl] - 1));
+               ++ptrs[lvl]) {
+            coord[lvl] = index(1, ptrs[lvl]);
 
           resume_fixed:
             if (advanceIndex(lvl + 1)) {
@@ -365,6 +451,101 @@ public:
           }
           break;
         }
+        case Hashed: {
+          const auto  slots = index(0, 0);
+          const auto  base  = (lvl == 0) ? 0 : (ptrs[lvl - 1] * slots);
+
+          if (advance) {
+            goto resume_hashed;
+          }
+
+          // Tables are iterated in slot order and empty slots store -1
+          for (ptrs[lvl] = base; ptrs[lvl] < base + slots; ++ptrs[lvl]) {
+            if (index(1, ptrs[lvl]) < 0) {
+              continue;
+            }
+            coord[lvl] = index(1, ptrs[lvl]);
+
+          resume_hashed:
+            if (advanceIndex(lvl + 1)) {
+              return true;
+            }
+          }
+          break;
+        }
+        case Bitmap: {
+          const auto  words = (index(0, 0) + 31) / 32;
+          const auto  base  = (lvl == 0) ? 0 : (ptrs[lvl - 1] * words);
+
+          if (advance) {
+            goto resume_bitmap;
+          }
+
+          // Index values are the set bits of the words, and are stored in
+          // order from the position of the first index value of each word
+          uint32_t word;
+          for (coord[lvl] = 0; coord[lvl] < words * 32; ++coord[lvl]) {
+            word = (uint32_t)index(2, base + coord[lvl] / 32);
+            if (((word >> (coord[lvl] % 32)) & 1) == 0) {
+              continue;
+            }
+            ptrs[lvl] = index(1, base + coord[lvl] / 32) +
+                __builtin_popcount(word & ((1u << (coord[lvl] % 32)) - 1));
+
+          resume_bitmap:
+            if (advanceIndex(lvl + 1)) {
+              return true;
+            }
+          }
+          break;
+        }
+        case Delta: {
+          const auto k = (lvl == 0) ? 0 : ptrs[lvl - 1];
+
+          if (advance) {
+            goto resume_delta;
+          }
+
+          // Index values are stored as the difference from the previous index
+          // value of the segment, in little-endian groups of seven bits whose
+          // high bit is set in all but the last byte
+          bytes[lvl] = index(0, 2*k + 1);
+          coord[lvl] = 0;
+          for (ptrs[lvl] = index(0, 2*k); ptrs[lvl] < index(0, 2*k + 2);
+               ++ptrs[lvl]) {
+            {
+              int shift = 0;
+              int byte;
+              do {
+                byte = index(1, bytes[lvl]++);
+                coord[lvl] += (byte & 127) << shift;
+                shift += 7;
+              } while (byte & 128);
+            }
+
+          resume_delta:
+            if (advanceIndex(lvl + 1)) {
+              return true;
+            }
+          }
+          break;
+        }
+        case Singleton: {
+          if (advance) {
+            goto resume_singleton;
+          }
+
+          // Singleton levels follow another level and store one coordinate
+          // per position of it
+          ptrs[lvl]  = ptrs[lvl - 1];
+          coord[lvl] = index(0, ptrs[lvl]);
+
+        resume_singleton:
+          if (advanceIndex(lvl + 1)) {
+            return true;
+          }
+          break;
+        }
         default:
           taco_not_supported_yet;
           break;
@@ -376,8 +557,10 @@ public:
     const Tensor<CType>*              tensor;
     std::vector<int>                  coord;
     std::vector<int>                  ptrs;
+    std::vector<int>                  bytes;
     std::pair<std::vector<int>,CType> curVal;
     size_t                            count;
+    bool                              end;
     bool                              advance;
   };
 
@@ -414,6 +597,54 @@ enum class FileType {
   rb
 };
 
+/// The symmetry of a matrix stored in a file. Symmetric, skew-symmetric and
+/// hermitian files only store the lower triangle of the matrix.
+enum class Symmetry {General, Symmetric, SkewSymmetric, Hermitian};
+
+std::ostream& operator<<(std::ostream&, const Symmetry&);
+
+/// Tensor metadata that can be read from a file without loading the tensor.
+struct FileInfo {
+  /// The dimension sizes. Formats that do not store dimensions (tns) report
+  /// the largest coordinate of each dimension.
+  std::vector<int> dimensions;
+
+  /// The number of entries stored in the file. For files that only store the
+  /// lower triangle of a symmetric matrix this is the number of stored entries.
+  size_t           nnz;
+
+  /// The component type of the stored values. Pattern files, that store
+  /// coordinates but no values, have component type `Bool`.
+  ComponentType    ctype;
+
+  /// The symmetry of the stored matrix.
+  Symmetry         symmetry;
+
+  FileInfo() : nnz(0), ctype(ComponentType::Double),
+               symmetry(Symmetry::General) {}
+};
+
+/// Read the metadata of a tensor file without reading the tensor. The file
+/// format is inferred from the filename.
+FileInfo probe(std::string filename);
+
+/// Read the metadata of a tensor file of the given file format.
+FileInfo probe(std::string filename, FileType filetype);
+
+/// Read the metadata of a tensor from a stream of the given file format.
+FileInfo probe(std::istream& stream, FileType filetype);
+
+/// A half-open range [begin, end) of coordinates along one tensor dimension.
+struct CoordinateRange {
+  CoordinateRange(int begin, int end) : begin(begin), end(end) {}
+
+  int getSize() const {return end - begin;}
+  bool contains(int coord) const {return begin <= coord && coord < end;}
+
+  int begin;
+  int end;
+};
+
 /// Read a tensor from a file. The file format is inferred from the filename
 /// and the tensor is returned packed by default.
 TensorBase read(std::string filename, Format format, bool pack = true);
@@ -428,6 +659,24 @@ TensorBase read(std::string filename, FileType filetype, Format format,
 TensorBase read(std::istream& stream, FileType filetype, Format format,
                 bool pack = true);
 
+/// Read the part of a tensor file whose coordinates lie in the given range of
+/// every dimension (e.g. one block of rows). Only the entries in the ranges are
+/// inserted into the returned tensor, whose dimensions are the sizes of the
+/// ranges and whose coordinates are relative to the start of the ranges. The
+/// file format is inferred from the filename.
+TensorBase read(std::string filename, Format format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Read the part of a tensor file of the given file format whose coordinates
+/// lie in the given range of every dimension.
+TensorBase read(std::string filename, FileType filetype, Format format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
+/// Read the part of a tensor stream of the given file format whose coordinates
+/// lie in the given range of every dimension.
+TensorBase read(std::istream& stream, FileType filetype, Format format,
+                const std::vector<CoordinateRange>& ranges, bool pack = true);
+
 /// Write a tensor to a file. The file format is inferred from the filename.
 void write(std::string filename, const TensorBase& tensor);
 
@@ -440,6 +689,20 @@ void write(std::ofstream& file, FileType filetype, const TensorBase& tensor);
 /// Pack the operands in the given expression.
 void packOperands(const TensorBase& tensor);
 
+/// Returns the largest block size, a power of two up to 16 that divides every
+/// dimension of a packed tensor, at which storing the blocks that hold
+/// nonzeros as dense blocks at most doubles the number of stored values.
+/// Returns 1 if there is no such block size.
+int getBlockSize(const TensorBase& tensor);
+
+/// Returns a packed copy of a tensor whose dimensions are split into blocks of
+/// the given size. The copy has twice the order of the tensor: its first
+/// dimensions index the blocks and its last dimensions index the components
+/// within a block, so that e.g. `y(i) = A(i,j) * x(j)` with a blocked `A` is
+/// computed as `y(ib,ii) = A(ib,jb,ii,jj) * x(jb,jj)`. The dimensions of the
+/// tensor must be multiples of the block size.
+TensorBase block(const TensorBase& tensor, int blockSize, Format format);
+
 /// Iterate over the typed values of a TensorBase.
 template <typename CType>
 Tensor<CType> iterate(const TensorBase& tensor) {
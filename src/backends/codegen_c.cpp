@@ -3,11 +3,14 @@
 #include <dlfcn.h>
 #include <algorithm>
 #include <unordered_set>
+#include <set>
 
 #include "ir/ir_visitor.h"
+#include "ir/simplify.h"
 #include "codegen_c.h"
 #include "taco/error.h"
 #include "taco/util/strings.h"
+#include "taco/util/collections.h"
 
 using namespace std;
 
@@ -19,19 +22,28 @@ namespace {
 
 // Include stdio.h for printf
 // stdlib.h for malloc/realloc
+// stdbool.h for bool values
 // math.h for sqrt
 // MIN preprocessor macro
+// taco_cmp_int comparator for qsort
 // This *must* be kept in sync with taco_tensor_t.h
 const string cHeaders = "#ifndef TACO_C_HEADERS\n"
                  "#define TACO_C_HEADERS\n"
                  "#include <stdio.h>\n"
                  "#include <stdlib.h>\n"
+                 "#include <stdbool.h>\n"
                  "#include <stdint.h>\n"
                  "#include <math.h>\n"
                  "#define TACO_MIN(_a,_b) ((_a) < (_b) ? (_a) : (_b))\n"
+                 "#define TACO_MAX(_a,_b) ((_a) > (_b) ? (_a) : (_b))\n"
+                 "static int taco_cmp_int(const void* a, const void* b) {\n"
+                 "  return *((const int*)a) - *((const int*)b);\n"
+                 "}\n"
                  "#ifndef TACO_TENSOR_T_DEFINED\n"
                  "#define TACO_TENSOR_T_DEFINED\n"
-                 "typedef enum { taco_dim_dense, taco_dim_sparse } taco_dim_t;\n"
+                 "typedef enum { taco_dim_dense, taco_dim_sparse, taco_dim_fixed,\n"
+                 "               taco_dim_singleton, taco_dim_hashed,\n"
+                 "               taco_dim_bitmap, taco_dim_delta } taco_dim_t;\n"
                  "\n"
                  "typedef struct {\n"
                  "  int32_t     order;      // tensor order (number of dimensions)\n"
@@ -100,6 +112,9 @@ protected:
     inVarAssignLHSWithDecl = false;
 
     op->contents.accept(this);
+    for (auto& array : op->reductionArrays) {
+      array.first.accept(this);
+    }
   }
 
   virtual void visit(const Var *op) {
@@ -164,9 +179,18 @@ string toCType(Type type, bool is_ptr) {
 
   switch (type.kind) {
     case Type::Int:
-      ret = "int"; //TODO: should use a specific width here
+      ret = (type.bits == 64) ? "int64_t" : "int";
       break;
     case Type::UInt:
+      if (type.bits == 1) {
+        ret = "bool";
+      }
+      else if (type.bits == 8) {
+        ret = "uint8_t";
+      }
+      else if (type.bits == 16) {
+        ret = "uint16_t";
+      }
       break;
     case Type::Float:
       if (type.bits == 32) {
@@ -197,7 +221,8 @@ string unpackTensorProperty(string varname, const GetProperty* op,
   if (op->property == TensorProperty::Values) {
     // for the values, it's in the last slot
     ret << toCType(tensor->type, true);
-    ret << " restrict " << varname << " = (double*)(";
+    ret << " restrict " << varname << " = (";
+    ret << toCType(tensor->type, true) << ")(";
     ret << tensor->name << "->vals);\n";
     return ret.str();
   }
@@ -206,23 +231,21 @@ string unpackTensorProperty(string varname, const GetProperty* op,
   taco_iassert(op->dim < levels.size())
     << "Trying to access a nonexistent dimension";
   
-  string tp;
-  
   // for a Dense level, nnz is an int
-  // for a Fixed level, ptr is an int
-  // all others are int*
+  // for a Fixed or Hashed level, ptr is an int
+  // all others are arrays of the level's index width (e.g. int*)
+  string tp = toCType(op->type, false);
   if ((levels[op->dim].getType() == DimensionType::Dense &&
       op->property == TensorProperty::Pointer)
-      ||(levels[op->dim].getType() == DimensionType::Fixed &&
+      ||((levels[op->dim].getType() == DimensionType::Fixed ||
+          levels[op->dim].getType() == DimensionType::Hashed) &&
       op->property == TensorProperty::Pointer)) {
-    tp = "int";
-    ret << tp << " " << varname << " = *(" <<
+    ret << tp << " " << varname << " = *(" << tp << "*)(" <<
       tensor->name << "->indices[" << op->dim << "][0]);\n";
   } else {
-    tp = "int*";
     auto nm = op->property == TensorProperty::Pointer ? "[0]" : "[1]";
-    ret << tp << " restrict " << varname << " = ";
-    ret << "(int*)(" << tensor->name << "->indices[" << op->dim;
+    ret << tp << "* restrict " << varname << " = ";
+    ret << "(" << tp << "*)(" << tensor->name << "->indices[" << op->dim;
     ret << "]" << nm << ");\n";
   }
   
@@ -248,11 +271,12 @@ string packTensorProperty(string varname, Expr tnsr, TensorProperty property,
   string tp;
   
   // for a Dense level, nnz is an int
-  // for a Fixed level, ptr is an int
+  // for a Fixed or Hashed level, ptr is an int
   // all others are int*
   if ((levels[dim].getType() == DimensionType::Dense &&
       property == TensorProperty::Pointer)
-      ||(levels[dim].getType() == DimensionType::Fixed &&
+      ||((levels[dim].getType() == DimensionType::Fixed ||
+          levels[dim].getType() == DimensionType::Hashed) &&
       property == TensorProperty::Pointer)) {
     tp = "int";
     ret << tensor->name << "->indices[" << dim << "][0] = " <<
@@ -480,8 +504,16 @@ void CodeGen_C::visit(const Function* func) {
   if (hasStore(func->body)) {
     // find all the vars that are not inputs or outputs and declare them
     resetUniqueNameCounters();
+
+    // Simplify the body before finding its vars, since simplification (e.g.
+    // loop-invariant hoisting) introduces vars
+    Stmt body = ir::simplify(func->body);
+    if (isa<Scope>(body)) {
+      body = to<Scope>(body)->scopedStmt;
+    }
+
     FindVars varFinder(func->inputs, func->outputs);
-    func->body.accept(&varFinder);
+    body.accept(&varFinder);
     varMap = varFinder.varMap;
 
     // Print variable declarations
@@ -490,7 +522,7 @@ void CodeGen_C::visit(const Function* func) {
 
     // output body
     out << endl;
-    print(func->body);
+    body.accept(this);
     out << endl;
 
     out << "\n";
@@ -514,38 +546,88 @@ void CodeGen_C::visit(const Var* op) {
   out << varMap[op];
 }
 
-static string genVectorizePragma(int width) {
+// Finds the scalar variables that a loop body reduces into with compound
+// assignments (t = t + ...), which vectorized and parallel loops must declare
+// as reductions
+class FindReductionVars : public IRVisitor {
+public:
+  vector<Expr> reductionVars;
+
+protected:
+  using IRVisitor::visit;
+  set<Expr, ExprCompare> declaredVars;
+
+  virtual void visit(const VarAssign *op) {
+    if (op->is_decl) {
+      declaredVars.insert(op->lhs);
+    }
+    else if (op->lhs.as<Var>() && op->rhs.as<Add>() &&
+             (op->rhs.as<Add>()->a == op->lhs ||
+              op->rhs.as<Add>()->b == op->lhs) &&
+             !util::contains(declaredVars, op->lhs) &&
+             !util::contains(reductionVars, op->lhs)) {
+      reductionVars.push_back(op->lhs);
+    }
+    IRVisitor::visit(op);
+  }
+};
+
+string CodeGen_C::genVectorizePragma(const For* op) {
+  FindReductionVars reductionFinder;
+  op->contents.accept(&reductionFinder);
+
   stringstream ret;
-  ret << "#pragma clang loop interleave(enable) ";
-  if (!width)
-    ret << "vectorize(enable)";
-  else
-    ret << "vectorize_width(" << width << ")";
-  
+  ret << "#pragma omp simd";
+  if (op->vec_width) {
+    ret << " simdlen(" << op->vec_width << ")";
+  }
+  if (reductionFinder.reductionVars.size() > 0) {
+    vector<string> names;
+    for (auto& var : reductionFinder.reductionVars) {
+      names.push_back(varMap[var]);
+    }
+    ret << " reduction(+:" << util::join(names, ",") << ")";
+  }
   return ret.str();
 }
 
-static string getParallelizePragma() {
+string CodeGen_C::genParallelizePragma(const For* op) {
+  FindReductionVars reductionFinder;
+  op->contents.accept(&reductionFinder);
+
   stringstream ret;
   ret << "#pragma omp parallel for";
+  vector<string> reductions;
+  for (auto& var : reductionFinder.reductionVars) {
+    reductions.push_back(varMap[var]);
+  }
+  // Threads add to private copies of the reduction arrays
+  for (auto& array : op->reductionArrays) {
+    reductions.push_back(varMap[array.first] + "[:" +
+                         util::toString(array.second) + "]");
+  }
+  if (reductions.size() > 0) {
+    ret << " reduction(+:" << util::join(reductions, ",") << ")";
+  }
   return ret.str();
 }
 
 // The next two need to output the correct pragmas depending
 // on the loop kind (Serial, Parallel, Vectorized)
 //
-// Docs for vectorization pragmas:
-// http://clang.llvm.org/docs/LanguageExtensions.html#extensions-for-loop-hint-optimizations
+// Vectorized loops use the OpenMP simd pragma, which gcc and clang honor
+// with -fopenmp-simd without linking the OpenMP runtime. Parallel loops use
+// the OpenMP parallel for pragma, which needs -fopenmp and the runtime.
 void CodeGen_C::visit(const For* op) {
   if (op->kind == LoopKind::Vectorized) {
     doIndent();
-    out << genVectorizePragma(op->vec_width);
+    out << genVectorizePragma(op);
     out << "\n";
   }
 
   if (op->kind == LoopKind::Parallel) {
     doIndent();
-    out << getParallelizePragma();
+    out << genParallelizePragma(op);
     out << "\n";
   }
   
@@ -553,15 +635,8 @@ void CodeGen_C::visit(const For* op) {
 }
 
 void CodeGen_C::visit(const While* op) {
-  // it's not clear from documentation that clang will vectorize
-  // while loops
-  // however, we'll output the pragmas anyway
-  if (op->kind == LoopKind::Vectorized) {
-    doIndent();
-    out << genVectorizePragma(op->vec_width);
-    out << "\n";
-  }
-  
+  // The simd pragma only applies to for loops in canonical form, so while
+  // loops are not vectorized
   IRPrinter::visit(op);
 }
 
@@ -589,6 +664,14 @@ void CodeGen_C::visit(const Min* op) {
 
 }
 
+void CodeGen_C::visit(const Max* op) {
+  stream << "TACO_MAX(";
+  op->a.accept(this);
+  stream << ",";
+  op->b.accept(this);
+  stream << ")";
+}
+
 void CodeGen_C::visit(const Allocate* op) {
   string elementType = toCType(op->var.type(), false);
 
@@ -602,6 +685,12 @@ void CodeGen_C::visit(const Allocate* op) {
     op->var.accept(this);
     stream << ", ";
   }
+  else if (op->clear) {
+    stream << "calloc(";
+    op->num_elements.accept(this);
+    stream << ", sizeof(" << elementType << "));";
+    return;
+  }
   else {
     stream << "malloc(";
   }
@@ -611,6 +700,22 @@ void CodeGen_C::visit(const Allocate* op) {
   stream << ");";
 }
 
+void CodeGen_C::visit(const Free* op) {
+  doIndent();
+  stream << "free(";
+  op->var.accept(this);
+  stream << ");";
+}
+
+void CodeGen_C::visit(const Sort* op) {
+  doIndent();
+  stream << "qsort(";
+  op->array.accept(this);
+  stream << ", ";
+  op->num_elements.accept(this);
+  stream << ", sizeof(int), taco_cmp_int);";
+}
+
 void CodeGen_C::visit(const Sqrt* op) {
   taco_tassert(op->type.isFloat() && op->type.bits == 64) <<
       "Codegen doesn't currently support non-double sqrt";
@@ -632,7 +737,7 @@ void CodeGen_C::generateShim(const Stmt* f, stringstream &ret) {
     : toCType(var->type, var->is_ptr);
     
     ret << "(" << cast_type << ")(parameterPack[" << i++ << "])";
-    if (i <= func->outputs.size() || func->inputs.size() > 0)
+    if (i < func->outputs.size() || func->inputs.size() > 0)
       ret << ", ";
   }
   for (auto input : func->inputs) {
@@ -640,7 +745,7 @@ void CodeGen_C::generateShim(const Stmt* f, stringstream &ret) {
     auto cast_type = var->is_tensor ? "taco_tensor_t*"
     : toCType(var->type, var->is_ptr);
     ret << "(" << cast_type << ")(parameterPack[" << i++ << "])";
-    if (i <= func->inputs.size()) {
+    if (i < func->outputs.size() + func->inputs.size()) {
       ret << ", ";
     }
   }
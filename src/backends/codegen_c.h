@@ -39,13 +39,20 @@ protected:
   void visit(const While*);
   void visit(const GetProperty*);
   void visit(const Min*);
+  void visit(const Max*);
   void visit(const Allocate*);
+  void visit(const Free*);
+  void visit(const Sort*);
   void visit(const Sqrt*);
 
   std::map<Expr, std::string, ExprCompare> varMap;
   std::ostream &out;
   
   OutputKind outputKind;
+
+private:
+  std::string genVectorizePragma(const For*);
+  std::string genParallelizePragma(const For*);
 };
 
 } // namespace ir
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <fstream>
+#include <map>
 #include <dlfcn.h>
 #include <unistd.h>
 
@@ -82,6 +83,32 @@ void writeShims(vector<Stmt> funcs, string path, string prefix) {
   shims_file.close();
 }
 
+/// Returns the default flags that `cc` compiles kernels with. Parallel loops
+/// need the OpenMP runtime, so kernels are compiled with -fopenmp, which also
+/// links libgomp, if `cc` can build a shared library with it. Otherwise they
+/// are compiled with -fopenmp-simd, which honors the simd pragmas of
+/// vectorized loops but ignores the pragmas of parallel loops.
+string getDefaultCFlags(string cc, string prefix) {
+  static map<string,string> defaultCFlags;
+  if (defaultCFlags.find(cc) == defaultCFlags.end()) {
+    ofstream probe_file;
+    probe_file.open(prefix + "_omp.c");
+    probe_file << "#include <omp.h>\n"
+               << "int taco_omp_threads() { return omp_get_max_threads(); }\n";
+    probe_file.close();
+
+    string cmd = cc + " -fopenmp -shared -fPIC " + prefix + "_omp.c -o " +
+                 prefix + "_omp.so > /dev/null 2>&1";
+    bool openmp = (system(cmd.data()) == 0);
+    unlink((prefix + "_omp.c").data());
+    unlink((prefix + "_omp.so").data());
+
+    string openmpFlag = openmp ? "-fopenmp" : "-fopenmp-simd";
+    defaultCFlags.insert({cc, "-O3 -ffast-math " + openmpFlag + " -std=c99"});
+  }
+  return defaultCFlags.at(cc);
+}
+
 } // anonymous namespace
 
 string Module::compile() {
@@ -89,8 +116,11 @@ string Module::compile() {
   string fullpath = prefix + ".so";
   
   string cc = util::getFromEnv("TACO_CC", "cc");
-  string cflags = util::getFromEnv("TACO_CFLAGS",
-    "-O3 -ffast-math -std=c99") + " -shared -fPIC";
+  string cflags = util::getFromEnv("TACO_CFLAGS", "");
+  if (cflags.empty()) {
+    cflags = getDefaultCFlags(cc, prefix);
+  }
+  cflags += " -shared -fPIC";
   
   string cmd = cc + " " + cflags + " " +
     prefix + ".c " +
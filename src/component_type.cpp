@@ -0,0 +1,123 @@
+#include "taco/component_type.h"
+
+#include <climits>
+
+#include "taco/error.h"
+
+using namespace std;
+
+namespace taco {
+
+// class ComponentType
+size_t ComponentType::bytes() const {
+  switch (this->kind) {
+    case Bool:
+      return sizeof(bool);
+    case Int:
+      return sizeof(int);
+    case Int64:
+      return sizeof(int64_t);
+    case Float:
+      return sizeof(float);
+    case Double:
+      return sizeof(double);
+    case Pattern:
+      return 0;
+    case Unknown:
+      break;
+  }
+  return UINT_MAX;
+}
+
+ComponentType::Kind ComponentType::getKind() const {
+  return kind;
+}
+
+bool operator==(const ComponentType& a, const ComponentType& b) {
+  return a.getKind() == b.getKind();
+}
+
+bool operator!=(const ComponentType& a, const ComponentType& b) {
+  return a.getKind() != b.getKind();
+}
+
+std::ostream& operator<<(std::ostream& os, const ComponentType& type) {
+  switch (type.getKind()) {
+    case ComponentType::Bool:
+      os << "bool";
+      break;
+    case ComponentType::Int:
+      os << "int";
+      break;
+    case ComponentType::Int64:
+      os << "int64";
+      break;
+    case ComponentType::Float:
+      os << "float";
+      break;
+    case ComponentType::Double:
+      os << "double";
+      break;
+    case ComponentType::Pattern:
+      os << "pattern";
+      break;
+    case ComponentType::Unknown:
+      break;
+  }
+  return os;
+}
+
+double getComponentValue(const void* values, ComponentType ctype, size_t pos) {
+  switch (ctype.getKind()) {
+    case ComponentType::Bool:
+      return ((const bool*)values)[pos];
+    case ComponentType::Int:
+      return ((const int*)values)[pos];
+    case ComponentType::Int64:
+      return (double)((const int64_t*)values)[pos];
+    case ComponentType::Float:
+      return ((const float*)values)[pos];
+    case ComponentType::Double:
+      return ((const double*)values)[pos];
+    case ComponentType::Pattern:
+      return 1.0;
+    case ComponentType::Unknown:
+      break;
+  }
+  taco_ierror << "Unknown component type";
+  return 0.0;
+}
+
+void setComponentValue(void* values, ComponentType ctype, size_t pos,
+                       double value) {
+  switch (ctype.getKind()) {
+    case ComponentType::Bool:
+      ((bool*)values)[pos] = (value != 0.0);
+      break;
+    case ComponentType::Int:
+      ((int*)values)[pos] = (int)value;
+      break;
+    case ComponentType::Int64:
+      // The value must be an integer in [-2^63, 2^63), so that the
+      // conversion neither overflows nor rounds
+      taco_uassert(value >= -9223372036854775808.0 &&
+                   value <   9223372036854775808.0 &&
+                   (double)(int64_t)value == value) << "The double " <<
+          value << " is not an integer in the range of Int64 components";
+      ((int64_t*)values)[pos] = (int64_t)value;
+      break;
+    case ComponentType::Float:
+      ((float*)values)[pos] = (float)value;
+      break;
+    case ComponentType::Double:
+      ((double*)values)[pos] = value;
+      break;
+    case ComponentType::Pattern:
+      break;
+    case ComponentType::Unknown:
+      taco_ierror << "Unknown component type";
+      break;
+  }
+}
+
+}
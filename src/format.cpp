@@ -1,25 +1,65 @@
 #include "taco/format.h"
 
 #include <iostream>
+#include <cstdint>
 
 #include "taco/error.h"
 #include "taco/util/strings.h"
 
 namespace taco {
 
+static void checkSingletons(const std::vector<DimensionType>& dimensionTypes) {
+  for (size_t i=0; i < dimensionTypes.size(); ++i) {
+    taco_uassert(dimensionTypes[i] != Singleton ||
+                 (i > 0 && (dimensionTypes[i-1] == Sparse ||
+                            dimensionTypes[i-1] == Singleton))) <<
+        "A singleton level must follow a sparse or singleton level";
+  }
+}
+
+static void checkIndexWidths(const std::vector<DimensionType>& dimensionTypes,
+                             const std::vector<IndexWidth>& indexWidths) {
+  for (size_t i=0; i < dimensionTypes.size(); ++i) {
+    taco_uassert(indexWidths[i] == Int32 ||
+                 (dimensionTypes[i] != Dense && dimensionTypes[i] != Hashed &&
+                  dimensionTypes[i] != Bitmap)) <<
+        "A " << dimensionTypes[i] << " level must have the int32 index width";
+    taco_uassert(indexWidths[i] != UInt16 || dimensionTypes[i] != Fixed) <<
+        "A " << dimensionTypes[i] << " level cannot have the uint16 index " <<
+        "width, since its empty segments are padded with index -1";
+  }
+}
+
+size_t getNumBytes(IndexWidth indexWidth) {
+  switch (indexWidth) {
+    case UInt16:
+      return sizeof(uint16_t);
+    case Int32:
+      return sizeof(int32_t);
+    case Int64:
+      return sizeof(int64_t);
+  }
+  taco_unreachable;
+  return 0;
+}
+
 // class Format
 Format::Format() {
 }
 
 Format::Format(const DimensionType& dimensionType) {
+  checkSingletons({dimensionType});
   levels.push_back(Level(0, dimensionType));
   this->dimensionTypes.push_back(dimensionType);
   this->dimensionOrder.push_back(0);
+  this->indexWidths.push_back(Int32);
 }
 
 Format::Format(const std::vector<DimensionType>& dimensionTypes) {
+  checkSingletons(dimensionTypes);
   this->dimensionTypes = dimensionTypes;
   this->dimensionOrder.resize(dimensionTypes.size());
+  this->indexWidths.resize(dimensionTypes.size(), Int32);
   for (size_t i=0; i < dimensionTypes.size(); ++i) {
     levels.push_back(Level(i, dimensionTypes[i]));
     this->dimensionOrder[i] = i;
@@ -27,14 +67,27 @@ Format::Format(const std::vector<DimensionType>& dimensionTypes) {
 }
 
 Format::Format(const std::vector<DimensionType>& dimensionTypes,
-               const std::vector<int>& dimensionOrder) {
+               const std::vector<int>& dimensionOrder)
+    : Format(dimensionTypes, dimensionOrder,
+             std::vector<IndexWidth>(dimensionTypes.size(), Int32)) {
+}
+
+Format::Format(const std::vector<DimensionType>& dimensionTypes,
+               const std::vector<int>& dimensionOrder,
+               const std::vector<IndexWidth>& indexWidths) {
   taco_uassert(dimensionTypes.size() == dimensionOrder.size()) <<
       "You must either provide a complete dimension ordering or none";
+  taco_uassert(dimensionTypes.size() == indexWidths.size()) <<
+      "You must provide one index width per dimension";
+  checkSingletons(dimensionTypes);
+  checkIndexWidths(dimensionTypes, indexWidths);
   this->dimensionTypes = dimensionTypes;
   this->dimensionOrder = dimensionOrder;
+  this->indexWidths = indexWidths;
 
   for (size_t i=0; i < dimensionTypes.size(); ++i) {
-    levels.push_back(Level(dimensionOrder[i], dimensionTypes[i]));
+    levels.push_back(Level(dimensionOrder[i], dimensionTypes[i],
+                           indexWidths[i]));
   }
 }
 
@@ -51,6 +104,10 @@ const std::vector<int>& Format::getDimensionOrder() const {
   return this->dimensionOrder;
 }
 
+const std::vector<IndexWidth>& Format::getIndexWidths() const {
+  return this->indexWidths;
+}
+
 bool Format::isDense() const {
   for (size_t i=0; i < dimensionTypes.size(); ++i) {
     if (dimensionTypes[i]!=Dense) {
@@ -65,9 +122,12 @@ bool operator==(const Format& a, const Format& b){
   auto bDimTypes = b.getDimensionTypes();
   auto aDimOrder = a.getDimensionOrder();
   auto bDimOrder = b.getDimensionOrder();
+  auto aIdxWidths = a.getIndexWidths();
+  auto bIdxWidths = b.getIndexWidths();
   if (aDimTypes.size() == bDimTypes.size()) {
     for (size_t i = 0; i < aDimTypes.size(); i++) {
-      if ((aDimTypes[i] != bDimTypes[i]) || (aDimOrder[i] != bDimOrder[i])) {
+      if ((aDimTypes[i] != bDimTypes[i]) || (aDimOrder[i] != bDimOrder[i]) ||
+          (aIdxWidths[i] != bIdxWidths[i])) {
         return false;
       }
     }
@@ -81,8 +141,17 @@ bool operator!=(const Format& a, const Format& b) {
 }
 
 std::ostream &operator<<(std::ostream& os, const Format& format) {
-  return os << "(" << util::join(format.getDimensionTypes(), ",") << "; "
-            << util::join(format.getDimensionOrder(), ",") << ")";
+  os << "(" << util::join(format.getDimensionTypes(), ",") << "; "
+     << util::join(format.getDimensionOrder(), ",");
+
+  // Index widths are only printed if they are not all the default
+  for (IndexWidth indexWidth : format.getIndexWidths()) {
+    if (indexWidth != Int32) {
+      os << "; " << util::join(format.getIndexWidths(), ",");
+      break;
+    }
+  }
+  return os << ")";
 }
 
 std::ostream& operator<<(std::ostream& os, const DimensionType& dimensionType) {
@@ -96,6 +165,33 @@ std::ostream& operator<<(std::ostream& os, const DimensionType& dimensionType) {
     case DimensionType::Fixed:
       os << "fixed";
       break;
+    case DimensionType::Singleton:
+      os << "singleton";
+      break;
+    case DimensionType::Hashed:
+      os << "hashed";
+      break;
+    case DimensionType::Bitmap:
+      os << "bitmap";
+      break;
+    case DimensionType::Delta:
+      os << "delta";
+      break;
+  }
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const IndexWidth& indexWidth) {
+  switch (indexWidth) {
+    case IndexWidth::UInt16:
+      os << "uint16";
+      break;
+    case IndexWidth::Int32:
+      os << "int32";
+      break;
+    case IndexWidth::Int64:
+      os << "int64";
+      break;
   }
   return os;
 }
@@ -109,5 +205,7 @@ const Format CSR({Dense, Sparse}, {0,1});
 const Format CSC({Dense, Sparse}, {1,0});
 const Format DCSR({Sparse, Sparse}, {0,1});
 const Format DCSC({Sparse, Sparse}, {1,0});
+const Format COO({Sparse, Singleton}, {0,1});
+const Format BCSR({Dense, Sparse, Dense, Dense}, {0,1,2,3});
 
 }
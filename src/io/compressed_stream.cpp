@@ -0,0 +1,203 @@
+#include "compressed_stream.h"
+
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+#ifdef TACO_ZLIB
+#include <zlib.h>
+#endif
+#ifdef TACO_ZSTD
+#include <zstd.h>
+#endif
+
+#include "taco/error.h"
+
+using namespace std;
+
+namespace taco {
+namespace io {
+
+static bool hasSuffix(const string& str, const string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size()-suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool isCompressed(std::string filename) {
+  return hasSuffix(filename, ".gz") || hasSuffix(filename, ".zst");
+}
+
+std::string getUncompressedName(std::string filename) {
+  if (!isCompressed(filename)) {
+    return filename;
+  }
+  return filename.substr(0, filename.find_last_of("."));
+}
+
+namespace {
+
+static const size_t CHUNK_SIZE = (1 << 18);
+
+/// A stream buffer that fills its get area by decompressing chunks of a file.
+class DecompressBuffer : public std::streambuf {
+public:
+  DecompressBuffer(string filename) : filename(filename),
+                                      in(CHUNK_SIZE), out(CHUNK_SIZE) {
+    file.open(filename, std::ios::binary);
+    taco_uassert(file.is_open()) << "Error opening file: " << filename;
+  }
+  virtual ~DecompressBuffer() {}
+
+protected:
+  string        filename;
+  std::ifstream file;
+  vector<char>  in;
+  vector<char>  out;
+
+  /// Decompress up to `size` bytes into `dst`. Returns the number of bytes
+  /// decompressed, which is only zero at the end of the file.
+  virtual size_t decompress(char* dst, size_t size) = 0;
+
+  /// Read the next chunk of compressed input into `in`. Returns the number of
+  /// bytes read, which is zero at the end of the file.
+  size_t readInput() {
+    file.read(in.data(), in.size());
+    return file.gcount();
+  }
+
+  int_type underflow() {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    size_t size = decompress(out.data(), out.size());
+    if (size == 0) {
+      return traits_type::eof();
+    }
+    setg(out.data(), out.data(), out.data() + size);
+    return traits_type::to_int_type(*gptr());
+  }
+};
+
+#ifdef TACO_ZLIB
+class GzipBuffer : public DecompressBuffer {
+public:
+  GzipBuffer(string filename) : DecompressBuffer(filename), inMember(false) {
+    memset(&strm, 0, sizeof(strm));
+    // 15+32 lets zlib detect and skip the gzip (or zlib) header
+    int err = inflateInit2(&strm, 15+32);
+    taco_iassert(err == Z_OK) << "Could not initialize zlib";
+  }
+
+  ~GzipBuffer() {
+    inflateEnd(&strm);
+  }
+
+protected:
+  size_t decompress(char* dst, size_t size) {
+    strm.next_out  = (Bytef*)dst;
+    strm.avail_out = size;
+    while (strm.avail_out == size) {
+      if (strm.avail_in == 0) {
+        strm.next_in  = (Bytef*)in.data();
+        strm.avail_in = readInput();
+        if (strm.avail_in == 0) {
+          taco_uassert(!inMember) << "Truncated gzip file: " << filename;
+          break;
+        }
+      }
+      inMember = true;
+      int err = inflate(&strm, Z_NO_FLUSH);
+      if (err == Z_STREAM_END) {
+        // Another gzip member may follow this one
+        inflateReset(&strm);
+        inMember = false;
+      }
+      else {
+        taco_uassert(err == Z_OK || err == Z_BUF_ERROR) <<
+            "Error decompressing gzip file: " << filename;
+      }
+    }
+    return size - strm.avail_out;
+  }
+
+private:
+  z_stream strm;
+  bool     inMember;
+};
+#endif
+
+#ifdef TACO_ZSTD
+class ZstdBuffer : public DecompressBuffer {
+public:
+  ZstdBuffer(string filename) : DecompressBuffer(filename), inFrame(false) {
+    dstream = ZSTD_createDStream();
+    taco_iassert(dstream != nullptr) << "Could not initialize zstd";
+    ZSTD_initDStream(dstream);
+    input = {in.data(), 0, 0};
+  }
+
+  ~ZstdBuffer() {
+    ZSTD_freeDStream(dstream);
+  }
+
+protected:
+  size_t decompress(char* dst, size_t size) {
+    ZSTD_outBuffer output = {dst, size, 0};
+    while (output.pos == 0) {
+      if (input.pos == input.size) {
+        input = {in.data(), readInput(), 0};
+        if (input.size == 0) {
+          taco_uassert(!inFrame) << "Truncated zstd file: " << filename;
+          break;
+        }
+      }
+      size_t ret = ZSTD_decompressStream(dstream, &output, &input);
+      taco_uassert(!ZSTD_isError(ret)) <<
+          "Error decompressing zstd file: " << filename << " (" <<
+          ZSTD_getErrorName(ret) << ")";
+      // A return value of zero means a frame was completely decoded
+      inFrame = (ret != 0);
+    }
+    return output.pos;
+  }
+
+private:
+  ZSTD_DStream*  dstream;
+  ZSTD_inBuffer  input;
+  bool           inFrame;
+};
+#endif
+
+}
+
+static std::streambuf* makeDecompressBuffer(string filename) {
+  if (hasSuffix(filename, ".gz")) {
+#ifdef TACO_ZLIB
+    return new GzipBuffer(filename);
+#else
+    taco_uerror << "Cannot read " << filename << ": taco was built without "
+                << "zlib support";
+#endif
+  }
+  else if (hasSuffix(filename, ".zst")) {
+#ifdef TACO_ZSTD
+    return new ZstdBuffer(filename);
+#else
+    taco_uerror << "Cannot read " << filename << ": taco was built without "
+                << "zstd support";
+#endif
+  }
+  taco_uerror << "Compression format not recognized: " << filename;
+  return nullptr;
+}
+
+// class DecompressStream
+DecompressStream::DecompressStream(std::string filename)
+    : std::istream(nullptr), buffer(makeDecompressBuffer(filename)) {
+  rdbuf(buffer.get());
+}
+
+DecompressStream::~DecompressStream() {
+}
+
+}}
@@ -0,0 +1,32 @@
+#ifndef TACO_IO_COMPRESSED_STREAM_H
+#define TACO_IO_COMPRESSED_STREAM_H
+
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace taco {
+namespace io {
+
+/// Returns true iff the filename ends in a compression suffix (.gz or .zst).
+bool isCompressed(std::string filename);
+
+/// Returns the filename without its compression suffix (e.g. the filename of
+/// `matrix.mtx.gz` is `matrix.mtx`).
+std::string getUncompressedName(std::string filename);
+
+/// An input stream that decompresses a gzip (.gz) or zstd (.zst) file as it is
+/// read, so that the file parsers can read compressed files without first
+/// decompressing them to disk. Concatenated gzip members (e.g. as written by
+/// pigz or bgzip) and concatenated zstd frames are read back to back.
+class DecompressStream : public std::istream {
+public:
+  DecompressStream(std::string filename);
+  ~DecompressStream();
+
+private:
+  std::unique_ptr<std::streambuf> buffer;
+};
+
+}}
+#endif
@@ -5,12 +5,15 @@
 #include <sstream>
 #include <cstdlib>
 #include <climits>
+#include <numeric>
+#include <algorithm>
 
 #include "taco/tensor.h"
 #include "taco/format.h"
 #include "taco/error.h"
 #include "taco/util/strings.h"
 #include "taco/util/timers.h"
+#include "io/ranges.h"
 
 using namespace std;
 
@@ -18,16 +21,53 @@ namespace taco {
 namespace io {
 namespace mtx {
 
+static ComponentType getComponentType(const string& field) {
+  if (field == "real") {
+    return ComponentType::Double;
+  }
+  else if (field == "integer") {
+    return ComponentType::Int;
+  }
+  else if (field == "pattern") {
+    return ComponentType::Bool;
+  }
+  return ComponentType::Unknown;
+}
+
+static Symmetry getSymmetry(const string& symmetry) {
+  if (symmetry == "symmetric") {
+    return Symmetry::Symmetric;
+  }
+  else if (symmetry == "skew-symmetric") {
+    return Symmetry::SkewSymmetric;
+  }
+  else if (symmetry == "hermitian" || symmetry == "Hermitian") {
+    return Symmetry::Hermitian;
+  }
+  taco_uassert(symmetry == "general") << "Unknown MatrixMarket symmetry";
+  return Symmetry::General;
+}
+
 TensorBase read(std::string filename, const Format& format, bool pack) {
+  return mtx::read(filename, format, {}, pack);
+}
+
+TensorBase read(std::istream& stream, const Format& format, bool pack) {
+  return mtx::read(stream, format, {}, pack);
+}
+
+TensorBase read(std::string filename, const Format& format,
+                const vector<CoordinateRange>& ranges, bool pack) {
   std::ifstream file;
   file.open(filename);
   taco_uassert(file.is_open()) << "Error opening file: " << filename;
-  TensorBase tensor = read(file, format, pack);
+  TensorBase tensor = mtx::read(file, format, ranges, pack);
   file.close();
   return tensor;
 }
 
-TensorBase read(std::istream& stream, const Format& format, bool pack) {
+TensorBase read(std::istream& stream, const Format& format,
+                const vector<CoordinateRange>& ranges, bool pack) {
   string line;
   if (!std::getline(stream, line)) {
     return TensorBase();
@@ -43,17 +83,24 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
                                        << "Unknown type of MatrixMarket";
   // formats = [coordinate array]
   // field = [real integer complex pattern]
-  taco_uassert(field=="real")          << "MatrixMarket field not available";
+  taco_uassert((field=="real") || (field=="integer") || (field=="pattern"))
+                                       << "MatrixMarket field not available";
   // symmetry = [general symmetric skew-symmetric Hermitian]
-  taco_uassert(symmetry=="general")    << "MatrixMarket symmetry not available";
+  Symmetry symm = getSymmetry(symmetry);
 
   TensorBase tensor;
-  if (formats=="coordinate")
-    tensor = readSparse(stream,format);
-  else if (formats=="array")
-    tensor = readDense(stream,format);
-  else
+  if (formats=="coordinate") {
+    tensor = readSparse(stream, format, symm, field=="pattern", ranges);
+  }
+  else if (formats=="array") {
+    taco_uassert(symm == Symmetry::General)
+        << "MatrixMarket symmetry not available for arrays";
+    taco_uassert(field != "pattern") << "MatrixMarket arrays must have values";
+    tensor = readDense(stream, format, ranges);
+  }
+  else {
     taco_uerror << "MatrixMarket format not available";
+  }
 
   if (pack) {
     tensor.pack();
@@ -63,6 +110,12 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
 }
 
 TensorBase readSparse(std::istream& stream, const Format& format) {
+  return readSparse(stream, format, Symmetry::General, false, {});
+}
+
+TensorBase readSparse(std::istream& stream, const Format& format,
+                      Symmetry symmetry, bool pattern,
+                      const vector<CoordinateRange>& ranges) {
   string line;
   std::getline(stream,line);
 
@@ -86,39 +139,105 @@ TensorBase readSparse(std::istream& stream, const Format& format) {
   size_t nnz = dimSizes[dimSizes.size()-1];
   dimSizes.pop_back();
 
-  vector<int> coordinates;
-  vector<double> values;
-  coordinates.reserve(nnz*dimSizes.size());
-  values.reserve(nnz);
+  const bool mirror = (symmetry != Symmetry::General);
+  taco_uassert(!mirror || (dimSizes.size() == 2 && dimSizes[0]==dimSizes[1]))
+      << "MatrixMarket symmetry requires a square matrix";
+  const double mirrorScale = (symmetry == Symmetry::SkewSymmetric) ? -1.0 : 1.0;
 
-  while (std::getline(stream, line)) {
+  // Create matrix. Entries are inserted as they are read; the entries mirrored
+  // across the diagonal of symmetric matrices are inserted next to the stored
+  // entries, so they are sorted and packed together with them.
+  TensorBase tensor(ComponentType::Double, getRangeDimensions(dimSizes, ranges),
+                    format);
+  if (ranges.empty()) {
+    tensor.reserve(mirror ? 2*nnz : nnz);
+  }
+
+  std::vector<int> coord(dimSizes.size());
+  std::vector<int> selected(dimSizes.size());
+  for (size_t n = 0; n < nnz && std::getline(stream, line); n++) {
     linePtr = (char*)line.data();
     for (size_t i=0; i < dimSizes.size(); i++) {
       long dimIdx = strtol(linePtr, &linePtr, 10);
-      coordinates.push_back(dimIdx);
+      coord[i] = dimIdx - 1;
+    }
+    // Pattern matrices get an implicit value of one
+    double val = pattern ? 1.0 : strtod(linePtr, &linePtr);
+    selected = coord;
+    if (selectCoordinate(selected, ranges)) {
+      tensor.insert(selected, val);
+    }
+
+    if (mirror && coord[0] != coord[1]) {
+      std::swap(coord[0], coord[1]);
+      if (selectCoordinate(coord, ranges)) {
+        tensor.insert(coord, mirrorScale * val);
+      }
     }
-    double val = strtod(linePtr, &linePtr);
-    values.push_back(val);
   }
 
-  // Create matrix
-  TensorBase tensor(ComponentType::Double, dimSizes, format);
-  tensor.reserve(nnz);
+  return tensor;
+}
+
+/// Copy the column-major values of a dense array into `dst`, laid out as the
+/// all-dense storage of `format` (the last level varies fastest).
+static void copyDenseValues(const double* src, double* dst,
+                            const vector<int>& dimSizes, const Format& format) {
+  const size_t order = dimSizes.size();
+  const vector<int>& dimOrder = format.getDimensionOrder();
 
-  // Insert coordinates
-  std::vector<int> coord;
-  for (size_t i = 0; i < nnz; i++) {
-    coord.clear();
-    for (size_t dim = 0; dim < dimSizes.size(); dim++) {
-      coord.push_back(coordinates[i*dimSizes.size() + dim] -1);
+  // Row-major matrices are a transpose of the file, which is done in blocks so
+  // that both the reads and the writes stay in cache.
+  if (order == 2 && dimOrder[0] == 0) {
+    const size_t rows = dimSizes[0];
+    const size_t cols = dimSizes[1];
+    const size_t blockSize = 64;
+    for (size_t ib = 0; ib < rows; ib += blockSize) {
+      const size_t iend = std::min(ib + blockSize, rows);
+      for (size_t jb = 0; jb < cols; jb += blockSize) {
+        const size_t jend = std::min(jb + blockSize, cols);
+        for (size_t i = ib; i < iend; i++) {
+          for (size_t j = jb; j < jend; j++) {
+            dst[i*cols + j] = src[j*rows + i];
+          }
+        }
+      }
     }
-    tensor.insert(coord, values[i]);
+    return;
   }
 
-  return tensor;
+  // Otherwise walk the storage in order, stepping through the file values with
+  // the strides of each level's dimension.
+  vector<size_t> srcStrides(order);
+  size_t stride = 1;
+  for (size_t d = 0; d < order; d++) {
+    srcStrides[d] = stride;
+    stride *= dimSizes[d];
+  }
+  const size_t size = stride;
+
+  vector<int> coord(order, 0);
+  size_t srcPos = 0;
+  for (size_t n = 0; n < size; n++) {
+    dst[n] = src[srcPos];
+    for (int level = (int)order-1; level >= 0; level--) {
+      const int dim = dimOrder[level];
+      srcPos += srcStrides[dim];
+      if (++coord[level] < dimSizes[dim]) {
+        break;
+      }
+      srcPos -= srcStrides[dim] * dimSizes[dim];
+      coord[level] = 0;
+    }
+  }
 }
 
 TensorBase readDense(std::istream& stream, const Format& format) {
+  return readDense(stream, format, {});
+}
+
+TensorBase readDense(std::istream& stream, const Format& format,
+                     const vector<CoordinateRange>& ranges) {
   string line;
   std::getline(stream,line);
 
@@ -139,38 +258,120 @@ TensorBase readDense(std::istream& stream, const Format& format) {
     taco_uassert(dimSize <= INT_MAX) << "Dimension size exceeds INT_MAX";
     dimSizes.push_back(dimSize);
   }
+  const size_t order = dimSizes.size();
+  const size_t size = std::accumulate(begin(dimSizes), end(dimSizes),
+                                      (size_t)1, std::multiplies<size_t>());
 
-  vector<double> values;
-  auto size = std::accumulate(begin(dimSizes), end(dimSizes),
-                              1, std::multiplies<double>());
-  values.reserve(size);
+  // The values are stored in column-major order
+  double* values = (double*)malloc(size * sizeof(double));
+  size_t numValues = 0;
+  while (numValues < size && std::getline(stream, line)) {
+    values[numValues++] = strtod(line.c_str(), nullptr);
+  }
+  taco_uassert(numValues == size) <<
+      "MatrixMarket array has " << numValues << " values but its dimensions " <<
+      "require " << size;
 
-  while (std::getline(stream, line)) {
-    linePtr = (char*)line.data();
-    double val = strtod(linePtr, &linePtr);
-    values.push_back(val);
-  }
-
-  // Create matrix
-  TensorBase tensor(ComponentType::Double, dimSizes, format);
-  tensor.reserve(size);
-
-  // Insert coordinates
-  std::vector<int> coord;
-  for (auto n = 0; n<size; n++) {
-    coord.clear();
-    auto indice=n;
-    for (size_t dim = 0; dim < dimSizes.size()-1; dim++) {
-      coord.push_back(indice%dimSizes[dim]);
-      indice=indice/dimSizes[dim];
+  TensorBase tensor(ComponentType::Double, getRangeDimensions(dimSizes, ranges),
+                    format);
+
+  // Dense tensors are stored as a single array of values, so they are copied
+  // straight into their storage instead of being inserted and packed
+  if (format.isDense() && ranges.empty()) {
+    // The tensor's format has one level per dimension, even if `format` is a
+    // format that can be used with any tensor
+    const Format& tensorFormat = tensor.getFormat();
+    const vector<int>& dimOrder = tensorFormat.getDimensionOrder();
+    storage::Storage storage = tensor.getStorage();
+    bool columnMajor = true;
+    for (size_t level = 0; level < order; level++) {
+      int* size = (int*)storage.getDimensionIndex(level)[0];
+      size[0] = dimSizes[dimOrder[level]];
+      columnMajor &= (dimOrder[level] == (int)(order - level - 1));
+    }
+    if (!columnMajor) {
+      double* permuted = (double*)malloc(size * sizeof(double));
+      copyDenseValues(values, permuted, dimSizes, tensorFormat);
+      free(values);
+      values = permuted;
+    }
+    storage.setValues(values);
+    return tensor;
+  }
+
+  // Insert coordinates, with the first dimension varying fastest
+  if (ranges.empty()) {
+    tensor.reserve(size);
+  }
+  std::vector<int> coord(order, 0);
+  std::vector<int> selected(order);
+  for (size_t n = 0; n < size; n++) {
+    selected = coord;
+    if (selectCoordinate(selected, ranges)) {
+      tensor.insert(selected, values[n]);
+    }
+    for (size_t dim = 0; dim < order && ++coord[dim] == dimSizes[dim]; dim++) {
+      coord[dim] = 0;
     }
-    coord.push_back(indice);
-    tensor.insert(coord, values[n]);
   }
+  free(values);
 
   return tensor;
 }
 
+FileInfo probe(std::string filename) {
+  std::ifstream file;
+  file.open(filename);
+  taco_uassert(file.is_open()) << "Error opening file: " << filename;
+  FileInfo info = probe(file);
+  file.close();
+  return info;
+}
+
+FileInfo probe(std::istream& stream) {
+  FileInfo info;
+  string line;
+  if (!std::getline(stream, line)) {
+    return info;
+  }
+
+  // Read Header
+  std::stringstream lineStream(line);
+  string head, type, formats, field, symmetry;
+  lineStream >> head >> type >> formats >> field >> symmetry;
+  taco_uassert(head=="%%MatrixMarket") << "Unknown header of MatrixMarket";
+  taco_uassert((formats=="coordinate") || (formats=="array"))
+                                       << "MatrixMarket format not available";
+  info.ctype    = getComponentType(field);
+  info.symmetry = getSymmetry(symmetry);
+
+  // Skip comments and blank lines at the top of the file
+  while (std::getline(stream, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first != string::npos && line[first] != '%') {
+      break;
+    }
+  }
+
+  // The first non-comment line is the header with dimension sizes
+  char* linePtr = (char*)line.data();
+  while (int dimSize = strtoul(linePtr, &linePtr, 10)) {
+    taco_uassert(dimSize <= INT_MAX) << "Dimension size exceeds INT_MAX";
+    info.dimensions.push_back(dimSize);
+  }
+
+  if (formats == "coordinate") {
+    taco_uassert(info.dimensions.size() > 1) << "Missing MatrixMarket sizes";
+    info.nnz = info.dimensions.back();
+    info.dimensions.pop_back();
+  }
+  else {
+    info.nnz = std::accumulate(begin(info.dimensions), end(info.dimensions),
+                               (size_t)1, std::multiplies<size_t>());
+  }
+  return info;
+}
+
 void write(std::string filename, const TensorBase& tensor) {
   std::ofstream file;
   file.open(filename);
@@ -0,0 +1,50 @@
+#ifndef TACO_IO_RANGES_H
+#define TACO_IO_RANGES_H
+
+#include <vector>
+
+#include "taco/tensor.h"
+#include "taco/error.h"
+
+namespace taco {
+namespace io {
+
+/// Returns the dimensions of the part of a tensor with the given dimensions
+/// that lies in `ranges`. An empty list of ranges selects the whole tensor.
+inline std::vector<int> getRangeDimensions(const std::vector<int>& dimensions,
+                                  const std::vector<CoordinateRange>& ranges) {
+  if (ranges.empty()) {
+    return dimensions;
+  }
+  taco_uassert(ranges.size() == dimensions.size()) <<
+      "The number of coordinate ranges (" << ranges.size() << ") must match " <<
+      "the tensor order (" << dimensions.size() << ")";
+
+  std::vector<int> rangeDimensions;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    taco_uassert(0 <= ranges[i].begin && ranges[i].begin <= ranges[i].end &&
+                 ranges[i].end <= dimensions[i]) <<
+        "Coordinate range [" << ranges[i].begin << ", " << ranges[i].end <<
+        ") is not in dimension " << i << " of size " << dimensions[i];
+    rangeDimensions.push_back(ranges[i].getSize());
+  }
+  return rangeDimensions;
+}
+
+/// Returns true iff the coordinate lies in `ranges`, in which case it is made
+/// relative to the start of the ranges.
+inline bool selectCoordinate(std::vector<int>& coordinate,
+                             const std::vector<CoordinateRange>& ranges) {
+  for (size_t i = 0; i < ranges.size(); i++) {
+    if (!ranges[i].contains(coordinate[i])) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < ranges.size(); i++) {
+    coordinate[i] -= ranges[i].begin;
+  }
+  return true;
+}
+
+}}
+#endif
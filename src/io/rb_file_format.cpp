@@ -5,10 +5,12 @@
 #include <sstream>
 #include <cstdlib>
 #include <cmath>
+#include <cctype>
 
 #include "taco/tensor.h"
 #include "taco/error.h"
 #include "taco/util/collections.h"
+#include "io/ranges.h"
 
 /*
 
@@ -35,6 +37,26 @@ void readFile(std::istream &hbfile,
              &mxtype, nrow, ncol, &nnzero, &neltvl,
              &ptrfmt, &indfmt, &valfmt, &rhsfmt);
 
+  /* First Character:
+       R Real matrix
+       C Complex matrix
+       P Pattern only (no numerical values supplied) */
+  taco_uassert((mxtype[0] == 'R')||(mxtype[0] == 'r'))
+          << "mxtype in HBfile:  case not available " << mxtype;
+  /* Second Character:
+       S Symmetric
+       U Unsymmetric
+       H Hermitian
+       Z Skew symmetric
+       R Rectangular  */
+  taco_uassert((mxtype[1] == 'U')||(mxtype[1] == 'u'))
+          << "mxtype in HBfile:  case not available " << mxtype;
+  /* Third Character:
+       A Assembled
+       E Elemental matrices (unassembled) */
+  taco_uassert((mxtype[2] == 'A')||(mxtype[2] == 'a'))
+          << "mxtype in HBfile:  case not available " << mxtype;
+
   if (*colptr)
     delete[] (*colptr);
   (*colptr) = new int[*ncol+1];
@@ -151,25 +173,6 @@ void readHeader(std::istream &hbfile,
   iss >> *mxtype >> *nrow >> *ncol >> *nnzero >> *neltvl;
   taco_uassert((*mxtype).size() == 3 )
           << "mxtype in HBfile:  case not available " << *mxtype;
-  /* First Character:
-       R Real matrix
-       C Complex matrix
-       P Pattern only (no numerical values supplied) */
-  taco_uassert(((*mxtype)[0] == 'R')||((*mxtype)[0] == 'r'))
-          << "mxtype in HBfile:  case not available " << *mxtype;
-  /* Second Character:
-       S Symmetric
-       U Unsymmetric
-       H Hermitian
-       Z Skew symmetric
-       R Rectangular  */
-  taco_uassert(((*mxtype)[1] == 'U')||((*mxtype)[1] == 'u'))
-          << "mxtype in HBfile:  case not available " << *mxtype;
-  /* Third Character:
-       A Assembled
-       E Elemental matrices (unassembled) */
-  taco_uassert(((*mxtype)[2] == 'A')||((*mxtype)[2] == 'a'))
-          << "mxtype in HBfile:  case not available " << *mxtype;
   std::getline(hbfile,line);
   /* Line 4 (2A16, 2A20)
     Col. 1 - 16     Format for pointers (PTRFMT)
@@ -267,16 +270,26 @@ void readRHS(){  }
 void writeRHS(){  }
 
 TensorBase read(std::string filename, const Format& format, bool pack) {
+  return rb::read(filename, format, {}, pack);
+}
+
+TensorBase read(std::istream& stream, const Format& format, bool pack) {
+  return rb::read(stream, format, {}, pack);
+}
+
+TensorBase read(std::string filename, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack) {
   std::ifstream file;
   file.open(filename);
   taco_uassert(file.is_open()) << "Error opening file: " << filename;
-  TensorBase tensor = read(file, format, pack);
+  TensorBase tensor = rb::read(file, format, ranges, pack);
   file.close();
 
   return tensor;
 }
 
-TensorBase read(std::istream& stream, const Format& format, bool pack) {
+TensorBase read(std::istream& stream, const Format& format,
+                const std::vector<CoordinateRange>& ranges, bool pack) {
   int rows, cols;
   int *colptr = NULL;
   int *rowind = NULL;
@@ -285,10 +298,33 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
   rb::readFile(stream, &rows, &cols, &colptr, &rowind, &values);
 
   taco_uassert(format == CSC) << "RB files must be loaded into a CSC matrix";
-  TensorBase tensor(ComponentType::Double, {(int)rows,(int)cols}, CSC);
+  std::vector<int> dimensions = getRangeDimensions({rows, cols}, ranges);
+  TensorBase tensor(ComponentType::Double, dimensions, CSC);
+
+  // Keep the columns in the column range and the rows in the row range of
+  // each of them, renumbered from the start of the ranges
+  if (!ranges.empty()) {
+    const CoordinateRange& rowRange = ranges[0];
+    const CoordinateRange& colRange = ranges[1];
+    int* rangeColptr = new int[colRange.getSize()+1];
+    rangeColptr[0] = 0;
+    int nnz = 0;
+    for (int j = colRange.begin; j < colRange.end; j++) {
+      for (int pos = colptr[j]; pos < colptr[j+1]; pos++) {
+        if (rowRange.contains(rowind[pos])) {
+          rowind[nnz] = rowind[pos] - rowRange.begin;
+          values[nnz] = values[pos];
+          nnz++;
+        }
+      }
+      rangeColptr[j - colRange.begin + 1] = nnz;
+    }
+    delete[] colptr;
+    colptr = rangeColptr;
+  }
 
   auto storage = tensor.getStorage();
-  std::vector<int> denseDim = {cols};
+  std::vector<int> denseDim = {dimensions[1]};
   storage.setDimensionIndex(0, {util::copyToArray(denseDim)});
   storage.setDimensionIndex(1, {colptr, rowind});
   storage.setValues(values);
@@ -300,6 +336,60 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
   return tensor;
 }
 
+FileInfo probe(std::string filename) {
+  std::ifstream file;
+  file.open(filename);
+  taco_uassert(file.is_open()) << "Error opening file: " << filename;
+  FileInfo info = probe(file);
+  file.close();
+
+  return info;
+}
+
+FileInfo probe(std::istream& stream) {
+  std::string title, key;
+  int totcrd,ptrcrd,indcrd,valcrd,rhscrd;
+  std::string mxtype;
+  int nrow, ncol, nnzero, neltvl;
+  std::string ptrfmt, indfmt, valfmt, rhsfmt;
+
+  readHeader(stream,
+             &title, &key,
+             &totcrd, &ptrcrd, &indcrd, &valcrd, &rhscrd,
+             &mxtype, &nrow, &ncol, &nnzero, &neltvl,
+             &ptrfmt, &indfmt, &valfmt, &rhsfmt);
+
+  FileInfo info;
+  info.dimensions = {nrow, ncol};
+  info.nnz = nnzero;
+  switch (toupper(mxtype[0])) {
+    case 'R':
+      info.ctype = ComponentType::Double;
+      break;
+    case 'P':
+      info.ctype = ComponentType::Bool;
+      break;
+    default:
+      info.ctype = ComponentType::Unknown;
+      break;
+  }
+  switch (toupper(mxtype[1])) {
+    case 'S':
+      info.symmetry = Symmetry::Symmetric;
+      break;
+    case 'Z':
+      info.symmetry = Symmetry::SkewSymmetric;
+      break;
+    case 'H':
+      info.symmetry = Symmetry::Hermitian;
+      break;
+    default:
+      info.symmetry = Symmetry::General;
+      break;
+  }
+  return info;
+}
+
 void write(std::string filename, const TensorBase& tensor) {
   taco_iassert(tensor.getOrder() == 2) <<
       "The .rb format only supports matrices. Consider using the .tns format "
@@ -320,9 +410,9 @@ void write(std::ostream& stream, const TensorBase& tensor) {
     auto S = tensor.getStorage();
     auto size = S.getSize();
 
-    double *values = S.getValues();
-    int *colptr = S.getDimensionIndex(1)[0];
-    int *rowind = S.getDimensionIndex(1)[1];
+    double *values = (double*)S.getValues();
+    int *colptr = (int*)S.getDimensionIndex(1)[0];
+    int *rowind = (int*)S.getDimensionIndex(1)[1];
     int nrow = tensor.getDimensions()[0];
     int ncol = tensor.getDimensions()[1];
     int nnzero = size.numValues();
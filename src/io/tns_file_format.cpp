@@ -12,6 +12,7 @@
 #include "taco/format.h"
 #include "taco/error.h"
 #include "taco/util/strings.h"
+#include "io/ranges.h"
 
 using namespace std;
 
@@ -20,15 +21,25 @@ namespace io {
 namespace tns {
 
 TensorBase read(std::string filename, const Format& format, bool pack) {
+  return tns::read(filename, format, {}, pack);
+}
+
+TensorBase read(std::istream& stream, const Format& format, bool pack) {
+  return tns::read(stream, format, {}, pack);
+}
+
+TensorBase read(std::string filename, const Format& format,
+                const vector<CoordinateRange>& ranges, bool pack) {
   std::ifstream file;
   file.open(filename);
   taco_uassert(file.is_open()) << "Error opening file: " << filename;
-  TensorBase tensor = read(file, format, pack);
+  TensorBase tensor = tns::read(file, format, ranges, pack);
   file.close();
   return tensor;
 }
 
-TensorBase read(std::istream& stream, const Format& format, bool pack) {
+TensorBase read(std::istream& stream, const Format& format,
+                const vector<CoordinateRange>& ranges, bool pack) {
   std::vector<int>    coordinates;
   std::vector<double> values;
 
@@ -42,8 +53,11 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
   size_t order = toks.size()-1;
   std::vector<int> dimensions(order);
   std::vector<int> coordinate(order);
+  taco_uassert(ranges.empty() || ranges.size() == order) <<
+      "The number of coordinate ranges (" << ranges.size() << ") must match " <<
+      "the tensor order (" << order << ")";
 
-  // Load data
+  // Load data. Only the entries in the coordinate ranges are kept.
   do {
     char* linePtr = (char*)line.data();
     for (size_t i = 0; i < order; i++) {
@@ -52,12 +66,22 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
       coordinate[i] = (int)idx - 1;
       dimensions[i] = std::max(dimensions[i], (int)idx);
     }
+    if (!selectCoordinate(coordinate, ranges)) {
+      continue;
+    }
     coordinates.insert(coordinates.end(), coordinate.begin(), coordinate.end());
     double val = strtod(linePtr, &linePtr);
     values.push_back(val);
 
   } while (std::getline(stream, line));
 
+  // The dimensions of tns files are only known to be at least as large as the
+  // largest coordinates, so the ranges may extend past them
+  for (size_t i = 0; i < ranges.size() && i < order; i++) {
+    dimensions[i] = std::max(dimensions[i], ranges[i].end);
+  }
+  dimensions = getRangeDimensions(dimensions, ranges);
+
   // Create tensor
   const size_t nnz = values.size();
   TensorBase tensor(ComponentType::Double, dimensions, format);
@@ -78,6 +102,45 @@ TensorBase read(std::istream& stream, const Format& format, bool pack) {
   return tensor;
 }
 
+FileInfo probe(std::string filename) {
+  std::ifstream file;
+  file.open(filename);
+  taco_uassert(file.is_open()) << "Error opening file: " << filename;
+  FileInfo info = probe(file);
+  file.close();
+  return info;
+}
+
+FileInfo probe(std::istream& stream) {
+  FileInfo info;
+  size_t order = 0;
+
+  // Scan the entries, keeping only the largest coordinate of each dimension
+  std::string line;
+  while (std::getline(stream, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+
+    // Infer tensor order from the first coordinate
+    if (info.nnz == 0) {
+      order = util::split(line.substr(first), " ").size()-1;
+      info.dimensions.resize(order);
+    }
+
+    char* linePtr = (char*)line.data();
+    for (size_t i = 0; i < order; i++) {
+      long idx = strtol(linePtr, &linePtr, 10);
+      taco_uassert(idx <= INT_MAX)<<"Coordinate in file is larger than INT_MAX";
+      info.dimensions[i] = std::max(info.dimensions[i], (int)idx);
+    }
+    info.nnz++;
+  }
+
+  return info;
+}
+
 void write(std::string filename, const TensorBase& tensor) {
   std::ofstream file;
   file.open(filename);
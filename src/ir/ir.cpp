@@ -8,6 +8,39 @@ namespace taco {
 namespace ir {
 
 // class Type
+Type getIndexType(IndexWidth indexWidth) {
+  switch (indexWidth) {
+    case IndexWidth::UInt16:
+      return Type(Type::UInt, 16);
+    case IndexWidth::Int32:
+      return Type(Type::Int);
+    case IndexWidth::Int64:
+      return Type(Type::Int, 64);
+  }
+  taco_unreachable;
+  return Type(Type::Int);
+}
+
+Type getValueType(ComponentType ctype) {
+  switch (ctype.getKind()) {
+    case ComponentType::Bool:
+    case ComponentType::Pattern:
+      return Type(Type::UInt, 1);
+    case ComponentType::Int:
+      return Type(Type::Int);
+    case ComponentType::Int64:
+      return Type(Type::Int, 64);
+    case ComponentType::Float:
+      return Type(Type::Float, 32);
+    case ComponentType::Double:
+      return Type(Type::Float, 64);
+    case ComponentType::Unknown:
+      break;
+  }
+  taco_unreachable;
+  return Type(Type::Float, 64);
+}
+
 bool operator==(const Type& a, const Type& b) {
   return a.kind == b.kind && a.bits == b.bits;
 }
@@ -18,12 +51,23 @@ std::ostream& operator<<(std::ostream& os, const Type& type) {
       if (type.bits == 1) {
         os << "bool";
       }
+      else if (type.bits == 8) {
+        os << "uint8_t";
+      }
+      else if (type.bits == 16) {
+        os << "uint16_t";
+      }
       else {
         os << "unsigned int";
       }
       break;
     case Type::Int:
-      os << "int";
+      if (type.bits == 64) {
+        os << "int64_t";
+      }
+      else {
+        os << "int";
+      }
       break;
     case Type::Float:
       if (type.bits == 32) {
@@ -94,11 +138,14 @@ Expr Sqrt::make(Expr a) {
 // helper
 Type max_type(Expr a, Expr b);
 Type max_type(Expr a, Expr b) {
-  taco_iassert(!a.type().isBool() && !b.type().isBool()) <<
-      "Can't do arithmetic on booleans.";
-
-  if (a.type() == b.type()) {
+  if (a.type() == b.type() && !a.type().isBool()) {
     return a.type();
+  } else if (!a.type().isFloat() && !b.type().isFloat()) {
+    // Integer arithmetic is done in int, or in int64_t if either is 64-bit.
+    // Booleans are promoted to int as in C, so that storing the sum (product)
+    // of booleans into a boolean computes their logical or (and).
+    return (a.type().bits == 64 || b.type().bits == 64) ? Type(Type::Int, 64)
+                                                        : Type(Type::Int);
   } else {
     if ((a.type().kind == Type::Float && a.type().bits == 64) ||
         (b.type().kind == Type::Float && b.type().bits == 64)) {
@@ -127,9 +174,6 @@ Expr Sub::make(Expr a, Expr b) {
 }
 
 Expr Sub::make(Expr a, Expr b, Type type) {
-  taco_iassert(!a.type().isBool() && !b.type().isBool()) <<
-      "Can't do arithmetic on booleans.";
-
   Sub *sub = new Sub;
   sub->type = type;
   sub->a = a;
@@ -142,9 +186,6 @@ Expr Mul::make(Expr a, Expr b) {
 }
 
 Expr Mul::make(Expr a, Expr b, Type type) {
-  taco_iassert(!a.type().isBool() && !b.type().isBool()) <<
-      "Can't do arithmetic on booleans.";
-
   Mul *mul = new Mul;
   mul->type = type;
   mul->a = a;
@@ -225,6 +266,29 @@ Expr BitAnd::make(Expr a, Expr b) {
   return bitAnd;
 }
 
+Expr BitOr::make(Expr a, Expr b) {
+  BitOr *bitOr = new BitOr;
+  bitOr->type = Type(Type::UInt);
+  bitOr->a = a;
+  bitOr->b = b;
+  return bitOr;
+}
+
+Expr Shr::make(Expr a, Expr b) {
+  Shr *shr = new Shr;
+  shr->type = a.type();
+  shr->a = a;
+  shr->b = b;
+  return shr;
+}
+
+Expr Popcount::make(Expr a) {
+  Popcount *popcount = new Popcount;
+  popcount->type = Type(Type::Int);
+  popcount->a = a;
+  return popcount;
+}
+
 // Boolean binary ops
 Expr Eq::make(Expr a, Expr b) {
   Eq *eq = new Eq;
@@ -368,7 +432,8 @@ Stmt Case::make(std::vector<std::pair<Expr,Stmt>> clauses, bool alwaysMatch) {
 
 // For loop
 Stmt For::make(Expr var, Expr start, Expr end, Expr increment, Stmt contents,
-  LoopKind kind, int vec_width) {
+  LoopKind kind, int vec_width,
+  std::vector<std::pair<Expr,Expr>> reductionArrays) {
   For *loop = new For;
   loop->var = var;
   loop->start = start;
@@ -377,6 +442,7 @@ Stmt For::make(Expr var, Expr start, Expr end, Expr increment, Stmt contents,
   loop->contents = Scope::make(contents);
   loop->kind = kind;
   loop->vec_width = vec_width;
+  loop->reductionArrays = reductionArrays;
   return loop;
 }
 
@@ -414,7 +480,8 @@ Stmt VarAssign::make(Expr lhs, Expr rhs, bool is_decl) {
 }
 
 // Allocate
-Stmt Allocate::make(Expr var, Expr num_elements, bool is_realloc) {
+Stmt Allocate::make(Expr var, Expr num_elements, bool is_realloc,
+                    bool clear) {
   taco_iassert(var.as<GetProperty>() ||
                (var.as<Var>() && var.as<Var>()->is_ptr)) <<
       "Can only allocate memory for a pointer-typed Var";
@@ -424,9 +491,33 @@ Stmt Allocate::make(Expr var, Expr num_elements, bool is_realloc) {
   alloc->var = var;
   alloc->num_elements = num_elements;
   alloc->is_realloc = is_realloc;
+  alloc->clear = clear;
+  taco_iassert(!(is_realloc && clear)) << "Cannot clear reallocated memory";
   return alloc;
 }
 
+// Free
+Stmt Free::make(Expr var) {
+  taco_iassert(var.as<GetProperty>() ||
+               (var.as<Var>() && var.as<Var>()->is_ptr)) <<
+      "Can only free memory of a pointer-typed Var";
+  Free* free = new Free;
+  free->var = var;
+  return free;
+}
+
+// Sort
+Stmt Sort::make(Expr array, Expr num_elements) {
+  taco_iassert(array.as<Var>() && array.as<Var>()->is_ptr &&
+               array.type().isInt()) << "Can only sort an integer array";
+  taco_iassert(num_elements.type().isInt()) <<
+      "Can only sort an integer-valued number of elements";
+  Sort* sort = new Sort;
+  sort->array = array;
+  sort->num_elements = num_elements;
+  return sort;
+}
+
 // Comment
 Stmt Comment::make(std::string text) {
   Comment* comment = new Comment;
@@ -459,6 +550,18 @@ Expr GetProperty::make(Expr tensor, TensorProperty property, size_t dim) {
     gp->type = tensor.type();
   else
     gp->type = Type::Int;
+
+  // Idx arrays store values of their level's index width, except for those of
+  // delta levels, which store bytes, and pos arrays of its pos width
+  const Var* var = tensor.as<Var>();
+  if (property != TensorProperty::Values && var != nullptr &&
+      dim < var->format.getLevels().size()) {
+    const Level& level = var->format.getLevels()[dim];
+    gp->type = (property == TensorProperty::Pointer)
+               ? getIndexType(level.getPosWidth())
+               : (level.getType() == DimensionType::Delta)
+               ? Type(Type::UInt, 8) : getIndexType(level.getIndexWidth());
+  }
   
   return gp;
 }
@@ -488,6 +591,12 @@ template<> void ExprNode<Max>::accept(IRVisitorStrict *v)
     const { v->visit((const Max*)this); }
 template<> void ExprNode<BitAnd>::accept(IRVisitorStrict *v)
     const { v->visit((const BitAnd*)this); }
+template<> void ExprNode<BitOr>::accept(IRVisitorStrict *v)
+    const { v->visit((const BitOr*)this); }
+template<> void ExprNode<Shr>::accept(IRVisitorStrict *v)
+    const { v->visit((const Shr*)this); }
+template<> void ExprNode<Popcount>::accept(IRVisitorStrict *v)
+    const { v->visit((const Popcount*)this); }
 template<> void ExprNode<Eq>::accept(IRVisitorStrict *v)
     const { v->visit((const Eq*)this); }
 template<> void ExprNode<Neq>::accept(IRVisitorStrict *v)
@@ -526,6 +635,10 @@ template<> void StmtNode<VarAssign>::accept(IRVisitorStrict *v)
     const { v->visit((const VarAssign*)this); }
 template<> void StmtNode<Allocate>::accept(IRVisitorStrict *v)
     const { v->visit((const Allocate*)this); }
+template<> void StmtNode<Free>::accept(IRVisitorStrict *v)
+    const { v->visit((const Free*)this); }
+template<> void StmtNode<Sort>::accept(IRVisitorStrict *v)
+    const { v->visit((const Sort*)this); }
 template<> void StmtNode<Comment>::accept(IRVisitorStrict *v)
     const { v->visit((const Comment*)this); }
 template<> void StmtNode<BlankLine>::accept(IRVisitorStrict *v)
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "taco/format.h"
+#include "taco/component_type.h"
 
 #include "taco/error.h"
 #include "taco/util/intrusive_ptr.h"
@@ -27,6 +28,9 @@ enum class IRNodeType {
   Min,
   Max,
   BitAnd,
+  BitOr,
+  Shr,
+  Popcount,
   Not,
   Eq,
   Neq,
@@ -47,6 +51,8 @@ enum class IRNodeType {
   Function,
   VarAssign,
   Allocate,
+  Free,
+  Sort,
   Comment,
   BlankLine,
   Print,
@@ -77,6 +83,13 @@ public:
 bool operator==(const Type&, const Type&);
 std::ostream& operator<<(std::ostream&, const Type&);
 
+/// Returns the type of the values of index arrays of the given index width.
+Type getIndexType(IndexWidth indexWidth);
+
+/// Returns the type of the values of tensors with the given component type.
+/// The values of pattern tensors are booleans that are always true.
+Type getValueType(ComponentType ctype);
+
 /** Base class for backend IR */
 struct IRNode : private util::Uncopyable {
   IRNode() {}
@@ -327,6 +340,38 @@ public:
   static const IRNodeType _type_info = IRNodeType::BitAnd;
 };
 
+/** Bitwise or: a | b */
+struct BitOr : public ExprNode<BitOr> {
+public:
+  Expr a;
+  Expr b;
+
+  static Expr make(Expr a, Expr b);
+
+  static const IRNodeType _type_info = IRNodeType::BitOr;
+};
+
+/** Logical shift right: a >> b */
+struct Shr : public ExprNode<Shr> {
+public:
+  Expr a;
+  Expr b;
+
+  static Expr make(Expr a, Expr b);
+
+  static const IRNodeType _type_info = IRNodeType::Shr;
+};
+
+/** The number of set bits of an unsigned 32-bit integer */
+struct Popcount : public ExprNode<Popcount> {
+public:
+  Expr a;
+
+  static Expr make(Expr a);
+
+  static const IRNodeType _type_info = IRNodeType::Popcount;
+};
+
 /** Equality: a==b. */
 struct Eq : public ExprNode<Eq> {
 public:
@@ -494,6 +539,10 @@ enum class LoopKind {Serial, Parallel, Vectorized};
  * If the loop is vectorized, the width says which vector width
  * to use.  By default (0), it will not set a specific width and
  * let clang determine the width to use.
+ *
+ * If the loop is parallel, the iterations may add to the given
+ * arrays (paired with their sizes), which each thread then adds
+ * to a private copy of that is summed up after the loop.
  */
 struct For : public StmtNode<For> {
 public:
@@ -504,10 +553,12 @@ public:
   Stmt contents;
   LoopKind kind;
   int vec_width;  // vectorization width
+  std::vector<std::pair<Expr,Expr>> reductionArrays;
   
   static Stmt make(Expr var, Expr start, Expr end, Expr increment,
                    Stmt contents, LoopKind kind=LoopKind::Serial,
-                   int vec_width=0);
+                   int vec_width=0,
+                   std::vector<std::pair<Expr,Expr>> reductionArrays={});
   
   static const IRNodeType _type_info = IRNodeType::For;
 };
@@ -553,18 +604,42 @@ public:
   static const IRNodeType _type_info = IRNodeType::VarAssign;
 };
 
-/** An Allocate node that allocates some memory for a Var */
+/** An Allocate node that allocates some memory for a Var. If clear is set
+ * the memory is zero-initialized. */
 struct Allocate : public StmtNode<Allocate> {
 public:
   Expr var;   // must be a Var
   Expr num_elements;
   bool is_realloc;
+  bool clear;
   
-  static Stmt make(Expr var, Expr num_elements, bool is_realloc=false);
+  static Stmt make(Expr var, Expr num_elements, bool is_realloc=false,
+                   bool clear=false);
   
   static const IRNodeType _type_info = IRNodeType::Allocate;
 };
 
+/** A Free node that releases the memory allocated for a Var */
+struct Free : public StmtNode<Free> {
+public:
+  Expr var;   // must be a Var
+  
+  static Stmt make(Expr var);
+  
+  static const IRNodeType _type_info = IRNodeType::Free;
+};
+
+/** A Sort node that sorts the first num_elements of an integer array */
+struct Sort : public StmtNode<Sort> {
+public:
+  Expr array;
+  Expr num_elements;
+  
+  static Stmt make(Expr array, Expr num_elements);
+  
+  static const IRNodeType _type_info = IRNodeType::Sort;
+};
+
 /** A comment */
 struct Comment : public StmtNode<Comment> {
 public:
@@ -23,4 +23,13 @@ Expr conjunction(std::vector<Expr> exprs) {
   return conjunction;
 }
 
+Expr disjunction(std::vector<Expr> exprs) {
+  taco_iassert(exprs.size() > 0) << "No expressions to or";
+  Expr disjunction = exprs[0];
+  for (size_t i = 1; i < exprs.size(); i++) {
+    disjunction = ir::Or::make(disjunction, exprs[i]);
+  }
+  return disjunction;
+}
+
 }}
@@ -18,5 +18,8 @@ Stmt compoundAssign(Expr var, Expr val);
 /// Returns a conjunction (and) of `exprs`
 Expr conjunction(std::vector<Expr> exprs);
 
+/// Returns a disjunction (or) of `exprs`
+Expr disjunction(std::vector<Expr> exprs);
+
 }}
 #endif
@@ -138,6 +138,21 @@ void IRPrinter::visit(const BitAnd* op){
   printBinOp(op->a, op->b, "&");
 }
 
+void IRPrinter::visit(const BitOr* op){
+  printBinOp(op->a, op->b, "|");
+}
+
+void IRPrinter::visit(const Shr* op){
+  printBinOp(op->a, op->b, ">>");
+}
+
+void IRPrinter::visit(const Popcount* op){
+  omitNextParen = false;
+  stream << "__builtin_popcount(";
+  op->a.accept(this);
+  stream << ")";
+}
+
 void IRPrinter::visit(const Eq* op){
   printBinOp(op->a, op->b, "==");
 }
@@ -180,10 +195,11 @@ void IRPrinter::visit(const IfThenElse* op) {
 
   Stmt scopedStmt = Stmt(to<Scope>(op->then)->scopedStmt);
   if (isa<Block>(scopedStmt)) {
-    stream << " {" << endl;
+    stream << " {\n";
     op->then.accept(this);
+    stream << "\n";
     doIndent();
-    stream << "}" << endl;
+    stream << "}";
   }
   else if (isa<VarAssign>(scopedStmt)) {
     int tmp = indent;
@@ -193,19 +209,15 @@ void IRPrinter::visit(const IfThenElse* op) {
     indent = tmp;
   }
   else {
-    stream << endl;
+    stream << "\n";
     op->then.accept(this);
   }
 
   if (op->otherwise.defined()) {
     stream << "\n";
     doIndent();
-    stream << "else {\n";
-
-    doIndent();
-    stream << "\n";
+    stream << keywordString("else") << " {\n";
     op->otherwise.accept(this);
-    doIndent();
     stream << "\n";
     doIndent();
     stream << "}";
@@ -257,7 +269,8 @@ void IRPrinter::visit(const Store* op) {
 
 void IRPrinter::visit(const For* op) {
   doIndent();
-  stream << keywordString("for") << " (int ";
+  stream << keywordString("for") << " (";
+  stream << keywordString(util::toString(op->var.type())) << " ";
   op->var.accept(this);
   stream << " = ";
   op->start.accept(this);
@@ -296,8 +309,31 @@ void IRPrinter::visit(const While* op) {
   stream << "}";
 }
 
+/// Returns true iff the statement prints nothing, such as an empty block.
+static bool isEmpty(const Stmt& stmt) {
+  if (!stmt.defined()) {
+    return true;
+  }
+  if (isa<Block>(stmt)) {
+    for (auto& content : to<Block>(stmt)->contents) {
+      if (!isEmpty(content)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
 void IRPrinter::visit(const Block* op) {
-  acceptJoin(this, stream, op->contents, "\n");
+  // Statements that print nothing would leave blank lines
+  vector<Stmt> contents;
+  for (auto& content : op->contents) {
+    if (!isEmpty(content)) {
+      contents.push_back(content);
+    }
+  }
+  acceptJoin(this, stream, contents, "\n");
 }
 
 void IRPrinter::visit(const Scope* op) {
@@ -356,6 +392,8 @@ void IRPrinter::visit(const Allocate* op) {
   doIndent();
   if (op->is_realloc)
     stream << "reallocate ";
+  else if (op->clear)
+    stream << "allocate zeroed ";
   else
     stream << "allocate ";
   op->var.accept(this);
@@ -364,6 +402,21 @@ void IRPrinter::visit(const Allocate* op) {
   stream << "]";
 }
 
+void IRPrinter::visit(const Free* op) {
+  doIndent();
+  stream << "free ";
+  op->var.accept(this);
+}
+
+void IRPrinter::visit(const Sort* op) {
+  doIndent();
+  stream << "sort ";
+  op->array.accept(this);
+  stream << "[ ";
+  op->num_elements.accept(this);
+  stream << "]";
+}
+
 void IRPrinter::visit(const Comment* op) {
   doIndent();
   stream << commentString(op->text);
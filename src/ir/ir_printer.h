@@ -28,6 +28,9 @@ protected:
   virtual void visit(const Min*);
   virtual void visit(const Max*);
   virtual void visit(const BitAnd*);
+  virtual void visit(const BitOr*);
+  virtual void visit(const Shr*);
+  virtual void visit(const Popcount*);
   virtual void visit(const Eq*);
   virtual void visit(const Neq*);
   virtual void visit(const Gt*);
@@ -47,6 +50,8 @@ protected:
   virtual void visit(const Function*);
   virtual void visit(const VarAssign*);
   virtual void visit(const Allocate*);
+  virtual void visit(const Free*);
+  virtual void visit(const Sort*);
   virtual void visit(const Comment*);
   virtual void visit(const BlankLine*);
   virtual void visit(const Print*);
@@ -124,6 +124,18 @@ void IRRewriter::visit(const BitAnd* op) {
   expr = visitBinaryOp(op, this);
 }
 
+void IRRewriter::visit(const BitOr* op) {
+  expr = visitBinaryOp(op, this);
+}
+
+void IRRewriter::visit(const Shr* op) {
+  expr = visitBinaryOp(op, this);
+}
+
+void IRRewriter::visit(const Popcount* op) {
+  expr = visitUnaryOp(op, this);
+}
+
 void IRRewriter::visit(const Eq* op) {
   expr = visitBinaryOp(op, this);
 }
@@ -223,7 +235,7 @@ void IRRewriter::visit(const For* op) {
   }
   else {
     stmt = For::make(var, start, end, increment, contents, op->kind,
-                     op->vec_width);
+                     op->vec_width, op->reductionArrays);
   }
 }
 
@@ -315,7 +327,28 @@ void IRRewriter::visit(const Allocate* op) {
     stmt = op;
   }
   else {
-    stmt = Allocate::make(var, num_elements, op->is_realloc);
+    stmt = Allocate::make(var, num_elements, op->is_realloc, op->clear);
+  }
+}
+
+void IRRewriter::visit(const Free* op) {
+  Expr var = rewrite(op->var);
+  if (var == op->var) {
+    stmt = op;
+  }
+  else {
+    stmt = Free::make(var);
+  }
+}
+
+void IRRewriter::visit(const Sort* op) {
+  Expr array        = rewrite(op->array);
+  Expr num_elements = rewrite(op->num_elements);
+  if (array == op->array && num_elements == op->num_elements) {
+    stmt = op;
+  }
+  else {
+    stmt = Sort::make(array, num_elements);
   }
 }
 
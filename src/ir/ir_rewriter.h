@@ -35,6 +35,9 @@ protected:
   virtual void visit(const Min* op);
   virtual void visit(const Max* op);
   virtual void visit(const BitAnd* op);
+  virtual void visit(const BitOr* op);
+  virtual void visit(const Shr* op);
+  virtual void visit(const Popcount* op);
   virtual void visit(const Eq* op);
   virtual void visit(const Neq* op);
   virtual void visit(const Gt* op);
@@ -54,6 +57,8 @@ protected:
   virtual void visit(const Function* op);
   virtual void visit(const VarAssign* op);
   virtual void visit(const Allocate* op);
+  virtual void visit(const Free* op);
+  virtual void visit(const Sort* op);
   virtual void visit(const Comment* op);
   virtual void visit(const BlankLine* op);
   virtual void visit(const Print* op);
@@ -69,6 +69,20 @@ void IRVisitor::visit(const BitAnd* op){
   op->b.accept(this);
 }
 
+void IRVisitor::visit(const BitOr* op){
+  op->a.accept(this);
+  op->b.accept(this);
+}
+
+void IRVisitor::visit(const Shr* op){
+  op->a.accept(this);
+  op->b.accept(this);
+}
+
+void IRVisitor::visit(const Popcount* op){
+  op->a.accept(this);
+}
+
 void IRVisitor::visit(const Eq* op){
   op->a.accept(this);
   op->b.accept(this);
@@ -142,6 +156,10 @@ void IRVisitor::visit(const For* op) {
   op->end.accept(this);
   op->increment.accept(this);
   op->contents.accept(this);
+  for (auto& array : op->reductionArrays) {
+    array.first.accept(this);
+    array.second.accept(this);
+  }
 }
 
 void IRVisitor::visit(const While* op) {
@@ -172,6 +190,15 @@ void IRVisitor::visit(const Allocate* op) {
   op->num_elements.accept(this);
 }
 
+void IRVisitor::visit(const Free* op) {
+  op->var.accept(this);
+}
+
+void IRVisitor::visit(const Sort* op) {
+  op->array.accept(this);
+  op->num_elements.accept(this);
+}
+
 void IRVisitor::visit(const GetProperty* op) {
   op->tensor.accept(this);
 }
@@ -15,6 +15,9 @@ struct Rem;
 struct Min;
 struct Max;
 struct BitAnd;
+struct BitOr;
+struct Shr;
+struct Popcount;
 struct Eq;
 struct Neq;
 struct Gt;
@@ -34,6 +37,8 @@ struct Scope;
 struct Function;
 struct VarAssign;
 struct Allocate;
+struct Free;
+struct Sort;
 struct Comment;
 struct BlankLine;
 struct Print;
@@ -55,6 +60,9 @@ public:
   virtual void visit(const Min*) = 0;
   virtual void visit(const Max*) = 0;
   virtual void visit(const BitAnd*) = 0;
+  virtual void visit(const BitOr*) = 0;
+  virtual void visit(const Shr*) = 0;
+  virtual void visit(const Popcount*) = 0;
   virtual void visit(const Eq*) = 0;
   virtual void visit(const Neq*) = 0;
   virtual void visit(const Gt*) = 0;
@@ -74,6 +82,8 @@ public:
   virtual void visit(const Function*) = 0;
   virtual void visit(const VarAssign*) = 0;
   virtual void visit(const Allocate*) = 0;
+  virtual void visit(const Free*) = 0;
+  virtual void visit(const Sort*) = 0;
   virtual void visit(const Comment*) = 0;
   virtual void visit(const BlankLine*) = 0;
   virtual void visit(const Print*) = 0;
@@ -98,6 +108,9 @@ public:
   virtual void visit(const Min* op);
   virtual void visit(const Max* op);
   virtual void visit(const BitAnd* op);
+  virtual void visit(const BitOr* op);
+  virtual void visit(const Shr* op);
+  virtual void visit(const Popcount* op);
   virtual void visit(const Eq* op);
   virtual void visit(const Neq* op);
   virtual void visit(const Gt* op);
@@ -117,6 +130,8 @@ public:
   virtual void visit(const Function* op);
   virtual void visit(const VarAssign* op);
   virtual void visit(const Allocate* op);
+  virtual void visit(const Free* op);
+  virtual void visit(const Sort* op);
   virtual void visit(const Comment* op);
   virtual void visit(const BlankLine* op);
   virtual void visit(const Print* op);
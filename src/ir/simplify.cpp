@@ -1,6 +1,9 @@
 #include "ir/simplify.h"
 
 #include <map>
+#include <functional>
+#include <set>
+#include <vector>
 
 #include "ir/ir.h"
 #include "ir/ir_visitor.h"
@@ -80,7 +83,384 @@ ir::Expr simplify(const ir::Expr& expr) {
   return Rewriter().rewrite(expr);
 }
 
-ir::Stmt simplify(const ir::Stmt& stmt) {
+bool equals(const Expr& a, const Expr& b) {
+  if (a == b) {
+    return true;
+  }
+  if (!a.defined() || !b.defined()) {
+    return false;
+  }
+  if (isa<Literal>(a) && isa<Literal>(b)) {
+    auto la = to<Literal>(a);
+    auto lb = to<Literal>(b);
+    if (!(la->type == lb->type)) {
+      return false;
+    }
+    return (la->type.kind == Type::Float) ? la->dbl_value == lb->dbl_value
+                                          : la->value == lb->value;
+  }
+  if (isa<GetProperty>(a) && isa<GetProperty>(b)) {
+    auto pa = to<GetProperty>(a);
+    auto pb = to<GetProperty>(b);
+    return pa->tensor == pb->tensor && pa->property == pb->property &&
+           pa->dim == pb->dim;
+  }
+  if (isa<Load>(a) && isa<Load>(b)) {
+    return equals(to<Load>(a)->arr, to<Load>(b)->arr) &&
+           equals(to<Load>(a)->loc, to<Load>(b)->loc);
+  }
+  if (isa<Min>(a) && isa<Min>(b)) {
+    auto& operandsA = to<Min>(a)->operands;
+    auto& operandsB = to<Min>(b)->operands;
+    if (operandsA.size() != operandsB.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < operandsA.size(); i++) {
+      if (!equals(operandsA[i], operandsB[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+#define TACO_BINARY_EQUALS(T)                              \
+  if (isa<T>(a) && isa<T>(b)) {                            \
+    return equals(to<T>(a)->a, to<T>(b)->a) &&             \
+           equals(to<T>(a)->b, to<T>(b)->b);               \
+  }
+  TACO_BINARY_EQUALS(Add)
+  TACO_BINARY_EQUALS(Sub)
+  TACO_BINARY_EQUALS(Mul)
+  TACO_BINARY_EQUALS(Div)
+  TACO_BINARY_EQUALS(Rem)
+  TACO_BINARY_EQUALS(Max)
+  TACO_BINARY_EQUALS(BitAnd)
+  TACO_BINARY_EQUALS(BitOr)
+  TACO_BINARY_EQUALS(Shr)
+  TACO_BINARY_EQUALS(Eq)
+  TACO_BINARY_EQUALS(Neq)
+  TACO_BINARY_EQUALS(Gt)
+  TACO_BINARY_EQUALS(Lt)
+  TACO_BINARY_EQUALS(Gte)
+  TACO_BINARY_EQUALS(Lte)
+  TACO_BINARY_EQUALS(And)
+  TACO_BINARY_EQUALS(Or)
+#undef TACO_BINARY_EQUALS
+  if (isa<Neg>(a) && isa<Neg>(b)) {
+    return equals(to<Neg>(a)->a, to<Neg>(b)->a);
+  }
+  if (isa<Popcount>(a) && isa<Popcount>(b)) {
+    return equals(to<Popcount>(a)->a, to<Popcount>(b)->a);
+  }
+  if (isa<Sqrt>(a) && isa<Sqrt>(b)) {
+    return equals(to<Sqrt>(a)->a, to<Sqrt>(b)->a);
+  }
+  return false;
+}
+
+namespace {
+
+/// Finds the variables a statement assigns and the tensors whose arrays it
+/// stores to, reallocates or sorts.
+struct FindModified : IRVisitor {
+  set<Expr,ExprCompare> vars;
+  set<Expr,ExprCompare> tensors;
+  set<Expr,ExprCompare> reassignedVars;
+
+  using IRVisitor::visit;
+
+  void modify(Expr arr) {
+    if (isa<GetProperty>(arr)) {
+      tensors.insert(to<GetProperty>(arr)->tensor);
+    }
+    else {
+      vars.insert(arr);
+    }
+  }
+
+  void visit(const VarAssign* op) {
+    vars.insert(op->lhs);
+    if (!op->is_decl) {
+      reassignedVars.insert(op->lhs);
+    }
+    IRVisitor::visit(op);
+  }
+
+  void visit(const For* op) {
+    vars.insert(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Store* op) {
+    modify(op->arr);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Allocate* op) {
+    modify(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Free* op) {
+    modify(op->var);
+    IRVisitor::visit(op);
+  }
+
+  void visit(const Sort* op) {
+    modify(op->array);
+    IRVisitor::visit(op);
+  }
+};
+
+}
+
+/// Returns true iff the expression does not read anything that is modified.
+static bool isInvariant(const Expr& expr, const FindModified& modified) {
+  struct IsInvariant : IRVisitor {
+    const FindModified& modified;
+    bool invariant = true;
+    IsInvariant(const FindModified& modified) : modified(modified) {}
+
+    using IRVisitor::visit;
+
+    void visit(const Var* op) {
+      if (util::contains(modified.vars, Expr(op))) {
+        invariant = false;
+      }
+    }
+
+    void visit(const GetProperty* op) {
+      if (util::contains(modified.tensors, op->tensor)) {
+        invariant = false;
+      }
+    }
+  };
+  IsInvariant isInvariant(modified);
+  expr.accept(&isInvariant);
+  return isInvariant.invariant;
+}
+
+/// Returns true iff the expression reads memory.
+static bool hasLoad(const Expr& expr) {
+  struct HasLoad : IRVisitor {
+    bool hasLoad = false;
+    using IRVisitor::visit;
+    void visit(const Load* op) {
+      hasLoad = true;
+    }
+  };
+  HasLoad hasLoad;
+  expr.accept(&hasLoad);
+  return hasLoad.hasLoad;
+}
+
+ir::Stmt hoistLoopInvariants(const ir::Stmt& stmt) {
+  struct Hoister : IRRewriter {
+    using IRRewriter::visit;
+
+    /// Statements to emit before the loop being rewritten
+    vector<Stmt> hoisted;
+
+    /// Returns a variable that holds the value of the invariant expression,
+    /// declaring it before the loop unless an equal one already was.
+    Expr hoist(Expr expr, string name) {
+      for (auto& stmt : hoisted) {
+        auto decl = to<VarAssign>(stmt);
+        if (equals(decl->rhs, expr)) {
+          return decl->lhs;
+        }
+      }
+      Expr var = Var::make(name, expr.type());
+      hoisted.push_back(VarAssign::make(var, expr, true));
+      return var;
+    }
+
+    /// Hoists the invariant bounds of a loop condition of the form
+    /// `(B2_pos < B.d2.pos[iB + 1]) && ...` into variables declared before the
+    /// loop. Since `&&` short-circuits, the loop may not evaluate the bounds
+    /// of conjuncts after the first, so hoisting must only see bounds that are
+    /// safe to evaluate wherever the loop is. The lowerer's `var < bound`
+    /// conjuncts are iterator ends, which read the pos array at the parent's
+    /// position (or compute from it), and so are.
+    Expr hoistBounds(Expr cond, const FindModified& modified) {
+      if (isa<And>(cond)) {
+        Expr a = hoistBounds(to<And>(cond)->a, modified);
+        Expr b = hoistBounds(to<And>(cond)->b, modified);
+        return (a == to<And>(cond)->a && b == to<And>(cond)->b)
+               ? cond : And::make(a, b);
+      }
+      if (isa<Lt>(cond)) {
+        auto lt = to<Lt>(cond);
+        if (isa<Var>(lt->a) && !isa<Var>(lt->b) && !isa<Literal>(lt->b) &&
+            isInvariant(lt->b, modified)) {
+          return Lt::make(lt->a, hoist(lt->b, to<Var>(lt->a)->name + "_end"));
+        }
+      }
+      return cond;
+    }
+
+    /// Hoists invariant products out of the position computations at the top
+    /// level of a loop body, leaving an addition in the loop:
+    /// int C2_pos = (iB * 42) + jB;  ->  int C2_pos = iB42 + jB;
+    Stmt reduceStrength(Stmt body, const FindModified& modified) {
+      // Statements of nested blocks are in the same scope as the loop body
+      vector<Stmt> stmts;
+      function<void(Stmt)> flatten = [&](Stmt stmt) {
+        if (isa<Block>(stmt)) {
+          for (auto& content : to<Block>(stmt)->contents) {
+            flatten(content);
+          }
+        }
+        else {
+          stmts.push_back(stmt);
+        }
+      };
+      flatten(isa<Scope>(body) ? to<Scope>(body)->scopedStmt : body);
+
+      bool changed = false;
+      for (auto& stmt : stmts) {
+        auto decl = stmt.as<VarAssign>();
+        if (decl == nullptr || !decl->is_decl || !isa<Add>(decl->rhs) ||
+            decl->lhs.type().kind != Type::Int) {
+          continue;
+        }
+        auto add = to<Add>(decl->rhs);
+        if (isa<Mul>(add->a) && !isa<Literal>(simplify(add->a)) &&
+            !hasLoad(add->a) && isInvariant(add->a, modified)) {
+          Expr product = hoist(add->a, to<Var>(decl->lhs)->name + "_base");
+          stmt = VarAssign::make(decl->lhs, Add::make(product, add->b), true);
+          changed = true;
+        }
+      }
+      return changed ? Block::make(stmts) : body;
+    }
+
+    void visit(const For* op) {
+      Stmt contents = rewrite(op->contents);
+
+      vector<Stmt> outerHoisted = hoisted;
+      hoisted.clear();
+      FindModified modified;
+      contents.accept(&modified);
+      modified.vars.insert(op->var);
+
+      Expr end = op->end;
+      if (!isa<Var>(end) && !isa<Literal>(end) && isInvariant(end, modified)) {
+        end = hoist(end, to<Var>(op->var)->name + "_end");
+      }
+      contents = reduceStrength(contents, modified);
+
+      if (hoisted.empty() && end == op->end && contents == op->contents) {
+        stmt = op;
+      }
+      else {
+        Stmt loop = For::make(op->var, op->start, end, op->increment,
+                              contents, op->kind, op->vec_width,
+                              op->reductionArrays);
+        stmt = hoisted.empty() ? loop : Block::make(util::combine(hoisted,
+                                                                  {loop}));
+      }
+      hoisted = outerHoisted;
+    }
+
+    void visit(const While* op) {
+      Stmt contents = rewrite(op->contents);
+
+      vector<Stmt> outerHoisted = hoisted;
+      hoisted.clear();
+      FindModified modified;
+      contents.accept(&modified);
+
+      Expr cond = hoistBounds(op->cond, modified);
+      contents = reduceStrength(contents, modified);
+
+      if (hoisted.empty() && cond == op->cond && contents == op->contents) {
+        stmt = op;
+      }
+      else {
+        Stmt loop = While::make(cond, contents, op->kind, op->vec_width);
+        stmt = hoisted.empty() ? loop : Block::make(util::combine(hoisted,
+                                                                  {loop}));
+      }
+      hoisted = outerHoisted;
+    }
+  };
+  return Hoister().rewrite(stmt);
+}
+
+ir::Stmt eliminateCommonSubexpressions(const ir::Stmt& stmt) {
+  struct Eliminator : IRRewriter {
+    using IRRewriter::visit;
+
+    void visit(const Block* op) {
+      // Variables that are assigned after their declaration cannot be reused
+      FindModified blockModified;
+      Stmt(op).accept(&blockModified);
+
+      // Declarations whose values are available at the current statement
+      vector<const VarAssign*> available;
+
+      vector<Stmt> contents;
+      function<void(Stmt)> eliminate = [&](Stmt stmt) {
+        // The statements of nested blocks are in the same scope
+        if (isa<Block>(stmt)) {
+          for (auto& content : to<Block>(stmt)->contents) {
+            eliminate(content);
+          }
+          return;
+        }
+        auto decl = stmt.as<VarAssign>();
+        if (decl && decl->is_decl && decl->lhs.type().kind == Type::Int &&
+            !isa<Var>(decl->rhs) && !isa<Literal>(decl->rhs)) {
+          bool reused = false;
+          for (auto& prev : available) {
+            if (equals(prev->rhs, decl->rhs)) {
+              stmt = VarAssign::make(decl->lhs, prev->lhs, true);
+              reused = true;
+              break;
+            }
+          }
+          if (!reused &&
+              !util::contains(blockModified.reassignedVars, decl->lhs)) {
+            available.push_back(decl);
+          }
+        }
+        else {
+          // Forget the values that the statement may change
+          FindModified modified;
+          stmt.accept(&modified);
+          vector<const VarAssign*> stillAvailable;
+          for (auto& prev : available) {
+            if (isInvariant(prev->rhs, modified)) {
+              stillAvailable.push_back(prev);
+            }
+          }
+          available = stillAvailable;
+        }
+        contents.push_back(stmt);
+      };
+
+      bool changed = false;
+      for (auto& content : op->contents) {
+        Stmt rewritten = rewrite(content);
+        if (rewritten != content) {
+          changed = true;
+        }
+        if (rewritten.defined()) {
+          size_t numContents = contents.size();
+          eliminate(rewritten);
+          if (contents.size() != numContents + 1 ||
+              contents.back() != rewritten) {
+            changed = true;
+          }
+        }
+      }
+      stmt = changed ? Block::make(contents) : Stmt(op);
+    }
+  };
+  return Eliminator().rewrite(stmt);
+}
+
+static ir::Stmt propagateCopies(const ir::Stmt& stmt) {
   // Perform copy propagation on variables that are added to a product of zero
   // and never re-assign, e.g. `int B1_pos = (0 * 42) + iB;`. These occur when
   // emitting code for top levels that are dense.
@@ -117,7 +497,10 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
     }
   };
 
+  // Declarations outside of any scope (e.g. at the top of a function body)
+  // go in an outermost scope
   CopyPropagationCandidates candidates;
+  candidates.declarations.scope();
   stmt.accept(&candidates);
 
   // Remove candidate var definitions and replace uses.
@@ -135,7 +518,12 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
 
     void visit(const VarAssign* assign) {
       if (assign->is_decl && util::contains(varDeclsToRemove, Stmt(assign))) {
-        varsToReplace.insert({assign->lhs, varDeclsToRemove.at(Stmt(assign))});
+        // The copied variable may itself be a removed copy
+        Expr value = varDeclsToRemove.at(Stmt(assign));
+        if (varsToReplace.contains(value)) {
+          value = varsToReplace.get(value);
+        }
+        varsToReplace.insert({assign->lhs, value});
         stmt = Stmt();
         return;
       }
@@ -152,7 +540,15 @@ ir::Stmt simplify(const ir::Stmt& stmt) {
   };
   CopyPropagation copyPropagation;
   copyPropagation.varDeclsToRemove = candidates.varDeclsToRemove;
+  copyPropagation.varsToReplace.scope();
   return copyPropagation.rewrite(stmt);
 }
 
+ir::Stmt simplify(const ir::Stmt& stmt) {
+  // Copies are propagated first so that hoisting and common subexpression
+  // elimination see equal expressions in terms of the same variables
+  Stmt hoisted = hoistLoopInvariants(propagateCopies(stmt));
+  return propagateCopies(eliminateCommonSubexpressions(hoisted));
+}
+
 }}
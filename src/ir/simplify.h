@@ -6,11 +6,25 @@ namespace ir {
 class Expr;
 class Stmt;
 
+/// Returns true iff the expressions compute the same value, meaning they are
+/// structurally equal and use the same variables.
+bool equals(const ir::Expr& a, const ir::Expr& b);
+
 /// Simplifies an expression (e.g. by applying algebraic identities).
 ir::Expr simplify(const ir::Expr& expr);
 
-/// Simplifies a statement (e.g. by applying constant copy propagation).
+/// Simplifies a statement (e.g. by applying constant copy propagation). Also
+/// hoists loop invariants and eliminates common subexpressions.
 ir::Stmt simplify(const ir::Stmt& stmt);
 
+/// Hoists loop bounds that do not change in a loop out of the loop, and
+/// strength reduces random-access position computations of the form
+/// `int C2_pos = (iB * 42) + jB;` by hoisting their invariant products.
+ir::Stmt hoistLoopInvariants(const ir::Stmt& stmt);
+
+/// Replaces integer variable declarations whose value was already computed by
+/// an earlier declaration in the same block with copies of that variable.
+ir::Stmt eliminateCommonSubexpressions(const ir::Stmt& stmt);
+
 }}
 #endif
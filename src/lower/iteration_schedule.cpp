@@ -7,6 +7,7 @@
 #include "taco/tensor.h"
 #include "taco/expr_nodes/expr_nodes.h"
 #include "taco/expr_nodes/expr_visitor.h"
+#include "taco/expr_nodes/expr_rewriter.h"
 #include "iteration_schedule_forest.h"
 #include "tensor_path.h"
 #include "taco/util/strings.h"
@@ -19,15 +20,18 @@ namespace lower {
 
 // class IterationSchedule
 struct IterationSchedule::Content {
-  Content(TensorBase tensor, IterationScheduleForest scheduleForest,
+  Content(TensorBase tensor, Expr indexExpr,
+          IterationScheduleForest scheduleForest,
           TensorPath resultTensorPath, vector<TensorPath> tensorPaths,
           map<Expr,TensorPath> mapReadNodesToPaths)
       : tensor(tensor),
+        indexExpr(indexExpr),
         scheduleForest(scheduleForest),
         resultTensorPath(resultTensorPath),
         tensorPaths(tensorPaths),
         mapReadNodesToPaths(mapReadNodesToPaths) {}
   TensorBase                             tensor;
+  Expr                                   indexExpr;
   IterationScheduleForest                scheduleForest;
   TensorPath                             resultTensorPath;
   vector<TensorPath>                     tensorPaths;
@@ -37,13 +41,70 @@ struct IterationSchedule::Content {
 IterationSchedule::IterationSchedule() {
 }
 
+/// Returns the index variables with split variables replaced by the inner
+/// variables they are split into.
+static vector<Var> replaceSplitVars(const vector<Var>& vars,
+                                    const Schedule& schedule) {
+  vector<Var> replaced;
+  for (auto& var : vars) {
+    replaced.push_back(schedule.isSplit(var) ? schedule.getSplit(var).inner
+                                             : var);
+  }
+  return replaced;
+}
+
 IterationSchedule IterationSchedule::make(const TensorBase& tensor) {
   Expr expr = tensor.getExpr();
+  const Schedule& loopSchedule = tensor.getSchedule();
 
   vector<TensorPath> tensorPaths;
 
+  // Check that the schedule directives refer to variables of the expression
+  set<Var> exprVars(tensor.getIndexVars().begin(),
+                    tensor.getIndexVars().end());
+  expr_nodes::match(expr,
+    function<void(const expr_nodes::ReadNode*)>(
+        [&](const expr_nodes::ReadNode* op) {
+      exprVars.insert(op->indexVars.begin(), op->indexVars.end());
+    })
+  );
+  for (auto& split : loopSchedule.getSplits()) {
+    taco_uassert(util::contains(exprVars, split.var)) << "Cannot split " <<
+        split.var << " since it is not in the expression";
+    taco_uassert(!util::contains(exprVars, split.outer) &&
+                 !util::contains(exprVars, split.inner)) <<
+        "The variables " << split.var << " is split into are already in the " <<
+        "expression";
+    exprVars.insert(split.outer);
+    exprVars.insert(split.inner);
+  }
+  for (auto& order : loopSchedule.getOrders()) {
+    for (auto& var : order) {
+      taco_uassert(util::contains(exprVars, var)) << "Cannot reorder " <<
+          var << " since it is not in the expression";
+    }
+  }
+
+  // Replace split variables by their inner variables, which take on the
+  // coordinates of the split variables
+  if (loopSchedule.getSplits().size() > 0) {
+    struct ReplaceSplitVars : public expr_nodes::ExprRewriter {
+      using ExprRewriter::visit;
+      const Schedule& schedule;
+      ReplaceSplitVars(const Schedule& schedule) : schedule(schedule) {}
+      void visit(const expr_nodes::ReadNode* op) {
+        vector<Var> indexVars = replaceSplitVars(op->indexVars, schedule);
+        expr = (indexVars != op->indexVars)
+               ? new expr_nodes::ReadNode(op->tensor, indexVars)
+               : Expr(op);
+      }
+    };
+    expr = ReplaceSplitVars(loopSchedule).rewrite(expr);
+  }
+
   // Create the tensor path formed by the result.
-  TensorPath resultTensorPath = TensorPath(tensor, tensor.getIndexVars());
+  TensorPath resultTensorPath =
+      TensorPath(tensor, replaceSplitVars(tensor.getIndexVars(), loopSchedule));
 
   // Create the paths formed by tensor reads in the given expression.
   struct CollectTensorPaths : public expr_nodes::ExprVisitor {
@@ -72,14 +133,21 @@ IterationSchedule IterationSchedule::make(const TensorBase& tensor) {
   util::append(tensorPaths, collect.tensorPaths);
   map<Expr,TensorPath> mapReadNodesToPaths = collect.mapReadNodesToPaths;
 
-  // Construct a forest decomposition from the tensor path graph
+  // Construct a forest decomposition from the tensor path graph, where the
+  // outer variable of each split is placed above its inner variable
+  vector<vector<Var>> orders = loopSchedule.getOrders();
+  for (auto& split : loopSchedule.getSplits()) {
+    orders.push_back({split.outer, split.inner});
+  }
   IterationScheduleForest forest =
-      IterationScheduleForest(util::combine({resultTensorPath},tensorPaths));
+      IterationScheduleForest(util::combine({resultTensorPath},tensorPaths),
+                              orders);
 
   // Create the iteration schedule
   IterationSchedule schedule = IterationSchedule();
   schedule.content =
       make_shared<IterationSchedule::Content>(tensor,
+                                              expr,
                                               forest,
                                               resultTensorPath,
                                               tensorPaths,
@@ -91,6 +159,10 @@ const TensorBase& IterationSchedule::getTensor() const {
   return content->tensor;
 }
 
+const taco::Expr& IterationSchedule::getIndexExpr() const {
+  return content->indexExpr;
+}
+
 const std::vector<taco::Var>& IterationSchedule::getRoots() const {
   return content->scheduleForest.getRoots();
 }
@@ -29,6 +29,10 @@ public:
   /// Returns the tensor the iteration schedule was built from.
   const TensorBase& getTensor() const;
 
+  /// Returns the index expression of the tensor, where variables that were
+  /// split are replaced by their inner variables.
+  const taco::Expr& getIndexExpr() const;
+
   /// Returns the iteration schedule roots; the index variables with no parents.
   const std::vector<taco::Var>& getRoots() const;
 
@@ -15,11 +15,10 @@ namespace lower {
 
 /// Maps each index variable to its successors and predecessors through a path.
 static tuple<set<Var>, set<Var>, map<Var, set<Var>>, map<Var,set<Var>>>
-getGraph(const vector<TensorPath>& tensorPaths) {
+getGraph(const vector<vector<Var>>& paths) {
   set<Var> vertices;
   set<Var> notSources;
-  for (auto& tensorPath : tensorPaths) {
-    auto steps = tensorPath.getVariables();
+  for (auto& steps : paths) {
       for (auto it = steps.begin(); it != steps.end(); ++it) {
         vertices.insert(*it);
       }
@@ -43,8 +42,7 @@ getGraph(const vector<TensorPath>& tensorPaths) {
   }
 
   // Traverse paths to insert successors and predecessors
-  for (auto& tensorPath : tensorPaths) {
-    auto path = tensorPath.getVariables();
+  for (auto& path : paths) {
     for (size_t i=1; i < path.size(); ++i) {
       successors.at(path[i-1]).insert(path[i]);
       predecessors.at(path[i]).insert(path[i-1]);
@@ -55,13 +53,55 @@ getGraph(const vector<TensorPath>& tensorPaths) {
 		  {vertices, sources, successors, predecessors};
 }
 
-IterationScheduleForest::IterationScheduleForest(const vector<TensorPath>& paths) {
-  // Construt a directed graph from the tensor paths
+/// Returns true iff the path graph has a cycle, which happens when the paths
+/// order two index variables in opposite ways.
+static bool hasCycle(const set<Var>& vertices,
+                     const map<Var,set<Var>>& predecessors,
+                     const map<Var,set<Var>>& successors) {
+  // Remove vertices without predecessors until none are left (Kahn)
+  map<Var,size_t> numPredecessors;
+  queue<Var> varsToVisit;
+  for (auto& var : vertices) {
+    numPredecessors[var] = predecessors.at(var).size();
+    if (numPredecessors[var] == 0) {
+      varsToVisit.push(var);
+    }
+  }
+  size_t numVisited = 0;
+  while (varsToVisit.size() != 0) {
+    Var var = varsToVisit.front();
+    varsToVisit.pop();
+    numVisited++;
+    for (auto& successor : successors.at(var)) {
+      if (--numPredecessors[successor] == 0) {
+        varsToVisit.push(successor);
+      }
+    }
+  }
+  return numVisited != vertices.size();
+}
+
+IterationScheduleForest::IterationScheduleForest(const vector<TensorPath>& paths,
+                                            const vector<vector<Var>>& orders) {
+  // Construt a directed graph from the tensor paths and loop orders
+  vector<vector<Var>> varPaths = orders;
+  for (auto& path : paths) {
+    varPaths.push_back(path.getVariables());
+  }
   set<Var> vertices;
   set<Var> sources;
   map<Var,set<Var>> successors;
   map<Var,set<Var>> predecessors;
-  tie(vertices,sources,successors,predecessors) = getGraph(paths);
+  tie(vertices,sources,successors,predecessors) = getGraph(varPaths);
+  if (hasCycle(vertices, predecessors, successors)) {
+    vector<string> orderStrings;
+    for (auto& order : orders) {
+      orderStrings.push_back("(" + util::join(order) + ")");
+    }
+    taco_uerror << "The loop order " << util::join(orderStrings) <<
+        " conflicts with the order the tensor formats store the index " <<
+        "variables in";
+  }
 
   // The sources of the path graph are the roots of the schedule forest
   roots.insert(roots.end(), sources.begin(), sources.end());
@@ -17,7 +17,10 @@ class IterationScheduleForest {
 public:
   IterationScheduleForest() {}
 
-  IterationScheduleForest(const std::vector<TensorPath>& paths);
+  /// Create a forest decomposition of the tensor paths. The index variables of
+  /// each of the given orders are also placed in order in the forest.
+  IterationScheduleForest(const std::vector<TensorPath>& paths,
+                          const std::vector<std::vector<Var>>& orders={});
 
   const std::vector<Var>& getRoots() const {return roots;}
 
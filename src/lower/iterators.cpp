@@ -55,7 +55,7 @@ Iterators::Iterators(const IterationSchedule& schedule,
     roots.insert({resultPath, parent});
 
     for (int i=0; i < (int)tensor.getOrder(); ++i) {
-      taco::Var var = tensor.getIndexVars()[i];
+      taco::Var var = resultPath.getVariables()[i];
       string name = var.getName();
       Iterator iterator = Iterator::make(name, tensorVar, i,
                                          format.getDimensionTypes()[i],
@@ -135,6 +135,17 @@ getRandomAccessIterators(const vector<storage::Iterator>& iterators) {
   return randomAccessIterators;
 }
 
+vector<storage::Iterator>
+getBitmapIterators(const vector<storage::Iterator>& iterators) {
+  vector<storage::Iterator> bitmapIterators;
+  for (auto& iterator : iterators) {
+    if (iterator.defined() && iterator.isBitmap()) {
+      bitmapIterators.push_back(iterator);
+    }
+  }
+  return bitmapIterators;
+}
+
 vector<ir::Expr> getIdxVars(const vector<storage::Iterator>& iterators) {
   vector<ir::Expr> idxVars;
   for (auto& iterator : iterators) {
@@ -58,6 +58,10 @@ getSequentialAccessIterators(const std::vector<storage::Iterator>&);
 std::vector<storage::Iterator>
 getRandomAccessIterators(const std::vector<storage::Iterator>&);
 
+/// Returns the bitmap iterators
+std::vector<storage::Iterator>
+getBitmapIterators(const std::vector<storage::Iterator>&);
+
 /// Returns the idx vars of the iterators.
 std::vector<ir::Expr> getIdxVars(const std::vector<storage::Iterator>&);
 
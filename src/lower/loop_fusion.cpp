@@ -0,0 +1,524 @@
+#include "loop_fusion.h"
+
+#include <set>
+#include <map>
+
+
+#include "ir/ir.h"
+#include "ir/ir_visitor.h"
+#include "ir/ir_rewriter.h"
+#include "ir/simplify.h"
+#include "taco/util/collections.h"
+
+using namespace std;
+using namespace taco::ir;
+
+namespace taco {
+namespace lower {
+
+namespace {
+
+/// Finds the variables that are assigned to after they are declared.
+struct FindAssignedVars : IRVisitor {
+  using IRVisitor::visit;
+  set<Expr,ExprCompare> vars;
+
+  void visit(const VarAssign* op) {
+    if (!op->is_decl) {
+      vars.insert(op->lhs);
+    }
+    IRVisitor::visit(op);
+  }
+};
+
+/// Renames the variables of the second expression's code to the variables of
+/// the first expression's code that they were fused with.
+struct RenameVars : IRRewriter {
+  using IRRewriter::visit;
+  map<Expr,Expr,ExprCompare> renames;
+
+  void visit(const Var* op) {
+    expr = renames.count(op) ? renames.at(op) : Expr(op);
+  }
+};
+
+}
+
+static set<Expr,ExprCompare> getAssignedVars(const vector<Stmt>& stmts) {
+  FindAssignedVars find;
+  for (auto& stmt : stmts) {
+    stmt.accept(&find);
+  }
+  return find.vars;
+}
+
+/// Returns the statements of a block, with nested blocks flattened.
+static vector<Stmt> getStatements(Stmt stmt) {
+  if (isa<Scope>(stmt)) {
+    stmt = to<Scope>(stmt)->scopedStmt;
+  }
+  if (!isa<Block>(stmt)) {
+    return {stmt};
+  }
+  vector<Stmt> stmts;
+  for (auto& content : to<Block>(stmt)->contents) {
+    if (isa<Block>(content)) {
+      util::append(stmts, getStatements(content));
+    }
+    else {
+      stmts.push_back(content);
+    }
+  }
+  return stmts;
+}
+
+/// Returns the value a statement stores or assigns, if any.
+static Expr getValue(const Stmt& stmt) {
+  if (isa<Store>(stmt)) {
+    return to<Store>(stmt)->data;
+  }
+  if (isa<VarAssign>(stmt)) {
+    return to<VarAssign>(stmt)->rhs;
+  }
+  return Expr();
+}
+
+static Stmt setValue(const Stmt& stmt, Expr value) {
+  if (isa<Store>(stmt)) {
+    auto store = to<Store>(stmt);
+    return Store::make(store->arr, store->loc, value);
+  }
+  auto assign = to<VarAssign>(stmt);
+  return VarAssign::make(assign->lhs, value, assign->is_decl);
+}
+
+/// Returns true iff the expression is floating point arithmetic.
+static bool isArithmetic(const Expr& expr) {
+  return expr.type().isFloat() &&
+         (isa<Add>(expr) || isa<Sub>(expr) || isa<Mul>(expr) ||
+          isa<Div>(expr) || isa<Neg>(expr) || isa<Sqrt>(expr));
+}
+
+/// Replaces the subexpressions of `expr` that are equal to `subexpr`.
+static Expr replaceSubexpr(Expr expr, Expr subexpr, Expr value, bool* found) {
+  if (equals(expr, subexpr)) {
+    *found = true;
+    return value;
+  }
+  if (!isArithmetic(expr)) {
+    return expr;
+  }
+#define TACO_REPLACE_BINARY(T)                                          \
+  if (isa<T>(expr)) {                                                   \
+    auto op = to<T>(expr);                                              \
+    return T::make(replaceSubexpr(op->a, subexpr, value, found),        \
+                   replaceSubexpr(op->b, subexpr, value, found),        \
+                   op->type);                                           \
+  }
+  TACO_REPLACE_BINARY(Add)
+  TACO_REPLACE_BINARY(Sub)
+  TACO_REPLACE_BINARY(Mul)
+  TACO_REPLACE_BINARY(Div)
+#undef TACO_REPLACE_BINARY
+  if (isa<Neg>(expr)) {
+    return Neg::make(replaceSubexpr(to<Neg>(expr)->a, subexpr, value, found));
+  }
+  taco_iassert(isa<Sqrt>(expr));
+  return Sqrt::make(replaceSubexpr(to<Sqrt>(expr)->a, subexpr, value, found));
+}
+
+/// Returns true iff the statements are the same, given that the variables of
+/// `b` are renamed by `rename`. Variables declared by `b` are renamed to the
+/// variables declared by `a`.
+static bool equals(const Stmt& a, const Stmt& b, RenameVars& rename) {
+  if (!a.defined() || !b.defined()) {
+    return !a.defined() && !b.defined();
+  }
+  if (isa<Scope>(a)) {
+    return equals(to<Scope>(a)->scopedStmt, b, rename);
+  }
+  if (isa<Scope>(b)) {
+    return equals(a, to<Scope>(b)->scopedStmt, rename);
+  }
+  if (isa<Block>(a) && isa<Block>(b)) {
+    auto& contentsA = to<Block>(a)->contents;
+    auto& contentsB = to<Block>(b)->contents;
+    if (contentsA.size() != contentsB.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < contentsA.size(); i++) {
+      if (!equals(contentsA[i], contentsB[i], rename)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (isa<VarAssign>(a) && isa<VarAssign>(b)) {
+    auto assignA = to<VarAssign>(a);
+    auto assignB = to<VarAssign>(b);
+    if (assignA->is_decl != assignB->is_decl ||
+        !equals(assignA->rhs, rename.rewrite(assignB->rhs))) {
+      return false;
+    }
+    if (assignA->is_decl) {
+      rename.renames[assignB->lhs] = assignA->lhs;
+      return assignA->lhs.type() == assignB->lhs.type();
+    }
+    return equals(assignA->lhs, rename.rewrite(assignB->lhs));
+  }
+  if (isa<Store>(a) && isa<Store>(b)) {
+    auto storeA = to<Store>(a);
+    auto storeB = to<Store>(b);
+    return equals(storeA->arr,  rename.rewrite(storeB->arr)) &&
+           equals(storeA->loc,  rename.rewrite(storeB->loc)) &&
+           equals(storeA->data, rename.rewrite(storeB->data));
+  }
+  if (isa<IfThenElse>(a) && isa<IfThenElse>(b)) {
+    auto ifA = to<IfThenElse>(a);
+    auto ifB = to<IfThenElse>(b);
+    return equals(ifA->cond, rename.rewrite(ifB->cond)) &&
+           equals(ifA->then, ifB->then, rename) &&
+           equals(ifA->otherwise, ifB->otherwise, rename);
+  }
+  if (isa<While>(a) && isa<While>(b)) {
+    auto whileA = to<While>(a);
+    auto whileB = to<While>(b);
+    return whileA->kind == whileB->kind &&
+           equals(whileA->cond, rename.rewrite(whileB->cond)) &&
+           equals(whileA->contents, whileB->contents, rename);
+  }
+  if (isa<For>(a) && isa<For>(b)) {
+    auto forA = to<For>(a);
+    auto forB = to<For>(b);
+    if (forA->kind != forB->kind ||
+        !equals(forA->start, rename.rewrite(forB->start)) ||
+        !equals(forA->end, rename.rewrite(forB->end)) ||
+        !equals(forA->increment, rename.rewrite(forB->increment))) {
+      return false;
+    }
+    rename.renames[forB->var] = forA->var;
+    return equals(forA->contents, forB->contents, rename);
+  }
+  return false;
+}
+
+namespace {
+
+/// Fuses the code of a second tensor expression into the code of a first.
+///
+/// Both lists are walked together. Declarations of the second list are
+/// replaced by identical declarations of the first, and loops of the second
+/// list are fused with loops of the first that have the same bounds. A
+/// variable that both lists declare the same way and later update is shared,
+/// and then every update of it must be the same in both lists. These updates
+/// and the fused loops synchronize the lists: the statements of each list
+/// between two synchronization points are emitted in order, first list first.
+class LoopFusion {
+public:
+  /// Fuse the lists without sharing the `excluded` variables of `first`.
+  LoopFusion(const vector<Stmt>& first, const vector<Stmt>& second,
+             const set<Expr,ExprCompare>& excluded)
+      : assignedFirst(getAssignedVars(first)),
+        assignedSecond(getAssignedVars(second)), excluded(excluded) {}
+
+  /// Fuse the statements, returning false if they cannot be fused.
+  bool fuse(const vector<Stmt>& first, const vector<Stmt>& second,
+            vector<Stmt>* fused) {
+    size_t next = 0;          // The next statement of `first` to emit
+    size_t firstSync = 0;     // Declarations the second list uses end here
+    vector<Stmt> pending;     // Statements of `second` to emit at next sync
+
+    for (auto& secondStmt : second) {
+      Stmt stmt = rename.rewrite(secondStmt);
+      size_t end = getSegmentEnd(first, next);
+
+      // Reuse an identical declaration of the first list
+      if (isa<VarAssign>(stmt) && to<VarAssign>(stmt)->is_decl) {
+        auto decl = to<VarAssign>(stmt);
+        Expr var = to<VarAssign>(secondStmt)->lhs;
+        bool isAssigned = util::contains(assignedSecond, var);
+        // Prefer a declaration of the same name, since variables of the same
+        // value may be used interchangeably by later statements
+        size_t match = end;
+        for (size_t i = next; i < end && (!isAssigned || var.type().isInt());
+             i++) {
+          if (!isa<VarAssign>(first[i]) || !to<VarAssign>(first[i])->is_decl){
+            continue;
+          }
+          auto firstDecl = to<VarAssign>(first[i]);
+          if (firstDecl->lhs.type() == var.type() &&
+              !util::contains(excluded, firstDecl->lhs) &&
+              util::contains(assignedFirst, firstDecl->lhs) == isAssigned &&
+              equals(firstDecl->rhs, decl->rhs) &&
+              (match == end || to<Var>(firstDecl->lhs)->name ==
+                               to<Var>(var)->name)) {
+            match = i;
+          }
+        }
+        bool matched = (match < end);
+        if (matched) {
+          Expr firstVar = to<VarAssign>(first[match])->lhs;
+          rename.renames.insert({var, firstVar});
+          if (isAssigned) {
+            sharedVars.insert(firstVar);
+          }
+          firstSync = max(firstSync, match+1);
+        }
+        if (!matched) {
+          pending.push_back(stmt);
+        }
+        continue;
+      }
+
+      // Fuse loops over the same space
+      if (isa<For>(stmt) || isa<While>(stmt)) {
+        size_t loop = max(next, firstSync);
+        for (; loop < min(end+1, first.size()); loop++) {
+          if (isFusible(first[loop], stmt)) {
+            break;
+          }
+        }
+        if (loop < min(end+1, first.size())) {
+          emitSegment(first, next, loop, pending, fused);
+          Stmt fusedLoop;
+          if (!fuseLoops(first[loop], secondStmt, &fusedLoop)) {
+            return false;
+          }
+          fused->push_back(fusedLoop);
+          next = loop + 1;
+          continue;
+        }
+      }
+
+      // Updates of shared variables must be the same in both lists
+      if (assignsSharedVar(stmt)) {
+        RenameVars localRename;
+        if (end == first.size() || end < firstSync ||
+            !equals(first[end], stmt, localRename)) {
+          addConflicts(stmt);
+          return false;
+        }
+        emitSegment(first, next, end, pending, fused);
+        fused->push_back(first[end]);
+        next = end + 1;
+        continue;
+      }
+
+      pending.push_back(stmt);
+    }
+
+    // The first list may not update shared variables past the second list
+    size_t end = getSegmentEnd(first, next);
+    if (end != first.size()) {
+      addConflicts(first[end]);
+      return false;
+    }
+    emitSegment(first, next, first.size(), pending, fused);
+    return true;
+  }
+
+  /// Get the shared variables whose updates differ, if fusion failed.
+  const set<Expr,ExprCompare>& getConflicts() const {
+    return conflicts;
+  }
+
+private:
+  set<Expr,ExprCompare> assignedFirst;
+  set<Expr,ExprCompare> assignedSecond;
+  set<Expr,ExprCompare> excluded;
+  set<Expr,ExprCompare> conflicts;
+
+  /// Renames variables of the second list to the first list variables they
+  /// are fused with.
+  RenameVars rename;
+
+  /// Variables of the first list that are updated by both lists
+  set<Expr,ExprCompare> sharedVars;
+
+  void addConflicts(const Stmt& stmt) {
+    FindAssignedVars find;
+    stmt.accept(&find);
+    for (auto& var : find.vars) {
+      if (util::contains(sharedVars, var)) {
+        conflicts.insert(var);
+      }
+    }
+  }
+
+  bool assignsSharedVar(const Stmt& stmt) const {
+    FindAssignedVars find;
+    stmt.accept(&find);
+    for (auto& var : find.vars) {
+      if (util::contains(sharedVars, var)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns the index of the first statement at or after `begin` that
+  /// updates a shared variable, which ends the segment starting at `begin`.
+  size_t getSegmentEnd(const vector<Stmt>& first, size_t begin) const {
+    size_t end = begin;
+    while (end < first.size() && !assignsSharedVar(first[end])) {
+      end++;
+    }
+    return end;
+  }
+
+  /// Returns true iff the loops iterate over the same space, given that the
+  /// variables of `second` are already renamed.
+  bool isFusible(const Stmt& first, const Stmt& second) const {
+    if (isa<For>(first) && isa<For>(second)) {
+      auto forFirst  = to<For>(first);
+      auto forSecond = to<For>(second);
+      return forFirst->kind == forSecond->kind &&
+             forFirst->vec_width == forSecond->vec_width &&
+             equals(forFirst->start, forSecond->start) &&
+             equals(forFirst->end, forSecond->end) &&
+             equals(forFirst->increment, forSecond->increment);
+    }
+    if (isa<While>(first) && isa<While>(second)) {
+      auto whileFirst  = to<While>(first);
+      auto whileSecond = to<While>(second);
+      return whileFirst->kind == whileSecond->kind &&
+             whileFirst->vec_width == whileSecond->vec_width &&
+             equals(whileFirst->cond, whileSecond->cond);
+    }
+    return false;
+  }
+
+  bool fuseLoops(const Stmt& first, const Stmt& second, Stmt* fusedLoop) {
+    vector<Stmt> body;
+    if (isa<For>(first)) {
+      auto forFirst  = to<For>(first);
+      auto forSecond = to<For>(second);
+      rename.renames.insert({forSecond->var, forFirst->var});
+      if (!fuse(getStatements(forFirst->contents),
+                getStatements(forSecond->contents), &body)) {
+        return false;
+      }
+      auto reductionArrays = forFirst->reductionArrays;
+      for (auto& array : forSecond->reductionArrays) {
+        reductionArrays.push_back({rename.rewrite(array.first),
+                                   rename.rewrite(array.second)});
+      }
+      *fusedLoop = For::make(forFirst->var, forFirst->start, forFirst->end,
+                             forFirst->increment, Block::make(body),
+                             forFirst->kind, forFirst->vec_width,
+                             reductionArrays);
+      return true;
+    }
+    auto whileFirst  = to<While>(first);
+    auto whileSecond = to<While>(second);
+    if (!fuse(getStatements(whileFirst->contents),
+              getStatements(whileSecond->contents), &body)) {
+      return false;
+    }
+    *fusedLoop = While::make(whileFirst->cond, Block::make(body),
+                             whileFirst->kind, whileFirst->vec_width);
+    return true;
+  }
+
+  /// Emit the statements `first[begin:end]` followed by the pending statements
+  /// of the second list. Arithmetic that a pending statement has in common
+  /// with one of the first statements is computed once, into a temporary
+  /// declared before the first statement.
+  void emitSegment(const vector<Stmt>& first, size_t begin, size_t end,
+                   vector<Stmt>& pending, vector<Stmt>* fused) {
+    vector<Stmt> segment(first.begin()+begin, first.begin()+end);
+    vector<vector<Stmt>> temporaries(segment.size());
+    vector<pair<Expr,Expr>> sharedSubexprs;
+    for (auto& stmt : pending) {
+      Expr value = getValue(stmt);
+      if (value.defined()) {
+        value = share(value, segment, temporaries, sharedSubexprs);
+        stmt = setValue(stmt, value);
+      }
+    }
+    for (size_t i = 0; i < segment.size(); i++) {
+      util::append(*fused, temporaries[i]);
+      fused->push_back(segment[i]);
+    }
+    util::append(*fused, pending);
+    pending.clear();
+  }
+
+  Expr share(Expr expr, vector<Stmt>& segment,
+             vector<vector<Stmt>>& temporaries,
+             vector<pair<Expr,Expr>>& sharedSubexprs) {
+    if (!isArithmetic(expr)) {
+      return expr;
+    }
+    for (auto& sharedSubexpr : sharedSubexprs) {
+      if (equals(sharedSubexpr.first, expr)) {
+        return sharedSubexpr.second;
+      }
+    }
+    for (size_t i = 0; i < segment.size(); i++) {
+      Expr value = getValue(segment[i]);
+      if (!value.defined()) {
+        continue;
+      }
+      Expr temporary = Var::make("t", expr.type());
+      bool found = false;
+      value = replaceSubexpr(value, expr, temporary, &found);
+      if (found) {
+        temporaries[i].push_back(VarAssign::make(temporary, expr, true));
+        segment[i] = setValue(segment[i], value);
+        sharedSubexprs.push_back({expr, temporary});
+        return temporary;
+      }
+    }
+
+#define TACO_SHARE_BINARY(T)                                               \
+    if (isa<T>(expr)) {                                                    \
+      auto op = to<T>(expr);                                               \
+      Expr a = share(op->a, segment, temporaries, sharedSubexprs);         \
+      Expr b = share(op->b, segment, temporaries, sharedSubexprs);         \
+      return T::make(a, b, op->type);                                      \
+    }
+    TACO_SHARE_BINARY(Add)
+    TACO_SHARE_BINARY(Sub)
+    TACO_SHARE_BINARY(Mul)
+    TACO_SHARE_BINARY(Div)
+#undef TACO_SHARE_BINARY
+    if (isa<Neg>(expr)) {
+      return Neg::make(share(to<Neg>(expr)->a, segment, temporaries,
+                             sharedSubexprs));
+    }
+    taco_iassert(isa<Sqrt>(expr));
+    return Sqrt::make(share(to<Sqrt>(expr)->a, segment, temporaries,
+                            sharedSubexprs));
+  }
+};
+
+}
+
+vector<Stmt> fuseLoopNests(const vector<Stmt>& firstStmts,
+                           const vector<Stmt>& secondStmts) {
+  vector<Stmt> first  = getStatements(Block::make(firstStmts));
+  vector<Stmt> second = getStatements(Block::make(secondStmts));
+
+  // Variables that were shared but that the lists update differently (e.g.
+  // the position variables of two results) are not shared on the next try
+  set<Expr,ExprCompare> excluded;
+  while (true) {
+    LoopFusion fusion(first, second, excluded);
+    vector<Stmt> fused;
+    if (fusion.fuse(first, second, &fused)) {
+      return fused;
+    }
+    size_t numExcluded = excluded.size();
+    excluded.insert(fusion.getConflicts().begin(),
+                    fusion.getConflicts().end());
+    if (excluded.size() == numExcluded) {
+      break;
+    }
+  }
+  vector<Stmt> fused = first;
+  util::append(fused, second);
+  return fused;
+}
+
+}}
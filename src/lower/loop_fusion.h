@@ -0,0 +1,26 @@
+#ifndef TACO_LOOP_FUSION_H
+#define TACO_LOOP_FUSION_H
+
+#include <vector>
+
+namespace taco {
+namespace ir {
+class Stmt;
+}
+
+namespace lower {
+
+/// Fuse the lowered code of two independent tensor expressions into one list
+/// of statements. The loops of the second expression are fused with loops of
+/// the first that iterate over the same space, and its position variables are
+/// shared with identical position variables of the first, so that operands
+/// they have in common are traversed once. Subexpressions that the fused loop
+/// bodies compute in common are computed once. If the loop nests diverge the
+/// code of the second expression is emitted after the first.
+///
+/// The expressions must not read each other's results.
+std::vector<ir::Stmt> fuseLoopNests(const std::vector<ir::Stmt>& first,
+                                    const std::vector<ir::Stmt>& second);
+
+}}
+#endif
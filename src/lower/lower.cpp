@@ -10,6 +10,7 @@
 #include "ir/ir.h"
 #include "ir/ir_visitor.h"
 #include "ir/ir_codegen.h"
+#include "ir/ir_rewriter.h"
 
 #include "lower_codegen.h"
 #include "iterators.h"
@@ -17,6 +18,7 @@
 #include "merge_lattice.h"
 #include "iteration_schedule.h"
 #include "available_exprs.h"
+#include "loop_fusion.h"
 #include "taco/expr_nodes/expr_nodes.h"
 #include "taco/expr_nodes/expr_rewriter.h"
 #include "storage/iterator.h"
@@ -37,6 +39,37 @@ using taco::ir::Var;
 using taco::ir::Add;
 using taco::storage::Iterator;
 
+/// A dense workspace that accumulates the values of a sparse result level whose
+/// index variable is iterated below reduction variables. Values are scattered
+/// into the workspace in any order, and the coordinates that were touched are
+/// recorded in a list that is sorted and gathered into the result after the
+/// reduction variables have been iterated (Gustavson's algorithm).
+struct Workspace {
+  bool             enabled = false;
+
+  /// The index variable of the result level the workspace accumulates
+  taco::Var        indexVar;
+
+  /// The result iterator of the accumulated level
+  Iterator         resultIterator;
+
+  /// The free variable after whose loop body the workspace is gathered, if
+  /// hasOwner. Otherwise the workspace is gathered after the loop nest.
+  bool             hasOwner = false;
+  taco::Var        owner;
+
+  /// The size of the workspace (the dimension of the accumulated level)
+  int              size;
+
+  /// Workspace arrays: dense values (when computing), a dense mark of the
+  /// coordinates that were touched, and the number of touched coordinates.
+  /// When assembling the touched coordinates are also recorded in a list.
+  Expr             values;
+  Expr             mark;
+  Expr             count;
+  Expr             list;
+};
+
 struct Context {
   /// Determines what kind of code to emit (e.g. compute and/or assembly)
   set<Property>        properties;
@@ -50,9 +83,28 @@ struct Context {
   /// The size of initial memory allocations
   size_t               allocSize;
 
+  /// The component type temporaries are computed in, which is the result's
+  /// unless the schedule gives an accumulator type
+  ComponentType        ctype;
+
   /// Maps tensor (scalar) temporaries to IR variables.
   /// (Not clear if this approach to temporaries is too hacky.)
   map<TensorBase,Expr> temporaries;
+
+  /// The workspace of the result, if the result is accumulated in one
+  Workspace            workspace;
+
+  /// Maps the outer variables of split index variables to the IR variables
+  /// of their loops
+  map<taco::Var,Expr>  outerSplitVars;
+
+  /// Restricts the loops of index variables to ranges of positions, given as
+  /// the begin and end positions.
+  map<taco::Var,pair<Expr,Expr>> loopRanges;
+
+  /// The index variables whose loops iterate over non-unique levels (e.g. the
+  /// first level of COO), and so may visit a coordinate more than once.
+  set<taco::Var>       nonUniqueVars;
 };
 
 struct Target {
@@ -110,12 +162,174 @@ static bool needsMerge(MergeLattice lattice) {
   return false;
 }
 
+/// Returns true iff the lattice can be iterated a word at a time over the
+/// bitmaps of its bitmap iterators, which holds iff every lattice point has a
+/// bitmap iterator and all of the lattice's iterators are random access. The
+/// indices of a lattice point are then the set bits of the AND of its bitmaps'
+/// words, and those of the lattice the OR over its points.
+static bool iteratesBits(MergeLattice lattice) {
+  for (auto& iterator : lattice.getIterators()) {
+    if (!iterator.isRandomAccess()) {
+      return false;
+    }
+  }
+  for (auto& point : lattice) {
+    if (getBitmapIterators(point.getIterators()).empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Intersection loops switch to galloping when one iterator has this many
+/// times more positions left than another.
+static const int GALLOP_RATIO = 16;
+
+/// Returns true iff the lattice point is an intersection of two or more
+/// iterators that can all be advanced by galloping, so that its merge loop can
+/// skip the positions of the larger iterators that cannot match.
+static bool canGallop(const MergeLatticePoint& lp,
+                      const MergeLattice& lpLattice) {
+  if (lpLattice.getSize() > 1 || lp.getIterators().size() < 2) {
+    return false;
+  }
+  for (auto& iterator : lp.getIterators()) {
+    if (iterator.isRandomAccess() ||
+        !iterator.advanceTo(iterator.getIdxVar()).defined()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Rewrites IR code, replacing variables with other expressions.
+struct ReplaceVars : public IRRewriter {
+  using IRRewriter::visit;
+  map<Expr,Expr,ExprCompare> substitutions;
+
+  void visit(const Var* op) {
+    expr = substitutions.count(op) ? substitutions.at(op) : Expr(op);
+  }
+};
+
+/// Returns the expression with the variable replaced by a value.
+static Expr replaceVar(Expr expr, Expr var, Expr value) {
+  ReplaceVars replace;
+  replace.substitutions.insert({var, value});
+  return replace.rewrite(expr);
+}
+
+/// Finds the variables declared in a statement.
+struct FindDecls : public IRVisitor {
+  using IRVisitor::visit;
+  vector<Expr> decls;
+  void visit(const VarAssign* op) {
+    if (op->is_decl && op->lhs.as<Var>()) {
+      decls.push_back(op->lhs);
+    }
+    IRVisitor::visit(op);
+  }
+};
+
+/// Adds substitutions that rename the variables declared in a statement by
+/// appending a suffix, so that copies of the statement can be emitted in the
+/// same scope.
+static void renameDecls(Stmt stmt, string suffix, ReplaceVars* replace) {
+  FindDecls findDecls;
+  stmt.accept(&findDecls);
+  for (auto& decl : findDecls.decls) {
+    Expr renamed = Var::make(decl.as<Var>()->name + suffix, decl.type());
+    replace->substitutions[decl] = renamed;
+  }
+}
+
+/// Reductions over sparse dimensions into scalar temporaries are unrolled this
+/// many times, with one partial accumulator per unrolled iteration.
+static const int UNROLL_FACTOR = 4;
+
+/// Emit a loop that reduces into a scalar accumulator, unrolled so that each
+/// unrolled iteration adds into its own partial accumulator. This breaks the
+/// dependence between consecutive additions, so that they can be pipelined
+/// (or vectorized with gathers). Remaining iterations are reduced one at a
+/// time, and the partial accumulators are then added to the accumulator:
+/// int B2_pos = B.d2.pos[B1_pos];
+/// int B2_pos_end = B.d2.pos[B1_pos + 1];
+/// double tj_1 = 0; ...
+/// while (B2_pos + 3 < B2_pos_end) { <body(B2_pos), body(B2_pos+1), ...> }
+/// while (B2_pos < B2_pos_end) { <body(B2_pos)> }
+/// tj = tj + ((tj_1 + tj_2) + tj_3);
+static vector<Stmt> unrollReduction(Expr iteratorVar, Expr begin, Expr end,
+                                    Stmt body, Expr accumulator) {
+  string accName = util::toString(accumulator);
+  Expr iteratorEnd = Var::make(util::toString(iteratorVar) + "_end",
+                               iteratorVar.type());
+  vector<Stmt> code = {VarAssign::make(iteratorVar, begin, true),
+                       VarAssign::make(iteratorEnd, end, true)};
+
+  vector<Stmt> unrolledBody = {body};
+  vector<Expr> partials;
+  for (int u = 1; u < UNROLL_FACTOR; u++) {
+    Expr partial = Var::make(accName + "_" + to_string(u), accumulator.type());
+    code.push_back(VarAssign::make(partial, 0.0, true));
+    partials.push_back(partial);
+
+    // Variables declared in the body must be renamed in each copy
+    ReplaceVars replace;
+    replace.substitutions.insert({iteratorVar, Add::make(iteratorVar, u)});
+    replace.substitutions.insert({accumulator, partial});
+    renameDecls(body, "_" + to_string(u), &replace);
+    unrolledBody.push_back(replace.rewrite(body));
+  }
+  unrolledBody.push_back(VarAssign::make(iteratorVar,
+                                         Add::make(iteratorVar,UNROLL_FACTOR)));
+  Expr hasUnrolled = Lt::make(Add::make(iteratorVar, UNROLL_FACTOR-1),
+                              iteratorEnd);
+  code.push_back(While::make(hasUnrolled, Block::make(unrolledBody)));
+
+  Stmt remainderBody = Block::make({body,
+      VarAssign::make(iteratorVar, Add::make(iteratorVar, 1))});
+  code.push_back(While::make(Lt::make(iteratorVar, iteratorEnd),
+                             remainderBody));
+
+  Expr partialSum = partials[0];
+  for (size_t i = 1; i < partials.size(); i++) {
+    partialSum = Add::make(partialSum, partials[i]);
+  }
+  code.push_back(compoundAssign(accumulator, partialSum));
+  return code;
+}
+
+/// Dense loops over the components of blocks are fully unrolled if the blocks
+/// have at most this many components along the loop's dimension.
+static const int BLOCK_UNROLL_LIMIT = 8;
+
+/// Returns the number of components of a dense level of small blocks stored
+/// below a sparse level (e.g. the 4x4 blocks of BCSR), or 0 if the iterator
+/// does not iterate over such a level.
+static int getBlockSize(const Iterator& iterator) {
+  const Literal* size = iterator.end().as<Literal>();
+  if (!iterator.isDense() || size == nullptr ||
+      size->value > BLOCK_UNROLL_LIMIT) {
+    return 0;
+  }
+  for (Iterator parent = iterator.getParent(); parent.defined();
+       parent = parent.getParent()) {
+    if (!parent.isDense()) {
+      return (int)size->value;
+    }
+  }
+  return 0;
+}
+
 static Iterator getIterator(std::vector<storage::Iterator>& iterators) {
   taco_iassert(!iterators.empty());
 
+  // Loops over random access iterators only iterate over a hashed iterator's
+  // table, if there is one, rather than over the whole dimension
   Iterator iter = iterators[0];
   for (size_t i = 1; i < iterators.size(); ++i) {
-    if (!iterators[i].isRandomAccess()) {
+    if (!iterators[i].isRandomAccess() ||
+        (iter.isDense() && !iterators[i].isDense())) {
       iter = iterators[i];
     }
   }
@@ -188,10 +402,420 @@ static taco::Expr getSubExpr(taco::Expr expr, const vector<taco::Var>& vars) {
   return SubExprVisitor(vars).getSubExpression(expr);
 }
 
+/// Returns true iff the iterations of the loop of an index variable may add to
+/// the same result locations, which is the case for reduction variables and
+/// for variables whose loops iterate over non-unique levels.
+static bool accumulates(const taco::Var& indexVar, const Context& ctx) {
+  return indexVar.isReduction() || util::contains(ctx.nonUniqueVars, indexVar);
+}
+
+/// Returns true iff results computed in the loop of an index variable must be
+/// added to the result, since the loop or a loop around it accumulates.
+static bool hasAccumulatingAncestor(const taco::Var& indexVar,
+                                    const Context& ctx) {
+  for (auto& ancestor : ctx.schedule.getAncestors(indexVar)) {
+    if (accumulates(ancestor, ctx)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// Returns true iff the loop of an accumulating variable can run in parallel
+/// with every thread adding to a private copy of the result, which is the case
+/// for root loops that compute scalar and vector results.
+static bool canPrivatizeResult(const taco::Var& indexVar, const Context& ctx) {
+  return accumulates(indexVar, ctx) &&
+         ctx.schedule.getAncestors(indexVar).size() == 1 &&
+         ctx.schedule.getResultTensorPath().getSize() <= 1;
+}
+
+/// Returns the kind of loop to emit for an index variable. The kind is given
+/// by the schedule's directives. Without parallelize directives the loop of a
+/// root variable is parallel if the result is dense and, for reduction
+/// variables, can be privatized. Other loops are vectorized if they are
+/// `vectorizable`. Loops that decode the indices of a delta level `iterator`
+/// are serial, since every iteration decodes from where the last one stopped.
+static LoopKind getLoopKind(const taco::Var& indexVar, const Context& ctx,
+                            bool vectorizable=false,
+                            const Iterator& iterator=Iterator()) {
+  const Schedule& schedule = ctx.schedule.getTensor().getSchedule();
+
+  if (iterator.defined() && iterator.initDecoder().defined()) {
+    return LoopKind::Serial;
+  }
+
+  bool denseResult = true;
+  TensorPath resultPath = ctx.schedule.getResultTensorPath();
+  for (size_t i = 0; i < resultPath.getSize(); i++) {
+    if (!ctx.iterators[resultPath.getStep(i)].isDense()) {
+      denseResult = false;
+    }
+  }
+
+  if (schedule.isParallel(indexVar)) {
+    taco_uassert(denseResult) << "Cannot parallelize " << indexVar <<
+        " since the result has sparse dimensions";
+    taco_uassert(!accumulates(indexVar, ctx) ||
+                 canPrivatizeResult(indexVar, ctx)) <<
+        "Cannot parallelize " << indexVar << " since its iterations add to " <<
+        "the same result locations and its loop is not the root loop of a " <<
+        "scalar or vector result";
+    // Accumulating loops only add to the result when computing
+    return (!accumulates(indexVar, ctx) ||
+            util::contains(ctx.properties, Compute))
+           ? LoopKind::Parallel
+           : LoopKind::Serial;
+  }
+  if (schedule.isVectorized(indexVar)) {
+    return LoopKind::Vectorized;
+  }
+  bool parallel = !schedule.hasParallelDirectives() && denseResult &&
+                  ctx.schedule.getAncestors(indexVar).size() == 1 &&
+                  (!accumulates(indexVar, ctx) ||
+                   (canPrivatizeResult(indexVar, ctx) &&
+                    util::contains(ctx.properties, Compute)));
+  if (parallel) {
+    return LoopKind::Parallel;
+  }
+  return vectorizable ? LoopKind::Vectorized : LoopKind::Serial;
+}
+
+/// Returns the result values that the iterations of a loop of the given kind
+/// add to, paired with their size, if the loop is a parallel accumulating
+/// loop: #pragma omp parallel for reduction(+:y_vals[:42])
+static vector<pair<Expr,Expr>> getReductionArrays(const taco::Var& indexVar,
+                                                  LoopKind kind,
+                                                  const Context& ctx) {
+  if (kind != LoopKind::Parallel || !accumulates(indexVar, ctx)) {
+    return {};
+  }
+  TensorPath resultPath = ctx.schedule.getResultTensorPath();
+  Expr resultTensor = ctx.iterators.getRoot(resultPath).getTensor();
+  Expr size = (resultPath.getSize() > 0)
+              ? ctx.iterators[resultPath.getStep(0)].end()
+              : Expr(1);
+  return {{GetProperty::make(resultTensor, TensorProperty::Values), size}};
+}
+
+/// Emit code to gather the coordinates and values accumulated in the
+/// workspace into the result, and to clear the workspace for the next segment:
+/// for (int j_pos = 0; j_pos < j_count; j_pos++) {
+///   int j = j_list[j_pos];
+///   A.d2.idx[A2_pos] = j;
+///   A.vals[A2_pos] = j_workspace[j];
+///   ...
+/// }
+static vector<Stmt> gatherWorkspace(const Context& ctx) {
+  const Workspace& ws = ctx.workspace;
+  Iterator resultIterator = ws.resultIterator;
+  Expr     resultPtr      = resultIterator.getPtrVar();
+  Expr     resultTensor   = resultIterator.getTensor();
+  int      level          = ctx.schedule.getResultTensorPath()
+                                .getStep(ws.indexVar).getStep();
+  Expr vals   = GetProperty::make(resultTensor, TensorProperty::Values);
+  Expr idxArr = GetProperty::make(resultTensor, TensorProperty::Index, level);
+  Expr idx    = Var::make(ws.indexVar.getName(), Type(Type::Int));
+  Expr pos    = Var::make(ws.indexVar.getName() + "_pos", Type(Type::Int));
+
+  bool emitCompute  = util::contains(ctx.properties, Compute);
+  bool emitAssemble = util::contains(ctx.properties, Assemble);
+
+  vector<Stmt> code;
+  vector<Stmt> body;
+  if (emitAssemble) {
+    // Coordinates are appended in sorted order
+    code.push_back(Sort::make(ws.list, ws.count));
+    body.push_back(VarAssign::make(idx, Load::make(ws.list, pos), true));
+    body.push_back(resultIterator.storeIdx(idx));
+  }
+  else {
+    // The coordinates were sorted and appended when assembling
+    body.push_back(VarAssign::make(idx, Load::make(idxArr, resultPtr), true));
+  }
+  body.push_back(Store::make(ws.mark, idx, 0));
+  if (emitCompute) {
+    body.push_back(Store::make(vals, resultPtr, Load::make(ws.values, idx)));
+    body.push_back(Store::make(ws.values, idx, 0.0));
+  }
+  body.push_back(VarAssign::make(resultPtr, Add::make(resultPtr, 1)));
+  if (emitAssemble) {
+    Expr doResize = ir::And::make(
+        Eq::make(0, BitAnd::make(Add::make(resultPtr, 1), resultPtr)),
+        Lte::make(ctx.allocSize, Add::make(resultPtr, 1)));
+    Expr newSize = ir::Mul::make(2, ir::Add::make(resultPtr, 1));
+    body.push_back(IfThenElse::make(doResize,
+                                    resultIterator.resizeIdxStorage(newSize)));
+  }
+  code.push_back(For::make(pos, 0, ws.count, 1, Block::make(body)));
+
+  if (emitAssemble) {
+    code.push_back(resultIterator.storePtr());
+  }
+  code.push_back(VarAssign::make(ws.count, 0));
+  return code;
+}
+
+static vector<Stmt> lower(const Target&     target,
+                          const taco::Expr& indexExpr,
+                          const taco::Var&  indexVar,
+                          Context&          ctx);
+
+/// Emit the loop over the blocks of a split index variable, whose inner
+/// variable is lowered below it:
+/// for (int i0 = 0; i0 < ((N + 63) / 64); i0++) { ... }
+static vector<Stmt> lowerOuterSplitLoop(const Target&     target,
+                                        const taco::Expr& indexExpr,
+                                        const taco::Var&  indexVar,
+                                        Context&          ctx) {
+  const Schedule::Split& split =
+      ctx.schedule.getTensor().getSchedule().getSplit(indexVar);
+
+  // The inner variable's loop must iterate over dense dimensions, of which we
+  // take the size from any of them
+  MergeLattice innerLattice = MergeLattice::make(indexExpr, split.inner,
+                                                 ctx.schedule, ctx.iterators);
+  Expr size;
+  for (auto& iterator : innerLattice.getIterators()) {
+    taco_uassert(iterator.isDense()) << "Cannot split " << split.var <<
+        " since it indexes a sparse dimension";
+    size = iterator.end();
+  }
+  taco_iassert(size.defined());
+
+  auto& children = ctx.schedule.getChildren(indexVar);
+  taco_uassert(children.size() == 1) << "The loop of " << indexVar <<
+      " must enclose exactly one loop";
+
+  Expr outerVar = Var::make(indexVar.getName(), Type(Type::Int));
+  ctx.outerSplitVars.insert({indexVar, outerVar});
+  Expr numBlocks = Div::make(Add::make(size, split.factor - 1), split.factor);
+
+  vector<Stmt> body = lower(target, indexExpr, children[0], ctx);
+  LoopKind kind = getLoopKind(indexVar, ctx);
+  return {For::make(outerVar, 0, numBlocks, 1, Block::make(body), kind, 0,
+                    getReductionArrays(indexVar, kind, ctx))};
+}
+
+/// The nonzeros below a loop whose nonzeros are parallelized are split into
+/// this many partitions, which are distributed over the threads.
+static const int NONZERO_PARTITIONS = 256;
+
+/// Emit a merge-path search for the row and nonzero at which the merge of
+/// the row ends (pos[1], ..., pos[N]) and the nonzeros (0, ..., nnz-1) has
+/// consumed `diag` items:
+/// int i_row = max(i_diag - i_nnz, 0);
+/// int i_row_hi = min(i_diag, N);
+/// while (i_row < i_row_hi) {
+///   int i_row_mid = (i_row + i_row_hi) / 2;
+///   if (B.d2.pos[i_row_mid + 1] <= i_diag - i_row_mid - 1) {
+///     i_row = i_row_mid + 1;
+///   } else { i_row_hi = i_row_mid; }
+/// }
+/// int i_nz = i_diag - i_row;
+static vector<Stmt> mergePathSearch(Expr diag, Expr numRows, Expr numNonzeros,
+                                    Iterator nonzeros, Expr row, Expr nz) {
+  string rowName = util::toString(row);
+  Expr hi  = Var::make(rowName + "_hi",  Type(Type::Int));
+  Expr mid = Var::make(rowName + "_mid", Type(Type::Int));
+
+  Expr rowEnd = replaceVar(nonzeros.end(), nonzeros.getParent().getPtrVar(),
+                           mid);
+  Expr nonzerosConsumed = Lte::make(rowEnd, ir::Sub::make(ir::Sub::make(diag,
+                                                                        mid),
+                                                          1));
+  Stmt search = Block::make({
+    VarAssign::make(mid, Div::make(Add::make(row, hi), 2), true),
+    IfThenElse::make(nonzerosConsumed,
+                     VarAssign::make(row, Add::make(mid, 1)),
+                     VarAssign::make(hi, mid))
+  });
+  return {VarAssign::make(row, Max::make(ir::Sub::make(diag, numNonzeros), 0),
+                          true),
+          VarAssign::make(hi, Min::make({diag, numRows}), true),
+          While::make(Lt::make(row, hi), search),
+          VarAssign::make(nz, ir::Sub::make(diag, row), true)};
+}
+
+/// Emit the loop of a root index variable whose nonzeros are parallelized.
+/// The rows and the nonzeros below them form two lists that are merged, and
+/// each partition takes an equal share of the merged items. A row that
+/// straddles partitions is computed partially in each, and the partial
+/// results of the last row of every partition are added to the result after
+/// the parallel loop:
+/// for (int i_part = 0; i_part < 256; i_part++) {
+///   <merge-path search for i_row, i_nz and i_row_end, i_nz_end>
+///   for (int iB = i_row; iB < i_row_end; iB++) { <complete row iB> }
+///   i_carry_rows[i_part] = i_row_end;
+///   i_carry_vals[i_part] = <row i_row_end up to nonzero i_nz_end>;
+/// }
+/// for (int i_part = 0; i_part < 256; i_part++) {
+///   y[i_carry_rows[i_part]] += i_carry_vals[i_part];
+/// }
+static vector<Stmt> lowerParallelNonzerosLoop(const Target&     target,
+                                              const taco::Expr& indexExpr,
+                                              const taco::Var&  indexVar,
+                                              Context&          ctx) {
+  MergeLattice lattice = MergeLattice::make(indexExpr, indexVar, ctx.schedule,
+                                            ctx.iterators);
+  auto& children = ctx.schedule.getChildren(indexVar);
+  TensorPathStep resultStep = ctx.schedule.getResultTensorPath()
+                                  .getStep(indexVar);
+
+  // The loop must compute one result component per row from a reduction over
+  // a single sparse level below it, so that partial rows can be added up
+  bool supported = ctx.schedule.getAncestors(indexVar).size() == 1 &&
+                   getComputeCase(indexVar, ctx.schedule) == LAST_FREE &&
+                   resultStep.getPath().defined() &&
+                   ctx.iterators[resultStep].isDense() &&
+                   lattice.getSize() == 1 && children.size() == 1 &&
+                   ctx.schedule.getChildren(children[0]).empty() &&
+                   getAvailableExpressions(indexExpr, {indexVar}).empty();
+  Iterator nonzeros;
+  if (supported) {
+    MergeLattice childLattice = MergeLattice::make(indexExpr, children[0],
+                                                   ctx.schedule, ctx.iterators);
+    supported = childLattice.getSize() == 1;
+    for (auto& iterator : childLattice.getIterators()) {
+      if (!iterator.isDense()) {
+        supported = supported && !nonzeros.defined() &&
+                    util::contains(lattice.getIterators(),
+                                   iterator.getParent());
+        nonzeros = iterator;
+      }
+    }
+    supported = supported && nonzeros.defined();
+  }
+  for (auto& iterator : lattice.getIterators()) {
+    supported = supported && iterator.isDense();
+  }
+  taco_uassert(!nonzeros.defined() || !nonzeros.initDecoder().defined()) <<
+      "Cannot parallelize the nonzeros below " << indexVar << " since the " <<
+      "indices of the delta level of " << nonzeros.getTensor() << " are " <<
+      "decoded in order";
+  if (!supported) {
+    taco_uerror << "Cannot parallelize the nonzeros below " << indexVar <<
+        " since it must be a root variable that indexes dense dimensions and " <<
+        "the result, and whose loop encloses one sum over a sparse dimension";
+  }
+  const taco::Var& child = children[0];
+
+  // The row loop computes the child expression into a temporary, and must
+  // store the temporary as is
+  TensorBase t("t" + child.getName(), ctx.ctype);
+  Expr tensorVar = Var::make(t.getName(), getValueType(ctx.ctype));
+  ctx.temporaries.insert({t, tensorVar});
+  taco::Expr childExpr = getSubExpr(indexExpr,
+                                    ctx.schedule.getDescendants(child));
+  taco_uassert(isa<ReadNode>(expr_nodes::replace(indexExpr,
+                                                 {{childExpr,
+                                                   taco::Access(t)}}))) <<
+      "Cannot parallelize the nonzeros below " << indexVar << " since the " <<
+      "result is not a sum over the nonzeros";
+
+  Iterator resultIterator = ctx.iterators[resultStep];
+  Iterator rows = nonzeros.getParent();
+  Expr idx = rows.getIdxVar();
+  Expr numRows = rows.end();
+  Expr numNonzeros = replaceVar(nonzeros.begin(), rows.getPtrVar(), numRows);
+
+  string name = indexVar.getName();
+  Expr part      = Var::make(name + "_part",      Type(Type::Int));
+  Expr nnz       = Var::make(name + "_nnz",       Type(Type::Int));
+  Expr partSize  = Var::make(name + "_part_size", Type(Type::Int));
+  Expr diag      = Var::make(name + "_diag",      Type(Type::Int));
+  Expr diagEnd   = Var::make(name + "_diag_end",  Type(Type::Int));
+  Expr row       = Var::make(name + "_row",       Type(Type::Int));
+  Expr nz        = Var::make(name + "_nz",        Type(Type::Int));
+  Expr rowEnd    = Var::make(name + "_row_end",   Type(Type::Int));
+  Expr nzEnd     = Var::make(name + "_nz_end",    Type(Type::Int));
+  Expr carryRows = Var::make(name + "_carry_rows", Type(Type::Int), true);
+  Expr carryVals = Var::make(name + "_carry_vals", getValueType(ctx.ctype),
+                             true);
+
+  // Emit the code to compute the temporary of the row of iB from the
+  // partition's nonzeros
+  ctx.loopRanges[child] = {Max::make(nz, nonzeros.begin()),
+                           Min::make({nzEnd, nonzeros.end()})};
+  auto computeRow = [&]() {
+    vector<Stmt> code;
+    for (auto& iterator : {rows, resultIterator}) {
+      Expr ptr = Add::make(ir::Mul::make(iterator.getParent().getPtrVar(),
+                                         iterator.end()), idx);
+      code.push_back(VarAssign::make(iterator.getPtrVar(), ptr, true));
+    }
+    code.push_back(VarAssign::make(tensorVar, 0.0, true));
+    Target childTarget;
+    childTarget.tensor = tensorVar;
+    util::append(code, lower(childTarget, childExpr, child, ctx));
+    return code;
+  };
+
+  vector<Stmt> rowBody = computeRow();
+  rowBody.push_back(Store::make(target.tensor, target.ptr, tensorVar));
+
+  vector<Stmt> carryBody = {VarAssign::make(idx, rowEnd, true)};
+  util::append(carryBody, computeRow());
+  carryBody.push_back(Store::make(carryVals, part, tensorVar));
+  ctx.loopRanges.erase(child);
+
+  vector<Stmt> partBody = {
+    VarAssign::make(diag, Min::make({ir::Mul::make(part, partSize),
+                                     Add::make(numRows, nnz)}), true),
+    VarAssign::make(diagEnd, Min::make({Add::make(diag, partSize),
+                                        Add::make(numRows, nnz)}), true)
+  };
+  util::append(partBody, mergePathSearch(diag, numRows, nnz, nonzeros,
+                                         row, nz));
+  util::append(partBody, mergePathSearch(diagEnd, numRows, nnz, nonzeros,
+                                         rowEnd, nzEnd));
+  partBody.push_back(For::make(idx, row, rowEnd, 1, Block::make(rowBody)));
+  partBody.push_back(Store::make(carryRows, part, rowEnd));
+  partBody.push_back(Store::make(carryVals, part, 0.0));
+  partBody.push_back(IfThenElse::make(Lt::make(rowEnd, numRows),
+                                      Block::make(carryBody)));
+
+  // Emit code to add the partial rows to the result
+  Expr resultPtr = Add::make(ir::Mul::make(
+      resultIterator.getParent().getPtrVar(), resultIterator.end()), idx);
+  Stmt addCarry = Block::make({
+    VarAssign::make(resultIterator.getPtrVar(), resultPtr, true),
+    compoundStore(target.tensor, target.ptr, Load::make(carryVals, part))
+  });
+  Stmt fixupBody = Block::make({
+    VarAssign::make(idx, Load::make(carryRows, part), true),
+    IfThenElse::make(Lt::make(idx, numRows), addCarry)
+  });
+
+  Expr numItems = Add::make(numRows, nnz);
+  return {
+    VarAssign::make(nnz, numNonzeros, true),
+    VarAssign::make(partSize, Div::make(Add::make(numItems,
+                                                  NONZERO_PARTITIONS - 1),
+                                        NONZERO_PARTITIONS), true),
+    Allocate::make(carryRows, NONZERO_PARTITIONS),
+    Allocate::make(carryVals, NONZERO_PARTITIONS),
+    For::make(part, 0, NONZERO_PARTITIONS, 1, Block::make(partBody),
+              LoopKind::Parallel),
+    For::make(part, 0, NONZERO_PARTITIONS, 1, fixupBody),
+    Free::make(carryRows),
+    Free::make(carryVals)
+  };
+}
+
 static vector<Stmt> lower(const Target&     target,
                           const taco::Expr& indexExpr,
                           const taco::Var&  indexVar,
                           Context&          ctx) {
+  const Schedule& loopSchedule = ctx.schedule.getTensor().getSchedule();
+  if (loopSchedule.isOuterSplitVar(indexVar)) {
+    return lowerOuterSplitLoop(target, indexExpr, indexVar, ctx);
+  }
+  if (loopSchedule.isParallelNonzeros(indexVar) &&
+      util::contains(ctx.properties, Compute)) {
+    return lowerParallelNonzerosLoop(target, indexExpr, indexVar, ctx);
+  }
+
   vector<Stmt> code;
 //  code.push_back(Comment::make(util::fill(toString(indexVar), '-', 70)));
 
@@ -207,9 +831,41 @@ static vector<Stmt> lower(const Target&     target,
 
   bool emitCompute  = util::contains(ctx.properties, Compute);
   bool emitAssemble = util::contains(ctx.properties, Assemble);
-  bool emitMerge    = needsMerge(lattice);
+  bool emitBitmap   = iteratesBits(lattice);
+  bool emitMerge    = !emitBitmap && needsMerge(lattice);
+
+  // Loops over non-unique levels may visit a coordinate more than once, so
+  // their iterations add to the result
+  for (auto& iterator : latticeIterators) {
+    if (!iterator.isUnique()) {
+      taco_uassert(!emitMerge) << "Cannot merge the non-unique level of " <<
+          iterator.getTensor() << " that is indexed by " << indexVar;
+      for (size_t i = 0; i < resultPath.getSize(); i++) {
+        taco_uassert(ctx.iterators[resultPath.getStep(i)].isDense()) <<
+            "Cannot compute a sparse result from the non-unique level of " <<
+            iterator.getTensor() << " that is indexed by " << indexVar;
+      }
+      ctx.nonUniqueVars.insert(indexVar);
+    }
+  }
+
+  // Values of the workspace's index variable are scattered into the workspace
+  bool emitWorkspace = ctx.workspace.enabled &&
+                       ctx.workspace.indexVar == indexVar;
+
+  // Hashed and bitmap levels are looked up, or iterated in no particular
+  // order or a word at a time, so they cannot be merged
+  for (auto& iterator : latticeIterators) {
+    taco_uassert(!emitMerge || !iterator.isRandomAccess() ||
+                 iterator.isDense()) << "Cannot merge the " <<
+        (iterator.isBitmap() ? "bitmap" : "hashed") << " level of " <<
+        iterator.getTensor() << " that is indexed by " << indexVar;
+  }
 
   // Emit code to initialize pos variables: B2_ptr = B.d2.ptr[B1_pos];
+  // Delta iterators decode the index of their first position before the
+  // loops, and the index of each next position when they are incremented,
+  // since merge loops do not increment every iterator in every iteration.
   if (emitMerge) {
     for (auto& iterator : latticeIterators) {
       Expr ptr = iterator.getPtrVar();
@@ -218,6 +874,11 @@ static vector<Stmt> lower(const Target&     target,
       Expr iteratorVar = iterator.getIteratorVar();
       Stmt iteratorInit = VarAssign::make(iteratorVar, iterator.begin(), true);
       code.push_back(iteratorInit);
+      if (iterator.initDecoder().defined()) {
+        code.push_back(iterator.initDecoder());
+        code.push_back(IfThenElse::make(Lt::make(iteratorVar, iterator.end()),
+                                        iterator.initDerivedVar()));
+      }
     }
   }
 
@@ -233,29 +894,83 @@ static vector<Stmt> lower(const Target&     target,
     vector<Expr> mergeIdxVariables;
     auto sequentialAccessIterators = getSequentialAccessIterators(lpIterators);
     for (Iterator& iterator : sequentialAccessIterators) {
-      Stmt initIdx = iterator.initDerivedVar();
-      loopBody.push_back(initIdx);
+      if (!emitMerge || !iterator.initDecoder().defined()) {
+        Stmt initIdx = iterator.initDerivedVar();
+        loopBody.push_back(initIdx);
+      }
       mergeIdxVariables.push_back(iterator.getIdxVar());
     }
 
+    // A hashed iterator that is iterated, rather than looked up, loads the
+    // index stored in each slot of its table: int jc = c.d1.idx[c1_pos];
+    // Its indices are not ordered, so the result levels they index must be
+    // dense unless the result is scattered into a workspace.
+    Iterator tableIterator;
+    if (!emitMerge && !emitBitmap) {
+      Iterator iter = getIterator(lpIterators);
+      if (iter.isRandomAccess() && !iter.isDense()) {
+        tableIterator = iter;
+        loopBody.push_back(tableIterator.initDerivedVar());
+      }
+    }
+    if (tableIterator.defined() && resultStep.getPath().defined() &&
+        !emitWorkspace) {
+      for (size_t i = resultStep.getStep(); i < resultPath.getSize(); i++) {
+        taco_uassert(ctx.iterators[resultPath.getStep(i)].isDense()) <<
+            "Cannot compute a sparse result from the hashed level of " <<
+            tableIterator.getTensor() << " that is indexed by " << indexVar;
+      }
+    }
+
     // Emit code to initialize the index variable: k = min(kB, kc);
-    Expr idx = (lp.getMergeIterators().size() > 1)
+    Expr idx = (emitBitmap)
+               ? Var::make(indexVar.getName(), Type(Type::Int))
+               : (lp.getMergeIterators().size() > 1)
                ? min(indexVar.getName(), lp.getMergeIterators(), &loopBody)
                : lp.getMergeIterators()[0].getIdxVar();
 
+    // Bitmap loops take the lowest set bit of the word of indices, and locate
+    // the position of its index value in every bitmap:
+    // uint32_t i_bit = i_bits & (0 - i_bits);
+    // int i = (i_word * 32) + popcount(i_bit - 1);
+    // int b1_pos = b.d1.pos[i_word] + popcount(b1_word & (i_bit - 1));
+    auto bitmapIterators = getBitmapIterators(lpIterators);
+    Expr wordVar, bitsVar, bitVar;
+    if (emitBitmap) {
+      wordVar = Var::make(indexVar.getName() + "_word", Type(Type::Int));
+      bitsVar = Var::make(indexVar.getName() + "_bits", Type(Type::UInt, 32));
+      bitVar  = Var::make(indexVar.getName() + "_bit",  Type(Type::UInt, 32));
+      Expr lowestBit = BitAnd::make(bitsVar, ir::Sub::make(0, bitsVar,
+                                                           bitsVar.type()));
+      loopBody.push_back(VarAssign::make(bitVar, lowestBit, true));
+      Expr bitIdx = Popcount::make(ir::Sub::make(bitVar, 1, bitVar.type()));
+      loopBody.push_back(VarAssign::make(idx, ir::Add::make(ir::Mul::make(
+          wordVar, 32), bitIdx), true));
+      for (Iterator& iterator : bitmapIterators) {
+        loopBody.push_back(iterator.locateBit(wordVar, bitVar));
+      }
+    }
+
     // Emit code to initialize random access ptr variables:
     // B2_ptr = (B1_ptr*3) + k;
     auto randomAccessIterators =
         getRandomAccessIterators(util::combine(lpIterators, {resultIterator}));
+    // Hashed iterators probe their tables instead, and the iteration is
+    // skipped if any probe misses, since the intersection is then empty:
+    // if (c.d1.idx[c1_pos] >= 0) { ... }
+    vector<Expr> found;
     for (Iterator& iterator : randomAccessIterators) {
-      Expr val = ir::Add::make(ir::Mul::make(iterator.getParent().getPtrVar(),
-                                             iterator.end()), idx);
-      Stmt initPtr = VarAssign::make(iterator.getPtrVar(), val, true);
-      loopBody.push_back(initPtr);
+      if (iterator != tableIterator && !(emitBitmap && iterator.isBitmap())) {
+        loopBody.push_back(iterator.locate(idx));
+        if (iterator.contains(idx).defined()) {
+          found.push_back(iterator.contains(idx));
+        }
+      }
     }
 
     // Emit one case per lattice point in the sub-lattice rooted at lp
     MergeLattice lpLattice = lattice.getSubLattice(lp);
+    bool emitGallop = emitMerge && canGallop(lp, lpLattice);
     vector<pair<Expr,Stmt>> cases;
     for (MergeLatticePoint& lq : lpLattice) {
       taco::Expr lqExpr = lq.getExpr();
@@ -266,6 +981,14 @@ static vector<Stmt> lower(const Target&     target,
       for (auto& iter : lq.getRangeIterators()) {
         stepIdxEqIdx.push_back(Eq::make(iter.getIdxVar(), idx));
       }
+      // The indices of bitmap loops are in the bitmaps of the case's iterators
+      if (emitBitmap) {
+        stepIdxEqIdx.clear();
+        for (auto& iter : getBitmapIterators(lq.getIterators())) {
+          stepIdxEqIdx.push_back(Neq::make(BitAnd::make(iter.getWordVar(),
+                                                        bitVar), 0));
+        }
+      }
       Expr caseExpr = conjunction(stepIdxEqIdx);
 
       // Case body
@@ -288,10 +1011,10 @@ static vector<Stmt> lower(const Target&     target,
             continue;
           }
 
-          TensorBase t(util::uniqueName("t"), ComponentType::Double);
+          TensorBase t(util::uniqueName("t"), ctx.ctype);
           substitutions.insert({availExpr, taco::Access(t)});
 
-          Expr tensorVar = Var::make(t.getName(), Type(Type::Float,64));
+          Expr tensorVar = Var::make(t.getName(), getValueType(ctx.ctype));
           ctx.temporaries.insert({t, tensorVar});
 
           Expr availIRExpr = lowerToScalarExpression(availExpr, ctx.iterators,
@@ -315,8 +1038,8 @@ static vector<Stmt> lower(const Target&     target,
           }
           case LAST_FREE:
           case BELOW_LAST_FREE: {
-            TensorBase t( "t" + child.getName(), ComponentType::Double);
-            Expr tensorVar = Var::make(t.getName(), Type(Type::Float,64));
+            TensorBase t( "t" + child.getName(), ctx.ctype);
+            Expr tensorVar = Var::make(t.getName(), getValueType(ctx.ctype));
             ctx.temporaries.insert({t, tensorVar});
 
             // Extract the expression to compute at the next level
@@ -349,14 +1072,18 @@ static vector<Stmt> lower(const Target&     target,
             Expr scalarExpr = lowerToScalarExpression(lqExpr, ctx.iterators,
                                                       ctx.schedule,
                                                       ctx.temporaries);
-            if (target.ptr.defined()) {
-              Stmt store = ctx.schedule.hasReductionVariableAncestor(indexVar)
+            if (emitWorkspace) {
+              caseBody.push_back(compoundStore(ctx.workspace.values, idx,
+                                               scalarExpr));
+            }
+            else if (target.ptr.defined()) {
+              Stmt store = hasAccumulatingAncestor(indexVar, ctx)
                   ? compoundStore(target.tensor, target.ptr, scalarExpr)
                   :   Store::make(target.tensor, target.ptr, scalarExpr);
               caseBody.push_back(store);
             }
             else {
-              Stmt assign = ctx.schedule.hasReductionVariableAncestor(indexVar)
+              Stmt assign = hasAccumulatingAncestor(indexVar, ctx)
                   ?  compoundAssign(target.tensor, scalarExpr)
                   : VarAssign::make(target.tensor, scalarExpr);
               caseBody.push_back(assign);
@@ -366,9 +1093,30 @@ static vector<Stmt> lower(const Target&     target,
         }
       }
 
+      // Gather the workspace after the reduction variables below have been
+      // iterated
+      if (ctx.workspace.enabled && ctx.workspace.hasOwner &&
+          ctx.workspace.owner == indexVar) {
+        util::append(caseBody, gatherWorkspace(ctx));
+      }
+
+      // Emit code to record the coordinate in the workspace, unless it has
+      // already been recorded:
+      // if (j_mark[j] == 0) { j_mark[j] = 1; j_list[j_count] = j; j_count++; }
+      if (emitWorkspace) {
+        const Workspace& ws = ctx.workspace;
+        vector<Stmt> record = {Store::make(ws.mark, idx, 1)};
+        if (emitAssemble) {
+          record.push_back(Store::make(ws.list, ws.count, idx));
+        }
+        record.push_back(VarAssign::make(ws.count, Add::make(ws.count, 1)));
+        caseBody.push_back(IfThenElse::make(Eq::make(Load::make(ws.mark, idx),
+                                                     0),
+                                            Block::make(record)));
+      }
       // Emit a store of the index variable value to the result idx index array
       // A.d2.idx[A2_ptr] = j;
-      if (emitAssemble && resultIterator.defined()){
+      else if (emitAssemble && resultIterator.defined()){
         Stmt idxStore = resultIterator.storeIdx(idx);
         if (idxStore.defined()) {
           util::append(caseBody, {idxStore});
@@ -376,7 +1124,8 @@ static vector<Stmt> lower(const Target&     target,
       }
 
       // Emit code to increment the results iterator variable
-      if (resultIterator.defined() && resultIterator.isSequentialAccess()) {
+      if (resultIterator.defined() && resultIterator.isSequentialAccess() &&
+          !emitWorkspace) {
         Expr resultPtr = resultIterator.getPtrVar();
         Stmt ptrInc = VarAssign::make(resultPtr, Add::make(resultPtr, 1));
 
@@ -413,45 +1162,271 @@ static vector<Stmt> lower(const Target&     target,
       }
       cases.push_back({caseExpr, Block::make(caseBody)});
     }
-    loopBody.push_back(needsMerge(lpLattice)
-                       ? Case::make(cases, lpLattice.isFull())
-                       : cases[0].second);
+    Stmt casesStmt = needsMerge(lpLattice)
+                     ? Case::make(cases, lpLattice.isFull())
+                     : cases[0].second;
+    if (!found.empty()) {
+      casesStmt = IfThenElse::make(conjunction(found), casesStmt);
+    }
+    loopBody.push_back(casesStmt);
 
     // Emit code to conditionally increment sequential access ptr variables
+    vector<Stmt> incs;
     if (emitMerge) {
       for (Iterator& iterator : lpIterators) {
         Expr ptr = iterator.getIteratorVar();
         Stmt inc = VarAssign::make(ptr, Add::make(ptr, 1));
+        if (iterator.initDecoder().defined()) {
+          inc = Block::make({inc,
+              IfThenElse::make(Lt::make(ptr, iterator.end()),
+                               iterator.initDerivedVar())});
+        }
         Expr tensorIdx = iterator.getIdxVar();
         Stmt maybeInc = (!iterator.isDense() && iterator.getIdxVar() != idx)
                         ? IfThenElse::make(Eq::make(tensorIdx, idx), inc) : inc;
-        loopBody.push_back(maybeInc);
+        incs.push_back(maybeInc);
+      }
+    }
+
+    // Emit code to choose, before the loop, whether to gallop through the
+    // iterators of an intersection whose sizes are very different:
+    // int k_gallop = (B2_size >= 16*C2_size) || (C2_size >= 16*B2_size);
+    Expr gallopVar;
+    if (emitGallop) {
+      vector<Expr> skewed;
+      for (auto& a : lpIterators) {
+        for (auto& b : lpIterators) {
+          if (a != b) {
+            Expr aSize = ir::Sub::make(a.end(), a.getIteratorVar());
+            Expr bSize = ir::Sub::make(b.end(), b.getIteratorVar());
+            skewed.push_back(Gte::make(aSize, ir::Mul::make(GALLOP_RATIO,
+                                                            bSize)));
+          }
+        }
+      }
+      gallopVar = Var::make(indexVar.getName() + "_gallop", Type(Type::Int));
+      loops.push_back(VarAssign::make(gallopVar, disjunction(skewed), true));
+    }
+
+    // When galloping, iterators whose index is behind skip ahead to the
+    // largest index instead of stepping by one:
+    // if (k_gallop && (kB != k || kC != k)) { <advance to max> } else { <incs> }
+    if (emitGallop) {
+      vector<Expr> idxVars;
+      vector<Expr> mismatches;
+      for (Iterator& iterator : lpIterators) {
+        idxVars.push_back(iterator.getIdxVar());
+        mismatches.push_back(Neq::make(iterator.getIdxVar(), idx));
+      }
+      Expr maxIdx = idxVars[0];
+      for (size_t i = 1; i < idxVars.size(); i++) {
+        maxIdx = Max::make(maxIdx, idxVars[i]);
+      }
+      Expr maxVar = Var::make(indexVar.getName() + "_max", Type(Type::Int));
+
+      vector<Stmt> advances = {VarAssign::make(maxVar, maxIdx, true)};
+      for (Iterator& iterator : lpIterators) {
+        advances.push_back(IfThenElse::make(Lt::make(iterator.getIdxVar(),
+                                                     maxVar),
+                                            iterator.advanceTo(maxVar)));
       }
+      loopBody.push_back(IfThenElse::make(ir::And::make(gallopVar,
+                                                        disjunction(mismatches)),
+                                          Block::make(advances),
+                                          Block::make(incs)));
+    }
+    else {
+      util::append(loopBody, incs);
     }
 
     // Emit loop (while loop for merges and for loop for non-merges)
     Stmt loop;
-    if (emitMerge) {
-      // Loop until any index has been exchaused
+    if (emitBitmap) {
+      taco_uassert(!loopSchedule.isInnerSplitVar(indexVar) &&
+                   !loopSchedule.isParallel(indexVar) &&
+                   !loopSchedule.isVectorized(indexVar)) <<
+          "Cannot split, parallelize or vectorize " << indexVar << " since " <<
+          "its loop iterates over bitmaps";
+
+      // Loop over the words of the bitmaps, and over the set bits of the OR
+      // over lattice points of the AND of their bitmaps' words:
+      // for (int i_word = 0; i_word < 4; i_word++) {
+      //   uint32_t b1_word = b.d1.idx[i_word];
+      //   uint32_t c1_word = c.d1.idx[i_word];
+      //   uint32_t i_bits = (b1_word & c1_word);
+      //   while (i_bits != 0) { ...; i_bits = i_bits - i_bit; }
+      // }
+      vector<Stmt> wordBody;
+      for (Iterator& iterator : bitmapIterators) {
+        wordBody.push_back(iterator.loadWord(wordVar));
+      }
+      vector<Expr> pointBits;
+      for (auto& point : lattice) {
+        auto pointIterators = getBitmapIterators(point.getIterators());
+        Expr bits = pointIterators[0].getWordVar();
+        for (size_t i = 1; i < pointIterators.size(); i++) {
+          bits = BitAnd::make(bits, pointIterators[i].getWordVar());
+        }
+        pointBits.push_back(bits);
+      }
+      Expr bits = pointBits[0];
+      for (size_t i = 1; i < pointBits.size(); i++) {
+        bits = BitOr::make(bits, pointBits[i]);
+      }
+      wordBody.push_back(VarAssign::make(bitsVar, bits, true));
+      loopBody.push_back(VarAssign::make(bitsVar,
+                                         ir::Sub::make(bitsVar, bitVar,
+                                                       bitsVar.type())));
+      wordBody.push_back(While::make(Neq::make(bitsVar, 0),
+                                     Block::make(loopBody)));
+      loops.push_back(For::make(wordVar, bitmapIterators[0].begin(),
+                                bitmapIterators[0].end(), 1,
+                                Block::make(wordBody)));
+
+      // The sub-lattice of the first lattice point is the whole lattice, so
+      // its cases cover all the others
+      break;
+    }
+    else if (emitMerge) {
+      if (loopSchedule.isInnerSplitVar(indexVar)) {
+        taco_uerror << "Cannot split " << loopSchedule.getSplit(indexVar).var
+                    << " since it indexes a sparse dimension";
+      }
+      taco_uassert(!loopSchedule.isParallel(indexVar) &&
+                   !loopSchedule.isVectorized(indexVar)) <<
+          "Cannot parallelize or vectorize " << indexVar << " since its " <<
+          "loop merges sparse dimensions";
+
+      // Loop until any index has been exchaused. Padded segments are
+      // exhausted at their padding if the index is stored to the result, and
+      // empty ones at their first position.
       vector<Expr> stepIterLqEnd;
       for (auto& iter : lp.getRangeIterators()) {
-        stepIterLqEnd.push_back(Lt::make(iter.getIteratorVar(), iter.end()));
+        Expr notEnd = Lt::make(iter.getIteratorVar(), iter.end());
+        if (iter.notPadding().defined() && indexVar.isFree()) {
+          notEnd = ir::And::make(notEnd, iter.notPadding());
+        }
+        else if (iter.notEmpty().defined()) {
+          notEnd = ir::And::make(notEnd, iter.notEmpty());
+        }
+        stepIterLqEnd.push_back(notEnd);
       }
       Expr untilAnyExhausted = conjunction(stepIterLqEnd);
       loop = While::make(untilAnyExhausted, Block::make(loopBody));
     }
     else {
-      bool parallel = ctx.schedule.getAncestors(indexVar).size() == 1 &&
-                      indexVar.isFree();
-      for (size_t i = 0; i < ctx.schedule.getResultTensorPath().getSize(); i++){
-        if (!ctx.iterators[resultPath.getStep(i)].isDense()) {
-          parallel = false;
+      Iterator iter = getIterator(lpIterators);
+      Expr begin = iter.begin();
+      Expr end   = iter.end();
+
+      if (util::contains(ctx.loopRanges, indexVar)) {
+        begin = ctx.loopRanges.at(indexVar).first;
+        end   = ctx.loopRanges.at(indexVar).second;
+      }
+
+      // The inner loop of a split variable iterates over one block:
+      // for (int iB = (i0 * 64); iB < min(((i0 * 64) + 64), N); iB++)
+      if (loopSchedule.isInnerSplitVar(indexVar)) {
+        const Schedule::Split& split = loopSchedule.getSplit(indexVar);
+        taco_uassert(iter.isDense()) << "Cannot split " << split.var <<
+            " since it indexes a sparse dimension";
+        begin = ir::Mul::make(ctx.outerSplitVars.at(split.outer), split.factor);
+        end   = Min::make({ir::Add::make(begin, split.factor), end});
+      }
+
+      // The positions of a delta level are decoded in order from the start of
+      // its segment:
+      // int B2_byte_pos = B2_pos[(B1_pos * 2) + 1];
+      // int jB = 0;
+      if (iter.initDecoder().defined()) {
+        taco_uassert(!util::contains(ctx.loopRanges, indexVar) &&
+                     !loopSchedule.isParallel(indexVar) &&
+                     !loopSchedule.isVectorized(indexVar)) <<
+            "Cannot parallelize or vectorize " << indexVar << " since its " <<
+            "loop decodes the indices of a delta level in order";
+        loops.push_back(iter.initDecoder());
+      }
+
+      // The loop over a singleton level has one iteration, so its body is
+      // emitted with the iterator variable set to the parent's position:
+      // int B2_pos = B1_pos;
+      if (iter.isSingleton() && !loopSchedule.isInnerSplitVar(indexVar) &&
+          !loopSchedule.isParallel(indexVar)) {
+        loops.push_back(VarAssign::make(iter.getIteratorVar(), begin, true));
+        util::append(loops, loopBody);
+        continue;
+      }
+
+      // Innermost loops over dense dimensions are vectorized if their
+      // iterations store to different result locations, or reduce into a
+      // scalar temporary. Reductions over padded segments are vectorized too,
+      // since they are as regular as dense ones and their padding adds zeros,
+      // once the padding of empty segments is masked out.
+      bool vectorizable = ctx.schedule.getChildren(indexVar).empty() &&
+                          !emitWorkspace &&
+                          (indexVar.isFree() || !target.ptr.defined());
+      for (auto& iterator : util::combine(lpIterators, {resultIterator})) {
+        if (iterator.defined() && !iterator.isDense() &&
+            !(iterator.notPadding().defined() && indexVar.isReduction())) {
+          vectorizable = false;
         }
       }
-      Iterator iter = getIterator(lpIterators);
-      LoopKind loopKind = parallel ? LoopKind::Parallel : LoopKind::Serial;
-      loop = For::make(iter.getIteratorVar(), iter.begin(), iter.end(), 1,
-                       Block::make(loopBody), loopKind);
+
+      // The padding of fixed-size segments must be skipped if the index is
+      // stored to the result, since it repeats the last index of the segment:
+      // if (B.d2.idx[B2_ptr] >= 0 &&
+      //     (B2_ptr == i*B.d2.size || B.d2.idx[B2_ptr] != B.d2.idx[B2_ptr-1]))
+      // Otherwise only the positions that store no coordinate, which are the
+      // empty slots of hash tables and the padding of empty segments, are:
+      // if (c.d1.idx[c1_pos] >= 0)
+      if (iter.notPadding().defined() && indexVar.isFree()) {
+        loopBody = {IfThenElse::make(iter.notPadding(),
+                                     Block::make(loopBody))};
+      }
+      else if (iter.notEmpty().defined()) {
+        loopBody = {IfThenElse::make(iter.notEmpty(), Block::make(loopBody))};
+      }
+
+      // Innermost reductions over a sparse dimension into a scalar
+      // temporary are unrolled with partial accumulators
+      bool unroll = emitCompute && !emitAssemble && !iter.isDense() &&
+                    !vectorizable &&
+                    ctx.schedule.getChildren(indexVar).empty() &&
+                    !target.ptr.defined() && lattice.getSize() == 1 &&
+                    !loopSchedule.isInnerSplitVar(indexVar) &&
+                    !loopSchedule.isParallel(indexVar) &&
+                    !loopSchedule.isVectorized(indexVar);
+      if (unroll) {
+        vector<Stmt> unrolled = unrollReduction(iter.getIteratorVar(), begin,
+                                                end, Block::make(loopBody),
+                                                target.tensor);
+        loops.push_back(Block::make(unrolled));
+        continue;
+      }
+
+      // Loops over the components of small dense blocks are fully unrolled,
+      // so that blocks are computed in registers. The variables declared in
+      // the copies of the body are suffixed with the component:
+      // int B4_pos_0 = B4_pos_base + 0; ... int B4_pos_1 = B4_pos_base + 1; ...
+      int blockSize = getBlockSize(iter);
+      if (blockSize > 0 && !util::contains(ctx.loopRanges, indexVar) &&
+          !loopSchedule.isInnerSplitVar(indexVar) &&
+          !loopSchedule.isParallel(indexVar) &&
+          !loopSchedule.isVectorized(indexVar)) {
+        Stmt body = Block::make(loopBody);
+        for (int component = 0; component < blockSize; component++) {
+          ReplaceVars replace;
+          replace.substitutions.insert({iter.getIteratorVar(), component});
+          renameDecls(body, "_" + to_string(component), &replace);
+          loops.push_back(replace.rewrite(body));
+        }
+        continue;
+      }
+
+      LoopKind kind = getLoopKind(indexVar, ctx, vectorizable, iter);
+      loop = For::make(iter.getIteratorVar(), begin, end, 1,
+                       Block::make(loopBody), kind, 0,
+                       getReductionArrays(indexVar, kind, ctx));
     }
     loops.push_back(loop);
   }
@@ -459,7 +1434,7 @@ static vector<Stmt> lower(const Target&     target,
 
   // Emit a store of the  segment size to the result ptr index
   // A.d2.ptr[A1_ptr + 1] = A2_ptr;
-  if (emitAssemble && resultIterator.defined()) {
+  if (emitAssemble && resultIterator.defined() && !emitWorkspace) {
     Stmt ptrStore = resultIterator.storePtr();
     if (ptrStore.defined()) {
       util::append(code, {ptrStore});
@@ -470,29 +1445,52 @@ static vector<Stmt> lower(const Target&     target,
   return code;
 }
 
-Stmt lower(TensorBase tensor, string funcName, set<Property> properties) {
+/// Lower the expression of a tensor into the statements of a function body,
+/// given the IR variables of the tensors it accesses.
+static vector<Stmt> lowerBody(TensorBase tensor,
+                              const map<TensorBase,Expr>& tensorVars,
+                              set<Property> properties) {
   Context ctx;
   ctx.allocSize  = tensor.getAllocSize();
+  ctx.ctype      = tensor.getSchedule().hasAccumulatorType()
+                   ? tensor.getSchedule().getAccumulatorType()
+                   : tensor.getComponentType();
   ctx.properties = properties;
 
-  auto name = tensor.getName();
-  auto vars = tensor.getIndexVars();
-  auto indexExpr = tensor.getExpr();
-
-  // Pack the tensor and it's expression operands into the parameter list
-  vector<Expr> parameters;
-  vector<Expr> results;
-  map<TensorBase,Expr> tensorVars;
-  tie(parameters,results,tensorVars) = getTensorVars(tensor);
-
   // Create the schedule and the iterators of the lowered code
   ctx.schedule = IterationSchedule::make(tensor);
   ctx.iterators = Iterators(ctx.schedule, tensorVars);
+  auto indexExpr = ctx.schedule.getIndexExpr();
+
+  taco_uassert(tensor.getComponentType() != ComponentType::Pattern) <<
+      "Cannot compute " << tensor.getName() << " since it is a pattern " <<
+      "tensor, which has no values";
+
+  // The size of the segments of a fixed-size result level, like the table size
+  // of a hashed one, would have to be known before the result is assembled,
+  // and singleton result levels would need a non-unique level above them
+  for (auto& level : tensor.getFormat().getLevels()) {
+    taco_uassert(level.getType() != DimensionType::Fixed) <<
+        "Cannot compute " << tensor.getName() << " since it has a Fixed " <<
+        "level, whose segment size is not known before it is assembled";
+    taco_uassert(level.getType() != DimensionType::Singleton) <<
+        "Cannot compute " << tensor.getName() << " since it has a " <<
+        "Singleton level";
+    taco_uassert(level.getType() != DimensionType::Bitmap) <<
+        "Cannot compute " << tensor.getName() << " since it has a Bitmap " <<
+        "level";
+    taco_uassert(level.getType() != DimensionType::Delta) <<
+        "Cannot compute " << tensor.getName() << " since it has a Delta " <<
+        "level";
+    taco_uassert(level.getType() != DimensionType::Hashed) <<
+        "Cannot compute " << tensor.getName() << " since it has a Hashed " <<
+        "level, whose table size is not known before it is assembled";
+  }
 
   // Initialize the result ptr variables
   TensorPath resultPath = ctx.schedule.getResultTensorPath();
   vector<Stmt> resultPtrInit;
-  for (auto& indexVar : tensor.getIndexVars()) {
+  for (auto& indexVar : resultPath.getVariables()) {
     Iterator iter = ctx.iterators[resultPath.getStep(indexVar)];
     if (iter.isSequentialAccess()) {
       Expr ptr = iter.getPtrVar();
@@ -503,7 +1501,60 @@ Stmt lower(TensorBase tensor, string funcName, set<Property> properties) {
       resultPtrInit.push_back(iteratorInit);
     }
   }
-  taco_iassert(results.size() == 1) << "An expression can only have one result";
+
+  // Accumulate the result in a workspace if its last level is sparse and is
+  // iterated below reduction variables, since the coordinates of the level
+  // are then not produced in order (e.g. `A(i,j) = B(i,k) * C(k,j)`).
+  vector<Stmt> workspaceInit;
+  vector<Stmt> workspaceFree;
+  if (resultPath.getSize() > 0) {
+    TensorPathStep lastStep = resultPath.getLastStep();
+    taco::Var      lastVar  = resultPath.getVariables().back();
+    Iterator       lastIter = ctx.iterators[lastStep];
+    if (lastIter.isSequentialAccess() &&
+        ctx.schedule.hasReductionVariableAncestor(lastVar)) {
+      Workspace& ws = ctx.workspace;
+      ws.enabled        = true;
+      ws.indexVar       = lastVar;
+      ws.resultIterator = lastIter;
+
+      // The workspace is gathered in the closest free ancestor, which must
+      // be above all the reduction variables
+      vector<taco::Var> ancestors = ctx.schedule.getAncestors(lastVar);
+      for (size_t i = 1; i < ancestors.size(); i++) {
+        if (ancestors[i].isFree()) {
+          ws.hasOwner = true;
+          ws.owner    = ancestors[i];
+          break;
+        }
+      }
+      taco_uassert(!ws.hasOwner ||
+                   !ctx.schedule.hasReductionVariableAncestor(ws.owner)) <<
+          "Cannot compute a sparse result dimension whose free variables " <<
+          "are iterated below reduction variables";
+
+      int dimension = tensor.getFormat().getDimensionOrder()[lastStep.getStep()];
+      ws.size = tensor.getDimensions()[dimension];
+
+      string name = lastVar.getName();
+      ws.mark  = Var::make(name + "_mark", Type(Type::Int), true);
+      ws.count = Var::make(name + "_count", Type(Type::Int));
+      workspaceInit.push_back(Allocate::make(ws.mark, ws.size, false, true));
+      workspaceInit.push_back(VarAssign::make(ws.count, 0, true));
+      workspaceFree.push_back(Free::make(ws.mark));
+      if (util::contains(properties, Compute)) {
+        ws.values = Var::make(name + "_workspace", getValueType(ctx.ctype),
+                              true);
+        workspaceInit.push_back(Allocate::make(ws.values, ws.size, false, true));
+        workspaceFree.push_back(Free::make(ws.values));
+      }
+      if (util::contains(properties, Assemble)) {
+        ws.list = Var::make(name + "_list", Type(Type::Int), true);
+        workspaceInit.push_back(Allocate::make(ws.list, ws.size));
+        workspaceFree.push_back(Free::make(ws.list));
+      }
+    }
+  }
 
   // Lower the iteration schedule
   vector<Stmt> code;
@@ -523,6 +1574,11 @@ Stmt lower(TensorBase tensor, string funcName, set<Property> properties) {
       auto loopNest = lower::lower(target, indexExpr, root, ctx);
       util::append(code, loopNest);
     }
+
+    // A workspace without a free ancestor is gathered after the loop nest
+    if (ctx.workspace.enabled && !ctx.workspace.hasOwner) {
+      util::append(code, gatherWorkspace(ctx));
+    }
   }
   // Lower scalar expressions
   else if (util::contains(properties,Compute)) {
@@ -535,11 +1591,42 @@ Stmt lower(TensorBase tensor, string funcName, set<Property> properties) {
     code.push_back(compute);
   }
 
-  // Create function
   vector<Stmt> body;
   body.insert(body.end(), resultPtrInit.begin(), resultPtrInit.end());
+  body.insert(body.end(), workspaceInit.begin(), workspaceInit.end());
   body.insert(body.end(), code.begin(), code.end());
+  body.insert(body.end(), workspaceFree.begin(), workspaceFree.end());
+  return body;
+}
 
+Stmt lower(TensorBase tensor, string funcName, set<Property> properties) {
+  // Pack the tensor and it's expression operands into the parameter list
+  vector<Expr> parameters;
+  vector<Expr> results;
+  map<TensorBase,Expr> tensorVars;
+  tie(parameters,results,tensorVars) = getTensorVars(tensor);
+  taco_iassert(results.size() == 1) << "An expression can only have one result";
+
+  vector<Stmt> body = lowerBody(tensor, tensorVars, properties);
+  return Function::make(funcName, parameters, results, Block::make(body));
+}
+
+Stmt lower(vector<TensorBase> tensors, string funcName,
+           set<Property> properties) {
+  taco_uassert(tensors.size() > 0) << "No tensors to lower";
+  vector<Expr> parameters;
+  vector<Expr> results;
+  map<TensorBase,Expr> tensorVars;
+  tie(parameters,results,tensorVars) = getTensorVars(tensors);
+
+  // Fuse the code of each expression into the code of the ones before it
+  vector<Stmt> body;
+  for (auto& tensor : tensors) {
+    taco_uassert(tensor.getExpr().defined()) <<
+        "No expression defined for tensor " << tensor.getName();
+    vector<Stmt> code = lowerBody(tensor, tensorVars, properties);
+    body = body.empty() ? code : fuseLoopNests(body, code);
+  }
   return Function::make(funcName, parameters, results, Block::make(body));
 }
 }}
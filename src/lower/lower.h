@@ -3,6 +3,7 @@
 
 #include <string>
 #include <set>
+#include <vector>
 
 #include "taco/expr.h"
 #include "ir/ir.h"
@@ -26,5 +27,11 @@ enum Property {
 ir::Stmt lower(TensorBase tensor, std::string funcName,
                std::set<Property> properties);
 
+/// Lower the expressions of several tensors into one function that evaluates
+/// them all. Loops of the expressions that iterate over the same space are
+/// fused, so that operands they share are traversed once.
+ir::Stmt lower(std::vector<TensorBase> tensors, std::string funcName,
+               std::set<Property> properties);
+
 }}
 #endif
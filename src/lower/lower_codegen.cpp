@@ -22,24 +22,44 @@ std::tuple<std::vector<ir::Expr>,         // parameters
            std::vector<ir::Expr>,         // results
            std::map<TensorBase,ir::Expr>> // mapping
 getTensorVars(const TensorBase& tensor) {
+  return getTensorVars(vector<TensorBase>({tensor}));
+}
+
+std::tuple<std::vector<ir::Expr>,         // parameters
+           std::vector<ir::Expr>,         // results
+           std::map<TensorBase,ir::Expr>> // mapping
+getTensorVars(const vector<TensorBase>& tensors) {
   vector<ir::Expr> parameters;
   vector<ir::Expr> results;
   map<TensorBase, ir::Expr> mapping;
 
-  // Pack result tensor into output parameter list
-  ir::Expr tensorVar = ir::Var::make(tensor.getName(), Type(Type::Float,64),
-                                     tensor.getFormat());
-  mapping.insert({tensor, tensorVar});
-  results.push_back(tensorVar);
+  // Pack result tensors into output parameter list
+  for (const TensorBase& tensor : tensors) {
+    taco_uassert(!util::contains(mapping, tensor)) <<
+        "Tensor " << tensor.getName() << " is computed more than once";
+    ir::Expr tensorVar = ir::Var::make(tensor.getName(),
+                                       getValueType(tensor.getComponentType()),
+                                       tensor.getFormat());
+    mapping.insert({tensor, tensorVar});
+    results.push_back(tensorVar);
+  }
 
   // Pack operand tensors into input parameter list
-  vector<TensorBase> operands = expr_nodes::getOperands(tensor.getExpr());
-  for (TensorBase& operand : operands) {
-    taco_iassert(!util::contains(mapping, operand));
-    ir::Expr operandVar = ir::Var::make(operand.getName(), Type(Type::Float,64),
-                                        operand.getFormat());
-    mapping.insert({operand, operandVar});
-    parameters.push_back(operandVar);
+  for (const TensorBase& tensor : tensors) {
+    vector<TensorBase> operands = expr_nodes::getOperands(tensor.getExpr());
+    for (TensorBase& operand : operands) {
+      if (util::contains(mapping, operand)) {
+        taco_uassert(!util::contains(tensors, operand)) <<
+            "Tensor " << operand.getName() << " is computed by the same " <<
+            "kernel as an expression that reads it";
+        continue;
+      }
+      Type operandType = getValueType(operand.getComponentType());
+      ir::Expr operandVar = ir::Var::make(operand.getName(), operandType,
+                                          operand.getFormat());
+      mapping.insert({operand, operandVar});
+      parameters.push_back(operandVar);
+    }
   }
 
   return std::tuple<std::vector<ir::Expr>, std::vector<ir::Expr>,
@@ -76,6 +96,11 @@ ir::Expr lowerToScalarExpression(const taco::Expr& indexExpr,
         expr = temporaries.at(op->tensor);
         return;
       }
+      // The components of pattern tensors are one and are not loaded
+      if (op->tensor.getComponentType() == ComponentType::Pattern) {
+        expr = ir::Expr(1);
+        return;
+      }
       TensorPath path = schedule.getTensorPath(op);
       storage::Iterator iterator = (op->tensor.getOrder() == 0)
           ? iterators.getRoot(path)
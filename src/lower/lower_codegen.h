@@ -25,6 +25,14 @@ std::tuple<std::vector<ir::Expr>,         // parameters
            std::map<TensorBase,ir::Expr>> // mapping
 getTensorVars(const TensorBase&);
 
+/// Get the IR variables of the results and operands of several tensor
+/// expressions that are evaluated by one function. Operands shared by the
+/// expressions get one variable.
+std::tuple<std::vector<ir::Expr>,         // parameters
+           std::vector<ir::Expr>,         // results
+           std::map<TensorBase,ir::Expr>> // mapping
+getTensorVars(const std::vector<TensorBase>&);
+
 /// Lower an index expression to an IR expression that computes the index
 /// expression for one point in the iteration space (a scalar computation)
 ir::Expr
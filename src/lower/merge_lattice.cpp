@@ -394,9 +394,20 @@ MergeLatticePoint merge(MergeLatticePoint a, MergeLatticePoint b,
   taco_iassert(bMergeIters.size() >= 0 && (bMergeIters.size() == 1 ||
                getDenseIterators(bMergeIters).size() == 0));
 
+  // Hashed iterators are random access but not dense, so in conjunctions they
+  // are looked up at the indices of the other operand rather than merged
+  bool aRandomAccess = aMergeIters[0].isRandomAccess();
+  bool bRandomAccess = bMergeIters[0].isRandomAccess();
+  if (conjunctive && (aRandomAccess != bRandomAccess)) {
+    mergeIters = aRandomAccess ? bMergeIters : aMergeIters;
+  }
+  else if (conjunctive && aRandomAccess && bRandomAccess &&
+           (!aMergeIters[0].isDense() || !bMergeIters[0].isDense())) {
+    mergeIters = !aMergeIters[0].isDense() ? aMergeIters : bMergeIters;
+  }
   // If both merge iterator lists consist of sparse iterators then the result
   // is a union of those lists
-  if (!aMergeIters[0].isDense() && !bMergeIters[0].isDense()) {
+  else if (!aMergeIters[0].isDense() && !bMergeIters[0].isDense()) {
     mergeIters.insert(mergeIters.end(), aMergeIters.begin(), aMergeIters.end());
     mergeIters.insert(mergeIters.end(), bMergeIters.begin(), bMergeIters.end());
   }
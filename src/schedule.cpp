@@ -0,0 +1,184 @@
+#include "taco/schedule.h"
+
+#include <iostream>
+
+#include "taco/error.h"
+#include "taco/util/strings.h"
+#include "taco/util/collections.h"
+
+using namespace std;
+
+namespace taco {
+
+// class Schedule
+Schedule::Schedule() {
+}
+
+void Schedule::reorder(const vector<Var>& order) {
+  taco_uassert(order.size() > 1) << "A loop order needs two or more variables";
+  for (size_t i = 0; i < order.size(); i++) {
+    taco_uassert(!isSplit(order[i])) << "Cannot reorder " << order[i] <<
+        " since it has been split; reorder its outer and inner variables";
+    for (size_t j = 0; j < i; j++) {
+      taco_uassert(order[i] != order[j]) << "Loop order " <<
+          util::join(order) << " has " << order[i] << " more than once";
+    }
+  }
+  orders.push_back(order);
+}
+
+void Schedule::split(Var var, Var outer, Var inner, int factor) {
+  taco_uassert(factor > 0) << "The split factor must be positive";
+  taco_uassert(outer.getKind() == var.getKind() &&
+               inner.getKind() == var.getKind()) <<
+      "The variables " << var << " is split into must be of the same kind " <<
+      "(free or reduction)";
+  taco_uassert(outer != var && inner != var && outer != inner) <<
+      "A variable must be split into two new variables";
+  taco_uassert(!isSplit(var)) << var << " has already been split";
+  for (auto& split : splits) {
+    taco_uassert(split.outer != outer && split.inner != inner &&
+                 split.outer != inner && split.inner != outer) <<
+        "The variables " << var << " is split into are already in use";
+  }
+  for (auto& order : orders) {
+    taco_uassert(!util::contains(order, var)) << "Cannot split " << var <<
+        " since it has been reordered";
+  }
+  splits.push_back({var, outer, inner, factor});
+}
+
+void Schedule::parallelize(Var var) {
+  taco_uassert(!isSplit(var)) << "Cannot parallelize " << var <<
+      " since it has been split; parallelize its outer or inner variable";
+  taco_uassert(!isParallelNonzeros(var)) << "The nonzeros below " << var <<
+      " are already parallelized";
+  if (!util::contains(parallelVars, var)) {
+    parallelVars.push_back(var);
+  }
+}
+
+void Schedule::parallelizeNonzeros(Var var) {
+  taco_uassert(var.isFree()) << "Cannot parallelize " << var <<
+      " since it is a reduction variable";
+  taco_uassert(!isSplit(var)) << "Cannot parallelize the nonzeros below " <<
+      var << " since it has been split";
+  taco_uassert(!isParallel(var)) << var << " is already parallelized";
+  if (!util::contains(parallelNonzeroVars, var)) {
+    parallelNonzeroVars.push_back(var);
+  }
+}
+
+void Schedule::vectorize(Var var) {
+  taco_uassert(!isSplit(var)) << "Cannot vectorize " << var <<
+      " since it has been split; vectorize its outer or inner variable";
+  if (!util::contains(vectorizedVars, var)) {
+    vectorizedVars.push_back(var);
+  }
+}
+
+void Schedule::accumulate(ComponentType ctype) {
+  taco_uassert(ctype != ComponentType::Unknown &&
+               ctype != ComponentType::Pattern) <<
+      "Cannot accumulate in an unknown or pattern component type";
+  accumulatorType = ctype;
+}
+
+const vector<vector<Var>>& Schedule::getOrders() const {
+  return orders;
+}
+
+const vector<Schedule::Split>& Schedule::getSplits() const {
+  return splits;
+}
+
+bool Schedule::isSplit(const Var& var) const {
+  for (auto& split : splits) {
+    if (split.var == var) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Schedule::isOuterSplitVar(const Var& var) const {
+  for (auto& split : splits) {
+    if (split.outer == var) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Schedule::isInnerSplitVar(const Var& var) const {
+  for (auto& split : splits) {
+    if (split.inner == var) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const Schedule::Split& Schedule::getSplit(const Var& var) const {
+  for (auto& split : splits) {
+    if (split.var == var || split.outer == var || split.inner == var) {
+      return split;
+    }
+  }
+  taco_ierror << var << " is not split";
+  return splits[0];
+}
+
+bool Schedule::isParallel(const Var& var) const {
+  return util::contains(parallelVars, var);
+}
+
+bool Schedule::isParallelNonzeros(const Var& var) const {
+  return util::contains(parallelNonzeroVars, var);
+}
+
+bool Schedule::isVectorized(const Var& var) const {
+  return util::contains(vectorizedVars, var);
+}
+
+bool Schedule::hasAccumulatorType() const {
+  return accumulatorType != ComponentType::Unknown;
+}
+
+const ComponentType& Schedule::getAccumulatorType() const {
+  taco_iassert(hasAccumulatorType()) << "No accumulate directive";
+  return accumulatorType;
+}
+
+bool Schedule::hasParallelDirectives() const {
+  return parallelVars.size() > 0 || parallelNonzeroVars.size() > 0;
+}
+
+std::ostream& operator<<(std::ostream& os, const Schedule& schedule) {
+  vector<string> directives;
+  for (auto& order : schedule.orders) {
+    directives.push_back("reorder(" + util::join(order) + ")");
+  }
+  for (auto& split : schedule.splits) {
+    directives.push_back("split(" + util::toString(split.var) + ", " +
+                         util::toString(split.outer) + ", " +
+                         util::toString(split.inner) + ", " +
+                         util::toString(split.factor) + ")");
+  }
+  for (auto& var : schedule.parallelVars) {
+    directives.push_back("parallelize(" + util::toString(var) + ")");
+  }
+  for (auto& var : schedule.parallelNonzeroVars) {
+    directives.push_back("parallelizeNonzeros(" + util::toString(var) + ")");
+  }
+  for (auto& var : schedule.vectorizedVars) {
+    directives.push_back("vectorize(" + util::toString(var) + ")");
+  }
+  if (schedule.hasAccumulatorType()) {
+    directives.push_back("accumulate(" +
+                         util::toString(schedule.accumulatorType) + ")");
+  }
+  return os << util::join(directives, "; ");
+}
+
+}
@@ -0,0 +1,137 @@
+#include "bitmap_iterator.h"
+
+#include "taco/util/strings.h"
+
+using namespace taco::ir;
+
+namespace taco {
+namespace storage {
+
+BitmapIterator::BitmapIterator(std::string name, const Expr& tensor,
+                               int level, size_t dimSize, Iterator previous)
+    : IteratorImpl(previous, tensor) {
+  this->tensor = tensor;
+  this->level = level;
+  this->numWords = (int)((dimSize + 31) / 32);
+
+  std::string tensorName = util::toString(tensor);
+  std::string idxVarName = name + tensorName;
+  ptrVar  = Var::make(tensorName + std::to_string(level+1) + "_pos",
+                      Type(Type::Int));
+  idxVar  = Var::make(idxVarName, Type(Type::Int));
+  wordVar = Var::make(tensorName + std::to_string(level+1) + "_word",
+                      Type(Type::UInt, 32));
+}
+
+bool BitmapIterator::isDense() const {
+  return false;
+}
+
+bool BitmapIterator::isRandomAccess() const {
+  return true;
+}
+
+bool BitmapIterator::isSequentialAccess() const {
+  return false;
+}
+
+bool BitmapIterator::isBitmap() const {
+  return true;
+}
+
+Expr BitmapIterator::getPtrVar() const {
+  return ptrVar;
+}
+
+Expr BitmapIterator::getIdxVar() const {
+  return idxVar;
+}
+
+Expr BitmapIterator::getIteratorVar() const {
+  return ptrVar;
+}
+
+Expr BitmapIterator::begin() const {
+  return 0;
+}
+
+Expr BitmapIterator::end() const {
+  return numWords;
+}
+
+Stmt BitmapIterator::initDerivedVars() const {
+  return Stmt();
+}
+
+ir::Stmt BitmapIterator::storePtr() const {
+  return Stmt();
+}
+
+ir::Stmt BitmapIterator::storeIdx(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Expr BitmapIterator::getPosArr() const {
+  return GetProperty::make(tensor, TensorProperty::Pointer, level);
+}
+
+ir::Expr BitmapIterator::getBitsArr() const {
+  return GetProperty::make(tensor, TensorProperty::Index, level);
+}
+
+ir::Expr BitmapIterator::getWordLoc(ir::Expr word) const {
+  return Add::make(Mul::make(getParent().getPtrVar(), numWords), word);
+}
+
+ir::Stmt BitmapIterator::resizePtrStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt BitmapIterator::resizeIdxStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt BitmapIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Stmt BitmapIterator::locate(ir::Expr idx) const {
+  // The bits above idx are shifted out before counting the set bits below it:
+  // uint32_t b1_word = b.d1.idx[(b0_pos * 4) + (i / 32)];
+  // int b1_pos = b.d1.pos[(b0_pos * 4) + (i / 32)] +
+  //              (popcount(b1_word) - popcount(b1_word >> (i & 31)));
+  Expr word = Div::make(idx, 32);
+  Expr below = Sub::make(Popcount::make(getWordVar()),
+                         Popcount::make(Shr::make(getWordVar(),
+                                                  BitAnd::make(idx, 31))));
+  Stmt load = loadWord(word);
+  Stmt init = VarAssign::make(getPtrVar(),
+                              Add::make(Load::make(getPosArr(),
+                                                   getWordLoc(word)),
+                                        below), true);
+  return Block::make({load, init});
+}
+
+ir::Expr BitmapIterator::contains(ir::Expr idx) const {
+  return Neq::make(BitAnd::make(Shr::make(getWordVar(), BitAnd::make(idx, 31)),
+                                1), 0);
+}
+
+ir::Expr BitmapIterator::getWordVar() const {
+  return wordVar;
+}
+
+ir::Stmt BitmapIterator::loadWord(ir::Expr word) const {
+  return VarAssign::make(getWordVar(),
+                         Load::make(getBitsArr(), getWordLoc(word)), true);
+}
+
+ir::Stmt BitmapIterator::locateBit(ir::Expr word, ir::Expr bit) const {
+  Expr below = Popcount::make(BitAnd::make(getWordVar(),
+                                            Sub::make(bit, 1, bit.type())));
+  return VarAssign::make(getPtrVar(),
+                         Add::make(Load::make(getPosArr(), getWordLoc(word)),
+                                   below), true);
+}
+
+}}
@@ -0,0 +1,72 @@
+#ifndef TACO_STORAGE_BITMAP_H
+#define TACO_STORAGE_BITMAP_H
+
+#include <string>
+
+#include "iterator.h"
+#include "ir/ir.h"
+
+namespace taco {
+namespace storage {
+
+/// An iterator over a level that stores each segment as a bitmap of 32-bit
+/// words (e.g. a moderately sparse vector). Segment k occupies words
+/// [k*W, (k+1)*W) of the bits array, where W is the number of words needed
+/// for the dimension, and the pos array stores the position of the first
+/// index value of each word. The position of an index value is thus the pos of
+/// its word plus the number of set bits below it in the word. Loops over
+/// bitmap levels iterate over words and then over the set bits of each word,
+/// so the begin and end of the iterator are a range of words.
+class BitmapIterator : public IteratorImpl {
+public:
+  BitmapIterator(std::string name, const ir::Expr& tensor, int level,
+                 size_t dimSize, Iterator previous);
+  virtual ~BitmapIterator() {};
+
+  bool isDense() const;
+
+  bool isRandomAccess() const;
+  bool isSequentialAccess() const;
+  bool isBitmap() const;
+
+  ir::Expr getPtrVar() const;
+  ir::Expr getIdxVar() const;
+
+  ir::Expr getIteratorVar() const;
+  ir::Expr begin() const;
+  ir::Expr end() const;
+
+  ir::Stmt initDerivedVars() const;
+
+  ir::Stmt storePtr() const;
+  ir::Stmt storeIdx(ir::Expr idx) const;
+
+  ir::Stmt resizePtrStorage(ir::Expr size) const;
+  ir::Stmt resizeIdxStorage(ir::Expr size) const;
+
+  ir::Stmt advanceTo(ir::Expr idx) const;
+  ir::Stmt locate(ir::Expr idx) const;
+  ir::Expr contains(ir::Expr idx) const;
+
+  ir::Expr getWordVar() const;
+  ir::Stmt loadWord(ir::Expr word) const;
+  ir::Stmt locateBit(ir::Expr word, ir::Expr bit) const;
+
+private:
+  ir::Expr tensor;
+  int level;
+  int numWords;
+
+  ir::Expr ptrVar;
+  ir::Expr idxVar;
+  ir::Expr wordVar;
+
+  ir::Expr getPosArr() const;
+  ir::Expr getBitsArr() const;
+
+  /// Returns the location of the `word`th word of the parent's segment.
+  ir::Expr getWordLoc(ir::Expr word) const;
+};
+
+}}
+#endif
@@ -0,0 +1,140 @@
+#include "delta_iterator.h"
+
+#include "taco/util/strings.h"
+
+using namespace taco::ir;
+
+namespace taco {
+namespace storage {
+
+DeltaIterator::DeltaIterator(std::string name, const Expr& tensor, int level,
+                             Iterator previous)
+    : IteratorImpl(previous, tensor) {
+  this->tensor = tensor;
+  this->level = level;
+
+  // Positions are loaded from the pos array, so they are 64-bit if it is
+  const Var* tensorVar = tensor.as<Var>();
+  Type ptrType = getIndexType(tensorVar->format.getLevels()[level]
+                                 .getPosWidth());
+
+  std::string tensorName = util::toString(tensor);
+  std::string idxVarName = name + tensorName;
+  ptrVar     = Var::make(tensorName + std::to_string(level+1) + "_pos",
+                         ptrType);
+  idxVar     = Var::make(idxVarName, Type(Type::Int));
+  bytePosVar = Var::make(tensorName + std::to_string(level+1) + "_byte_pos",
+                         ptrType);
+}
+
+bool DeltaIterator::isDense() const {
+  return false;
+}
+
+bool DeltaIterator::isRandomAccess() const {
+  return false;
+}
+
+bool DeltaIterator::isSequentialAccess() const {
+  return true;
+}
+
+Expr DeltaIterator::getPtrVar() const {
+  return ptrVar;
+}
+
+Expr DeltaIterator::getIdxVar() const {
+  return idxVar;
+}
+
+Expr DeltaIterator::getIteratorVar() const {
+  return ptrVar;
+}
+
+Expr DeltaIterator::begin() const {
+  return Load::make(getPosArr(), Mul::make(getParent().getPtrVar(), 2));
+}
+
+Expr DeltaIterator::end() const {
+  return Load::make(getPosArr(), Add::make(Mul::make(getParent().getPtrVar(),
+                                                     2), 2));
+}
+
+Stmt DeltaIterator::initDerivedVars() const {
+  // Decode the next variable-byte integer and add it to the previous index:
+  // uint8_t B2_byte = B2_idx[B2_byte_pos];
+  // int B2_delta = B2_byte & 127;
+  // int64_t B2_scale = 128;
+  // while (B2_byte >= 128) {
+  //   B2_byte_pos = B2_byte_pos + 1;
+  //   B2_byte = B2_idx[B2_byte_pos];
+  //   B2_delta = B2_delta + ((B2_byte & 127) * B2_scale);
+  //   B2_scale = B2_scale * 128;
+  // }
+  // B2_byte_pos = B2_byte_pos + 1;
+  // jB = jB + B2_delta;
+  // The scale is 64-bit since it reaches 128^5 after the fifth byte of a
+  // 32-bit delta.
+  std::string prefix = util::toString(tensor) + std::to_string(level+1);
+  Expr byte  = Var::make(prefix + "_byte",  Type(Type::UInt, 8));
+  Expr delta = Var::make(prefix + "_delta", Type(Type::Int));
+  Expr scale = Var::make(prefix + "_scale", Type(Type::Int, 64));
+
+  Stmt nextByte = VarAssign::make(bytePosVar, Add::make(bytePosVar, 1));
+  Stmt loadByte = VarAssign::make(byte, Load::make(getIdxArr(), bytePosVar));
+  Expr lowBits = BitAnd::make(byte, 127);
+  Stmt decodeByte = While::make(Gte::make(byte, 128), Block::make({
+      nextByte,
+      loadByte,
+      VarAssign::make(delta, Add::make(delta, Mul::make(lowBits, scale))),
+      VarAssign::make(scale, Mul::make(scale, 128))
+  }));
+
+  return Block::make({
+      VarAssign::make(byte, Load::make(getIdxArr(), bytePosVar), true),
+      VarAssign::make(delta, lowBits, true),
+      VarAssign::make(scale, 128, true),
+      decodeByte,
+      nextByte,
+      VarAssign::make(getIdxVar(), Add::make(getIdxVar(), delta))
+  });
+}
+
+ir::Stmt DeltaIterator::storePtr() const {
+  return Stmt();
+}
+
+ir::Stmt DeltaIterator::storeIdx(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Expr DeltaIterator::getPosArr() const {
+  return GetProperty::make(tensor, TensorProperty::Pointer, level);
+}
+
+ir::Expr DeltaIterator::getIdxArr() const {
+  return GetProperty::make(tensor, TensorProperty::Index, level);
+}
+
+ir::Stmt DeltaIterator::resizePtrStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt DeltaIterator::resizeIdxStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt DeltaIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Stmt DeltaIterator::initDecoder() const {
+  // int B2_byte_pos = B2_pos[(B1_pos * 2) + 1];
+  // int jB = 0;
+  Expr bytePos = Load::make(getPosArr(),
+                            Add::make(Mul::make(getParent().getPtrVar(), 2), 1));
+  return Block::make({VarAssign::make(bytePosVar, bytePos, true),
+                      VarAssign::make(getIdxVar(), 0, true)});
+}
+
+}}
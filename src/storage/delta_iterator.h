@@ -0,0 +1,64 @@
+#ifndef TACO_STORAGE_DELTA_H
+#define TACO_STORAGE_DELTA_H
+
+#include <string>
+
+#include "iterator.h"
+#include "ir/ir.h"
+
+namespace taco {
+namespace storage {
+
+/// An iterator over a sparse level whose index values are delta-encoded (e.g.
+/// the second level of a CSR matrix of a large graph). Every index value is
+/// stored as its difference from the previous index value of its segment, as
+/// a variable-byte integer of seven bits per byte. The pos array stores the
+/// position of the first index value of each segment followed by the position
+/// of its first byte in the idx array. The index value at each position is
+/// decoded from the previous one, so loops over delta levels must visit their
+/// positions in order, and carry the byte position and the previous index
+/// value from one iteration to the next.
+class DeltaIterator : public IteratorImpl {
+public:
+  DeltaIterator(std::string name, const ir::Expr& tensor, int level,
+                Iterator previous);
+  virtual ~DeltaIterator() {};
+
+  bool isDense() const;
+
+  bool isRandomAccess() const;
+  bool isSequentialAccess() const;
+
+  ir::Expr getPtrVar() const;
+  ir::Expr getIdxVar() const;
+
+  ir::Expr getIteratorVar() const;
+  ir::Expr begin() const;
+  ir::Expr end() const;
+
+  ir::Stmt initDerivedVars() const;
+
+  ir::Stmt storePtr() const;
+  ir::Stmt storeIdx(ir::Expr idx) const;
+
+  ir::Stmt resizePtrStorage(ir::Expr size) const;
+  ir::Stmt resizeIdxStorage(ir::Expr size) const;
+
+  ir::Stmt advanceTo(ir::Expr idx) const;
+
+  ir::Stmt initDecoder() const;
+
+private:
+  ir::Expr tensor;
+  int level;
+
+  ir::Expr ptrVar;
+  ir::Expr idxVar;
+  ir::Expr bytePosVar;
+
+  ir::Expr getPosArr() const;
+  ir::Expr getIdxArr() const;
+};
+
+}}
+#endif
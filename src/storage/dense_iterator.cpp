@@ -14,8 +14,7 @@ DenseIterator::DenseIterator(std::string name, const Expr& tensor, int level,
   this->level = level;
 
   std::string indexVarName = name + util::toString(tensor);
-  ptrVar = Var::make(util::toString(tensor) + std::to_string(level+1)+"_pos",
-                     Type(Type::Int));
+  ptrVar = makePtrVar(level, "_pos");
   idxVar = Var::make(indexVarName, Type(Type::Int));
 
   this->dimSize = (int)dimSize;
@@ -76,4 +75,13 @@ ir::Stmt DenseIterator::resizeIdxStorage(ir::Expr size) const {
   return Stmt();
 }
 
+ir::Stmt DenseIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Stmt DenseIterator::locate(ir::Expr idx) const {
+  Expr ptrVal = Add::make(Mul::make(getParent().getPtrVar(), end()), idx);
+  return VarAssign::make(getPtrVar(), ptrVal, true);
+}
+
 }}
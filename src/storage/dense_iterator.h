@@ -35,6 +35,9 @@ public:
   ir::Stmt resizePtrStorage(ir::Expr size) const;
   ir::Stmt resizeIdxStorage(ir::Expr size) const;
 
+  ir::Stmt advanceTo(ir::Expr idx) const;
+  ir::Stmt locate(ir::Expr idx) const;
+
 private:
   ir::Expr tensor;
   int level;
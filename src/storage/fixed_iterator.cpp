@@ -8,17 +8,14 @@ namespace taco {
 namespace storage {
 
 FixedIterator::FixedIterator(std::string name, const Expr& tensor, int level,
-                             size_t fixedSize, Iterator previous)
+                             Iterator previous)
     : IteratorImpl(previous, tensor) {
   this->tensor = tensor;
   this->level = level;
 
   std::string idxVarName = name + util::toString(tensor);
-  ptrVar = Var::make(util::toString(tensor) + std::to_string(level+1)+"_ptr",
-                     Type(Type::Int));
+  ptrVar = makePtrVar(level, "_ptr");
   idxVar = Var::make(idxVarName,Type(Type::Int));
-
-  this->fixedSize = (int)fixedSize;
 }
 
 bool FixedIterator::isDense() const {
@@ -46,17 +43,16 @@ Expr FixedIterator::getIteratorVar() const {
 }
 
 Expr FixedIterator::begin() const {
-  return 0;
+  return Mul::make(getParent().getPtrVar(), getPtrArr());
 }
 
 Expr FixedIterator::end() const {
-  return fixedSize;
+  return Mul::make(Add::make(getParent().getPtrVar(), 1), getPtrArr());
 }
 
 Stmt FixedIterator::initDerivedVars() const {
-  Expr ptrVal = Add::make(Mul::make(getParent().getPtrVar(), end()),
-                          getIdxVar());
-  return VarAssign::make(getIdxVar(), ptrVal);
+  return VarAssign::make(getIdxVar(), Load::make(getIdxArr(), getPtrVar()),
+                         true);
 }
 
 ir::Stmt FixedIterator::storePtr() const {
@@ -83,4 +79,24 @@ ir::Stmt FixedIterator::resizeIdxStorage(ir::Expr size) const {
   return Allocate::make(getIdxArr(), size, true);
 }
 
+ir::Stmt FixedIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Expr FixedIterator::notPadding() const {
+  // Coordinates are unique within a segment, so padding starts at the first
+  // position whose index repeats the index before it. Empty segments are all
+  // padding, with index -1.
+  Expr ptr = getPtrVar();
+  return And::make(notEmpty(),
+                   Or::make(Eq::make(ptr, begin()),
+                            Neq::make(Load::make(getIdxArr(), ptr),
+                                      Load::make(getIdxArr(),
+                                                 Sub::make(ptr, 1)))));
+}
+
+ir::Expr FixedIterator::notEmpty() const {
+  return Gte::make(Load::make(getIdxArr(), getPtrVar()), 0);
+}
+
 }}
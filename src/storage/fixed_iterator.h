@@ -9,10 +9,15 @@
 namespace taco {
 namespace storage {
 
+/// An iterator over a level whose segments all have the same size (e.g. the
+/// second level of ELL). The size is stored in the level's ptr array, so
+/// segment k occupies positions [k*size, (k+1)*size) of the idx array.
+/// Segments with fewer coordinates are padded by repeating their last index,
+/// with zeros stored below the padding.
 class FixedIterator : public IteratorImpl {
 public:
   FixedIterator(std::string name, const ir::Expr& tensor, int level,
-                size_t fixedSize, Iterator previous);
+                Iterator previous);
   virtual ~FixedIterator() {};
 
   bool isDense() const;
@@ -35,6 +40,10 @@ public:
   ir::Stmt resizePtrStorage(ir::Expr size) const;
   ir::Stmt resizeIdxStorage(ir::Expr size) const;
 
+  ir::Stmt advanceTo(ir::Expr idx) const;
+  ir::Expr notPadding() const;
+  ir::Expr notEmpty() const;
+
 private:
   ir::Expr tensor;
   int level;
@@ -44,8 +53,6 @@ private:
 
   ir::Expr getPtrArr() const;
   ir::Expr getIdxArr() const;
-
-  ir::Expr fixedSize;
 };
 
 }}
@@ -0,0 +1,116 @@
+#include "hashed_iterator.h"
+
+#include "taco/util/strings.h"
+
+using namespace taco::ir;
+
+namespace taco {
+namespace storage {
+
+HashedIterator::HashedIterator(std::string name, const Expr& tensor,
+                               int level, Iterator previous)
+    : IteratorImpl(previous, tensor) {
+  this->tensor = tensor;
+  this->level = level;
+
+  std::string idxVarName = name + util::toString(tensor);
+  ptrVar = makePtrVar(level, "_pos");
+  idxVar = Var::make(idxVarName, Type(Type::Int));
+}
+
+bool HashedIterator::isDense() const {
+  return false;
+}
+
+bool HashedIterator::isRandomAccess() const {
+  return true;
+}
+
+bool HashedIterator::isSequentialAccess() const {
+  return false;
+}
+
+Expr HashedIterator::getPtrVar() const {
+  return ptrVar;
+}
+
+Expr HashedIterator::getIdxVar() const {
+  return idxVar;
+}
+
+Expr HashedIterator::getIteratorVar() const {
+  return ptrVar;
+}
+
+Expr HashedIterator::begin() const {
+  return Mul::make(getParent().getPtrVar(), getPtrArr());
+}
+
+Expr HashedIterator::end() const {
+  return Mul::make(Add::make(getParent().getPtrVar(), 1), getPtrArr());
+}
+
+Stmt HashedIterator::initDerivedVars() const {
+  return VarAssign::make(getIdxVar(), Load::make(getIdxArr(), getPtrVar()),
+                         true);
+}
+
+ir::Stmt HashedIterator::storePtr() const {
+  return Stmt();
+}
+
+ir::Stmt HashedIterator::storeIdx(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Expr HashedIterator::getPtrArr() const {
+  return GetProperty::make(tensor, TensorProperty::Pointer, level);
+}
+
+ir::Expr HashedIterator::getIdxArr() const {
+  return GetProperty::make(tensor, TensorProperty::Index, level);
+}
+
+ir::Stmt HashedIterator::resizePtrStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt HashedIterator::resizeIdxStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt HashedIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
+ir::Expr HashedIterator::notEmpty() const {
+  return Gte::make(Load::make(getIdxArr(), getPtrVar()), 0);
+}
+
+ir::Stmt HashedIterator::locate(ir::Expr idx) const {
+  // Probe from the slot given by the low bits of idx until the slot stores
+  // idx or is empty:
+  // int c1_pos = (c0_pos * c1_size) + (j & (c1_size - 1));
+  // while (c.d1.idx[c1_pos] != j && c.d1.idx[c1_pos] >= 0) {
+  //   c1_pos = (c0_pos * c1_size) +
+  //            (((c1_pos - (c0_pos * c1_size)) + 1) & (c1_size - 1));
+  // }
+  Expr ptr  = getPtrVar();
+  Expr mask = Sub::make(getPtrArr(), 1);
+  Expr slot = Load::make(getIdxArr(), ptr);
+  Stmt init = VarAssign::make(ptr, Add::make(begin(), BitAnd::make(idx, mask)),
+                              true);
+  Expr next = Add::make(begin(),
+                        BitAnd::make(Add::make(Sub::make(ptr, begin()), 1),
+                                     mask));
+  Stmt probe = While::make(And::make(Neq::make(slot, idx), Gte::make(slot, 0)),
+                           VarAssign::make(ptr, next));
+  return Block::make({init, probe});
+}
+
+ir::Expr HashedIterator::contains(ir::Expr idx) const {
+  // Probes stop at the slot that stores idx or at an empty slot
+  return notEmpty();
+}
+
+}}
@@ -0,0 +1,61 @@
+#ifndef TACO_STORAGE_HASHED_H
+#define TACO_STORAGE_HASHED_H
+
+#include <string>
+
+#include "iterator.h"
+#include "ir/ir.h"
+
+namespace taco {
+namespace storage {
+
+/// An iterator over a level that stores each segment in a hash table (e.g. a
+/// sparse vector of a huge dimension). The tables all have the same number of
+/// slots, a power of two stored in the level's ptr array, so segment k
+/// occupies positions [k*size, (k+1)*size) of the idx array. An index is
+/// stored at the first empty slot from its low bits (linear probing), and
+/// empty slots store -1 with zeros below them. Tables are at most half full.
+class HashedIterator : public IteratorImpl {
+public:
+  HashedIterator(std::string name, const ir::Expr& tensor, int level,
+                 Iterator previous);
+  virtual ~HashedIterator() {};
+
+  bool isDense() const;
+
+  bool isRandomAccess() const;
+  bool isSequentialAccess() const;
+
+  ir::Expr getPtrVar() const;
+  ir::Expr getIdxVar() const;
+
+  ir::Expr getIteratorVar() const;
+  ir::Expr begin() const;
+  ir::Expr end() const;
+
+  ir::Stmt initDerivedVars() const;
+
+  ir::Stmt storePtr() const;
+  ir::Stmt storeIdx(ir::Expr idx) const;
+
+  ir::Stmt resizePtrStorage(ir::Expr size) const;
+  ir::Stmt resizeIdxStorage(ir::Expr size) const;
+
+  ir::Stmt advanceTo(ir::Expr idx) const;
+  ir::Expr notEmpty() const;
+  ir::Stmt locate(ir::Expr idx) const;
+  ir::Expr contains(ir::Expr idx) const;
+
+private:
+  ir::Expr tensor;
+  int level;
+
+  ir::Expr ptrVar;
+  ir::Expr idxVar;
+
+  ir::Expr getPtrArr() const;
+  ir::Expr getIdxArr() const;
+};
+
+}}
+#endif
@@ -4,6 +4,10 @@
 #include "dense_iterator.h"
 #include "sparse_iterator.h"
 #include "fixed_iterator.h"
+#include "singleton_iterator.h"
+#include "hashed_iterator.h"
+#include "bitmap_iterator.h"
+#include "delta_iterator.h"
 
 #include "taco/tensor.h"
 #include "taco/expr.h"
@@ -40,15 +44,39 @@ Iterator Iterator::make(string name, const ir::Expr& tensorVar,
       break;
     }
     case DimensionType::Sparse: {
+      auto& levels = tensor.getFormat().getLevels();
+      bool unique = (size_t)dim + 1 == levels.size() ||
+                    levels[dim + 1].getType() != DimensionType::Singleton;
       iterator.iterator =
-          std::make_shared<SparseIterator>(name, tensorVar, dim, parent);
+          std::make_shared<SparseIterator>(name, tensorVar, dim, unique,
+                                           parent);
       break;
     }
     case DimensionType::Fixed: {
-      int fixedSize = tensor.getStorage().getDimensionIndex(dim)[0][0];
       iterator.iterator =
-          std::make_shared<FixedIterator>(name, tensorVar, dim, fixedSize,
-                                          parent);
+          std::make_shared<FixedIterator>(name, tensorVar, dim, parent);
+      break;
+    }
+    case DimensionType::Singleton: {
+      iterator.iterator =
+          std::make_shared<SingletonIterator>(name, tensorVar, dim, parent);
+      break;
+    }
+    case DimensionType::Hashed: {
+      iterator.iterator =
+          std::make_shared<HashedIterator>(name, tensorVar, dim, parent);
+      break;
+    }
+    case DimensionType::Bitmap: {
+      size_t dimSize = tensor.getDimensions()[dimOrder];
+      iterator.iterator =
+          std::make_shared<BitmapIterator>(name, tensorVar, dim, dimSize,
+                                           parent);
+      break;
+    }
+    case DimensionType::Delta: {
+      iterator.iterator =
+          std::make_shared<DeltaIterator>(name, tensorVar, dim, parent);
       break;
     }
   }
@@ -74,6 +102,21 @@ bool Iterator::isSequentialAccess() const {
   return iterator->isSequentialAccess();
 }
 
+bool Iterator::isUnique() const {
+  taco_iassert(defined());
+  return iterator->isUnique();
+}
+
+bool Iterator::isSingleton() const {
+  taco_iassert(defined());
+  return iterator->isSingleton();
+}
+
+bool Iterator::isBitmap() const {
+  taco_iassert(defined());
+  return iterator->isBitmap();
+}
+
 ir::Expr Iterator::getTensor() const {
   taco_iassert(defined());
   return iterator->getTensor();
@@ -129,6 +172,51 @@ ir::Stmt Iterator::resizeIdxStorage(ir::Expr size) const {
   return iterator->resizeIdxStorage(size);
 }
 
+ir::Stmt Iterator::advanceTo(ir::Expr idx) const {
+  taco_iassert(defined());
+  return iterator->advanceTo(idx);
+}
+
+ir::Expr Iterator::notPadding() const {
+  taco_iassert(defined());
+  return iterator->notPadding();
+}
+
+ir::Expr Iterator::notEmpty() const {
+  taco_iassert(defined());
+  return iterator->notEmpty();
+}
+
+ir::Stmt Iterator::locate(ir::Expr idx) const {
+  taco_iassert(defined());
+  return iterator->locate(idx);
+}
+
+ir::Expr Iterator::contains(ir::Expr idx) const {
+  taco_iassert(defined());
+  return iterator->contains(idx);
+}
+
+ir::Expr Iterator::getWordVar() const {
+  taco_iassert(defined());
+  return iterator->getWordVar();
+}
+
+ir::Stmt Iterator::loadWord(ir::Expr word) const {
+  taco_iassert(defined());
+  return iterator->loadWord(word);
+}
+
+ir::Stmt Iterator::locateBit(ir::Expr word, ir::Expr bit) const {
+  taco_iassert(defined());
+  return iterator->locateBit(word, bit);
+}
+
+ir::Stmt Iterator::initDecoder() const {
+  taco_iassert(defined());
+  return iterator->initDecoder();
+}
+
 bool Iterator::defined() const {
   return iterator != nullptr;
 }
@@ -157,6 +245,50 @@ IteratorImpl::IteratorImpl(Iterator parent, ir::Expr tensor) :
 IteratorImpl::~IteratorImpl() {
 }
 
+bool IteratorImpl::isUnique() const {
+  return true;
+}
+
+bool IteratorImpl::isSingleton() const {
+  return false;
+}
+
+bool IteratorImpl::isBitmap() const {
+  return false;
+}
+
+ir::Expr IteratorImpl::notPadding() const {
+  return ir::Expr();
+}
+
+ir::Expr IteratorImpl::notEmpty() const {
+  return ir::Expr();
+}
+
+ir::Stmt IteratorImpl::locate(ir::Expr idx) const {
+  return ir::Stmt();
+}
+
+ir::Expr IteratorImpl::contains(ir::Expr idx) const {
+  return ir::Expr();
+}
+
+ir::Expr IteratorImpl::getWordVar() const {
+  return ir::Expr();
+}
+
+ir::Stmt IteratorImpl::loadWord(ir::Expr word) const {
+  return ir::Stmt();
+}
+
+ir::Stmt IteratorImpl::locateBit(ir::Expr word, ir::Expr bit) const {
+  return ir::Stmt();
+}
+
+ir::Stmt IteratorImpl::initDecoder() const {
+  return ir::Stmt();
+}
+
 std::string IteratorImpl::getName() const {
   return util::toString(tensor);
 }
@@ -169,6 +301,11 @@ const ir::Expr& IteratorImpl::getTensor() const {
   return tensor;
 }
 
+ir::Expr IteratorImpl::makePtrVar(int level, std::string suffix) const {
+  return ir::Var::make(util::toString(tensor) + to_string(level+1) + suffix,
+                       parent.getPtrVar().type());
+}
+
 std::ostream& operator<<(std::ostream& os, const IteratorImpl& iterator) {
   return os << iterator.getName();
 }
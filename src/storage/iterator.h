@@ -45,6 +45,21 @@ public:
   /// Returns true if the iterator supports sequential access
   bool isSequentialAccess() const;
 
+  /// Returns true if the coordinates of each segment of the iterator's level
+  /// are unique. A sparse level above a singleton level stores the coordinate
+  /// of every entry below it, so its coordinates repeat.
+  bool isUnique() const;
+
+  /// Returns true if the iterator's level stores one coordinate per position
+  /// of its parent level (e.g. the second level of COO), so that its loops
+  /// have one iteration.
+  bool isSingleton() const;
+
+  /// Returns true if the iterator's level stores each segment as a bitmap, so
+  /// that its loops iterate over the set bits of the bitmap's words. The
+  /// iterator's begin and end are then the range of words of a segment.
+  bool isBitmap() const;
+
   /// Returns the ptr variable for this iterator (e.g. `ja_ptr`). Ptr variables
   /// are used to index into the data at the next level (as well as the index
   /// arrays for formats such as sparse that have them).
@@ -81,6 +96,63 @@ public:
 
   ir::Stmt resizeIdxStorage(ir::Expr size) const;
 
+  /// Returns a statement that advances the iterator variable to the first
+  /// position whose index is not smaller than `idx`, or to the end if there is
+  /// none. Sparse iterators search by galloping (doubling the step and then
+  /// binary searching), so skipping over a long run of indices takes time
+  /// logarithmic in its length. Returns an undefined statement if the iterator
+  /// cannot be advanced this way.
+  ir::Stmt advanceTo(ir::Expr idx) const;
+
+  /// Returns an expression that is true iff the iterator variable is not at
+  /// padding appended to fill its segment to a fixed size, or an undefined
+  /// expression if the level is not padded. Padding repeats the last index of
+  /// its segment and holds zeros, so it only needs to be skipped where the
+  /// repeated index would be stored to the result more than once. The padding
+  /// of empty segments stores no coordinate, so it is not notEmpty() either.
+  ir::Expr notPadding() const;
+
+  /// Returns an expression that is true iff the iterator variable is at a
+  /// position that stores a coordinate, or an undefined expression if every
+  /// position does. The empty slots of hash tables and the padding of empty
+  /// fixed-size segments store no coordinate, so they must be skipped
+  /// wherever the level is iterated.
+  ir::Expr notEmpty() const;
+
+  /// Returns a statement that declares the ptr variable of a random access
+  /// iterator and sets it to the position of `idx` in the parent's segment,
+  /// or an undefined statement if the iterator is not random access. Hashed
+  /// iterators probe their table, and an index that is not stored is located
+  /// at an empty slot, below which everything is zero.
+  ir::Stmt locate(ir::Expr idx) const;
+
+  /// Returns an expression that is true iff `idx` is stored in the parent's
+  /// segment, after `locate(idx)`, or an undefined expression if every index
+  /// is (dense levels).
+  ir::Expr contains(ir::Expr idx) const;
+
+  /// Returns the variable that holds the current word of a bitmap iterator.
+  ir::Expr getWordVar() const;
+
+  /// Returns a statement that declares the word variable of a bitmap iterator
+  /// and loads the `word`th word of the parent's segment into it.
+  ir::Stmt loadWord(ir::Expr word) const;
+
+  /// Returns a statement that declares the ptr variable of a bitmap iterator
+  /// and sets it to the position of the index value given by `bit`, a mask
+  /// with one set bit of the `word`th word of the parent's segment:
+  /// int b1_pos = b.d1.pos[(b0_pos * 4) + i_word] + popcount(b1_word & (i_bit - 1));
+  ir::Stmt locateBit(ir::Expr word, ir::Expr bit) const;
+
+  /// Returns a statement that declares the variables a delta iterator carries
+  /// from one iteration of its loops to the next, before the loop over a
+  /// segment, or an undefined statement if the iterator carries none. Delta
+  /// iterators decode the index variable from its previous value in
+  /// `initDerivedVar`, which must thus be emitted once per position in order:
+  /// int B2_byte_pos = B2_pos[(B1_pos * 2) + 1];
+  /// int jB = 0;
+  ir::Stmt initDecoder() const;
+
   /// Returns true if the iterator is defined, false otherwise.
   bool defined() const;
 
@@ -108,6 +180,9 @@ public:
 
   virtual bool isRandomAccess() const                    = 0;
   virtual bool isSequentialAccess() const                = 0;
+  virtual bool isUnique() const;
+  virtual bool isSingleton() const;
+  virtual bool isBitmap() const;
 
   virtual ir::Expr getPtrVar() const                     = 0;
   virtual ir::Expr getIdxVar() const                     = 0;
@@ -123,6 +198,24 @@ public:
 
   virtual ir::Stmt resizePtrStorage(ir::Expr size) const = 0;
   virtual ir::Stmt resizeIdxStorage(ir::Expr size) const = 0;
+  virtual ir::Stmt advanceTo(ir::Expr idx) const         = 0;
+  virtual ir::Expr notPadding() const;
+  virtual ir::Expr notEmpty() const;
+  virtual ir::Stmt locate(ir::Expr idx) const;
+  virtual ir::Expr contains(ir::Expr idx) const;
+
+  virtual ir::Expr getWordVar() const;
+  virtual ir::Stmt loadWord(ir::Expr word) const;
+  virtual ir::Stmt locateBit(ir::Expr word, ir::Expr bit) const;
+
+  virtual ir::Stmt initDecoder() const;
+
+protected:
+  /// Returns the position variable of the iterator over `level`, named from
+  /// the tensor, level and `suffix` (e.g. B2_pos). It is for levels whose
+  /// positions are computed from the parent's positions, so it is as wide as
+  /// the parent's position variable.
+  ir::Expr makePtrVar(int level, std::string suffix) const;
 
 private:
   Iterator parent;
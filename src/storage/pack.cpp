@@ -1,5 +1,9 @@
 #include "taco/storage/pack.h"
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
 #include "taco/format.h"
 #include "taco/error.h"
 #include "ir/ir.h"
@@ -32,23 +36,23 @@ static vector<size_t> getUniqueEntries(const vector<int>::const_iterator& begin,
 
 #define PACK_NEXT_LEVEL(cend) { \
     if (i + 1 == dimTypes.size()) { \
-      values->push_back((cbegin < cend) ? vals[cbegin] : 0.0); \
+      values->push_back((cbegin < cend) ? (int64_t)cbegin : -1); \
     } else { \
-      packTensor(dims, coords, vals, cbegin, (cend), dimTypes, i+1, \
+      packTensor(dims, coords, cbegin, (cend), dimTypes, i+1, \
                  indices, values); \
     } \
 }
 
 /// Pack tensor coordinates into an index structure and value array.  The
 /// indices consist of one index per tensor dimension, and each index contains
-/// [0,2] index arrays.
+/// [0,2] index arrays.  The value array holds the position in the coordinate
+/// list of each value, or -1 for the zeros stored by dense levels.
 static void packTensor(const vector<int>& dims,
                        const vector<vector<int>>& coords,
-                       const double* vals,
                        size_t begin, size_t end,
                        const vector<DimensionType>& dimTypes, size_t i,
-                       std::vector<std::vector<std::vector<int>>>* indices,
-                       vector<double>* values) {
+                       vector<vector<vector<int64_t>>>* indices,
+                       vector<int64_t>* values) {
   auto& dimType     = dimTypes[i];
   auto& levelCoords = coords[i];
   auto& index       = (*indices)[i];
@@ -69,12 +73,24 @@ static void packTensor(const vector<int>& dims,
       break;
     }
     case Sparse: {
+      // A sparse level above a singleton level stores the coordinate of every
+      // entry, and each entry is packed into its own segment below
+      if (i + 1 < dimTypes.size() && dimTypes[i + 1] == Singleton) {
+        index[0].push_back(index[1].size() + (end - begin));
+        index[1].insert(index[1].end(), levelCoords.begin()+begin,
+                        levelCoords.begin()+end);
+        for (size_t cbegin = begin; cbegin < end; cbegin++) {
+          PACK_NEXT_LEVEL(cbegin + 1);
+        }
+        break;
+      }
+
       auto indexValues = getUniqueEntries(levelCoords.begin()+begin,
                                           levelCoords.begin()+end);
 
       // Store segment end: the size of the stored segment is the number of
       // unique values in the coordinate list
-      index[0].push_back((int)(index[1].size() + indexValues.size()));
+      index[0].push_back(index[1].size() + indexValues.size());
 
       // Store unique index values for this segment
       index[1].insert(index[1].end(), indexValues.begin(), indexValues.end());
@@ -114,17 +130,161 @@ static void packTensor(const vector<int>& dims,
           cbegin = cend;
         }
       }
-      // Complete index if necessary with the last index value
+      // Complete index if necessary with the last index value. Empty
+      // segments store no index value, so they are padded with -1.
       auto curSize=segmentSize;
       while (curSize < fixedValue) {
-        index[1].insert(index[1].end(), 
-                        (segmentSize > 0) ? indexValues[segmentSize-1] : 0);
+        index[1].insert(index[1].end(),
+                        (segmentSize > 0) ? (int)indexValues[segmentSize-1]
+                                          : -1);
         PACK_NEXT_LEVEL(cbegin);
         curSize++;
       }
       break;
     }
+    case Hashed: {
+      int capacity = index[0][0];
+      auto indexValues = getUniqueEntries(levelCoords.begin()+begin,
+                                          levelCoords.begin()+end);
+
+      // Insert the unique index values into a table by linear probing from
+      // the slot given by their low bits
+      vector<int> slots(capacity, -1);
+      for (size_t k = 0; k < indexValues.size(); k++) {
+        int slot = (int)indexValues[k] & (capacity - 1);
+        while (slots[slot] != -1) {
+          slot = (slot + 1) & (capacity - 1);
+        }
+        slots[slot] = (int)k;
+      }
+
+      // Find the segment range of the children of each index value
+      vector<size_t> childBegins = {begin};
+      for (size_t j : indexValues) {
+        size_t cend = childBegins.back();
+        while (cend < end && levelCoords[cend] == (int)j) {
+          cend++;
+        }
+        childBegins.push_back(cend);
+      }
+
+      // Store the table. Empty slots have index -1 and empty segments below,
+      // so that lookups of missing index values read zeros.
+      for (int slot = 0; slot < capacity; slot++) {
+        if (slots[slot] == -1) {
+          index[1].push_back(-1);
+          size_t cbegin = end;
+          PACK_NEXT_LEVEL(end);
+        }
+        else {
+          size_t k = slots[slot];
+          index[1].push_back((int)indexValues[k]);
+          size_t cbegin = childBegins[k];
+          PACK_NEXT_LEVEL(childBegins[k+1]);
+        }
+      }
+      break;
+    }
+    case Bitmap: {
+      auto indexValues = getUniqueEntries(levelCoords.begin()+begin,
+                                          levelCoords.begin()+end);
+
+      // Store one bit per index value in 32-bit words, and the position of
+      // the first index value of each word
+      int numWords = (dims[i] + 31) / 32;
+      vector<uint32_t> words(numWords, 0);
+      for (size_t j : indexValues) {
+        words[j / 32] |= 1u << (j % 32);
+      }
+      for (uint32_t word : words) {
+        index[1].push_back(index[1].back() + __builtin_popcount(word));
+        index[2].push_back((int32_t)word);
+      }
+
+      // Iterate over each index value and recursively pack it's segment
+      size_t cbegin = begin;
+      for (size_t j : indexValues) {
+        size_t cend = cbegin;
+        while (cend < end && levelCoords[cend] == (int)j) {
+          cend++;
+        }
+        PACK_NEXT_LEVEL(cend);
+        cbegin = cend;
+      }
+      break;
+    }
+    case Delta: {
+      auto indexValues = getUniqueEntries(levelCoords.begin()+begin,
+                                          levelCoords.begin()+end);
+
+      // Store each index value as its difference from the previous one, in
+      // little-endian groups of seven bits with the high bit of every byte
+      // but the last set
+      size_t prev = 0;
+      for (size_t j : indexValues) {
+        size_t delta = j - prev;
+        while (delta >= 128) {
+          index[1].push_back((delta & 127) | 128);
+          delta >>= 7;
+        }
+        index[1].push_back(delta);
+        prev = j;
+      }
+
+      // Store the segment end and the end of its bytes
+      index[0].push_back(index[0][index[0].size() - 2] + indexValues.size());
+      index[0].push_back(index[1].size());
+
+      // Iterate over each index value and recursively pack it's segment
+      size_t cbegin = begin;
+      for (size_t j : indexValues) {
+        size_t cend = cbegin;
+        while (cend < end && levelCoords[cend] == (int)j) {
+          cend++;
+        }
+        PACK_NEXT_LEVEL(cend);
+        cbegin = cend;
+      }
+      break;
+    }
+    case Singleton: {
+      // Store the coordinate of every entry (one per segment)
+      for (size_t cbegin = begin; cbegin < end; cbegin++) {
+        index[0].push_back(levelCoords[cbegin]);
+        PACK_NEXT_LEVEL(cbegin + 1);
+      }
+      break;
+    }
+  }
+}
+
+/// Copy index values into a new array of the given index width, which must be
+/// able to represent them.
+template <typename T>
+static void* copyToIndexArray(const vector<int64_t>& values, size_t level) {
+  T* array = (T*)malloc(values.size() * sizeof(T));
+  for (size_t i = 0; i < values.size(); i++) {
+    taco_uassert(values[i] >= std::numeric_limits<T>::min() &&
+                 values[i] <= std::numeric_limits<T>::max()) <<
+        "The index value " << values[i] << " of level " << level << " does " <<
+        "not fit in its index width";
+    array[i] = (T)values[i];
+  }
+  return array;
+}
+
+static void* copyToIndexArray(const vector<int64_t>& values,
+                              IndexWidth indexWidth, size_t level) {
+  switch (indexWidth) {
+    case UInt16:
+      return copyToIndexArray<uint16_t>(values, level);
+    case Int32:
+      return copyToIndexArray<int32_t>(values, level);
+    case Int64:
+      return copyToIndexArray<int64_t>(values, level);
   }
+  taco_unreachable;
+  return nullptr;
 }
 
 static int findMaxFixedValue(const vector<int>& dims,
@@ -197,16 +357,18 @@ static int findMaxFixedValue(const vector<int>& dims,
 Storage pack(const std::vector<int>&              dimensions,
              const Format&                        format,
              const std::vector<std::vector<int>>& coordinates,
-             const std::vector<double>            values) {
+             const void*                          values,
+             const ComponentType&                 ctype) {
   taco_iassert(dimensions.size() == format.getOrder());
+  taco_iassert(coordinates.size() > 0);
 
-  Storage storage(format);
+  Storage storage(format, ctype);
 
   size_t numDimensions = dimensions.size();
-  size_t numCoordinates = values.size();
+  size_t numCoordinates = coordinates[0].size();
 
   // Create vectors to store pointers to indices/index sizes
-  std::vector<std::vector<std::vector<int>>> indices;
+  vector<vector<vector<int64_t>>> indices;
   indices.reserve(numDimensions);
 
   for (size_t i=0; i < numDimensions; ++i) {
@@ -235,16 +397,55 @@ Storage pack(const std::vector<int>&              dimensions,
         indices[i][0].push_back(maxSize);
         break;
       }
+      case Singleton: {
+        // Singleton indices have an index array
+        indices.push_back({{}});
+        break;
+      }
+      case Bitmap: {
+        // Bitmap indices have three arrays: a dimension size, a pos array
+        // with the position of the first index value of each word and a
+        // bits array with the words
+        indices.push_back({{dimensions[i]}, {0}, {}});
+        break;
+      }
+      case Delta: {
+        // Delta indices have two arrays: a pos array with the start of each
+        // segment followed by the start of its bytes, and an idx array with
+        // the bytes of the encoded index values
+        indices.push_back({{0, 0}, {}});
+        break;
+      }
+      case Hashed: {
+        // Hashed indices have two arrays: a table size and a table of index
+        // values. Tables are at most half full, so that probes for missing
+        // index values stop at an empty slot.
+        indices.push_back({{}, {}});
+
+        size_t maxSize = (numCoordinates > 0)
+                         ? findMaxFixedValue(dimensions, coordinates,
+                                             format.getOrder(), i, 0,
+                                             numCoordinates)
+                         : 0;
+        int capacity = 1;
+        while ((size_t)capacity < 2*maxSize) {
+          capacity *= 2;
+        }
+        indices[i][0].push_back(capacity);
+        break;
+      }
     }
   }
 
-  std::vector<double> vals;
-  packTensor(dimensions, coordinates, (const double*)values.data(), 0,
-             numCoordinates, format.getDimensionTypes(), 0, &indices, &vals);
+  std::vector<int64_t> valuePositions;
+  packTensor(dimensions, coordinates, 0, numCoordinates,
+             format.getDimensionTypes(), 0, &indices, &valuePositions);
 
   // Copy packed data into tensor storage
   for (size_t i=0; i < numDimensions; ++i) {
     DimensionType dimensionType = format.getDimensionTypes()[i];
+    IndexWidth indexWidth = format.getIndexWidths()[i];
+    IndexWidth posWidth = format.getLevels()[i].getPosWidth();
 
     switch (dimensionType) {
       case DimensionType::Dense: {
@@ -253,15 +454,48 @@ Storage pack(const std::vector<int>&              dimensions,
         break;
       }
       case DimensionType::Sparse:
-      case DimensionType::Fixed: {
-        auto pos = util::copyToArray(indices[i][0]);
-        auto idx = util::copyToArray(indices[i][1]);
+      case DimensionType::Fixed:
+      case DimensionType::Hashed: {
+        auto pos = copyToIndexArray(indices[i][0], posWidth, i);
+        auto idx = copyToIndexArray(indices[i][1], indexWidth, i);
+        storage.setDimensionIndex(i, {pos,idx});
+        break;
+      }
+      case DimensionType::Singleton: {
+        auto idx = copyToIndexArray(indices[i][0], indexWidth, i);
+        storage.setDimensionIndex(i, {idx});
+        break;
+      }
+      case DimensionType::Bitmap: {
+        auto size = copyToIndexArray(indices[i][0], posWidth, i);
+        auto pos  = copyToIndexArray(indices[i][1], posWidth, i);
+        auto bits = copyToIndexArray(indices[i][2], indexWidth, i);
+        storage.setDimensionIndex(i, {size,pos,bits});
+        break;
+      }
+      case DimensionType::Delta: {
+        auto pos = copyToIndexArray(indices[i][0], posWidth, i);
+        auto idx = copyToIndexArray<uint8_t>(indices[i][1], i);
         storage.setDimensionIndex(i, {pos,idx});
         break;
       }
     }
   }
-  storage.setValues(util::copyToArray(vals));
+
+  // Copy the values at the packed positions into the value array. Pattern
+  // tensors have no values.
+  if (ctype == ComponentType::Pattern) {
+    return storage;
+  }
+  size_t valueSize = ctype.bytes();
+  char* vals = (char*)calloc(valuePositions.size(), valueSize);
+  for (size_t i = 0; i < valuePositions.size(); i++) {
+    if (valuePositions[i] >= 0) {
+      memcpy(&vals[i*valueSize],
+             &((const char*)values)[valuePositions[i]*valueSize], valueSize);
+    }
+  }
+  storage.setValues(vals);
 
   return storage;
 }
@@ -296,7 +530,11 @@ ir::Stmt packCode(const Format& format) {
       case Sparse: {
         break;
       }
-      case Fixed: {
+      case Fixed:
+      case Singleton:
+      case Hashed:
+      case Bitmap:
+      case Delta: {
         taco_not_supported_yet;
         break;
       }
@@ -65,4 +65,8 @@ ir::Stmt RootIterator::resizeIdxStorage(ir::Expr size) const {
   return Stmt();
 }
 
+ir::Stmt RootIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
 }}
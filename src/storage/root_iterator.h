@@ -31,6 +31,8 @@ public:
 
   ir::Stmt resizePtrStorage(ir::Expr size) const;
   ir::Stmt resizeIdxStorage(ir::Expr size) const;
+
+  ir::Stmt advanceTo(ir::Expr idx) const;
 };
 
 }}
@@ -0,0 +1,86 @@
+#include "singleton_iterator.h"
+
+#include "taco/util/strings.h"
+
+using namespace taco::ir;
+
+namespace taco {
+namespace storage {
+
+SingletonIterator::SingletonIterator(std::string name, const Expr& tensor,
+                                     int level, Iterator previous)
+    : IteratorImpl(previous, tensor) {
+  this->tensor = tensor;
+  this->level = level;
+
+  std::string idxVarName = name + util::toString(tensor);
+  ptrVar = makePtrVar(level, "_pos");
+  idxVar = Var::make(idxVarName, Type(Type::Int));
+}
+
+bool SingletonIterator::isDense() const {
+  return false;
+}
+
+bool SingletonIterator::isRandomAccess() const {
+  return false;
+}
+
+bool SingletonIterator::isSequentialAccess() const {
+  return true;
+}
+
+bool SingletonIterator::isSingleton() const {
+  return true;
+}
+
+Expr SingletonIterator::getPtrVar() const {
+  return ptrVar;
+}
+
+Expr SingletonIterator::getIdxVar() const {
+  return idxVar;
+}
+
+Expr SingletonIterator::getIteratorVar() const {
+  return ptrVar;
+}
+
+Expr SingletonIterator::begin() const {
+  return getParent().getPtrVar();
+}
+
+Expr SingletonIterator::end() const {
+  return Add::make(getParent().getPtrVar(), 1);
+}
+
+Stmt SingletonIterator::initDerivedVars() const {
+  return VarAssign::make(getIdxVar(), Load::make(getIdxArr(), getPtrVar()),
+                         true);
+}
+
+ir::Stmt SingletonIterator::storePtr() const {
+  return Stmt();
+}
+
+ir::Stmt SingletonIterator::storeIdx(ir::Expr idx) const {
+  return Store::make(getIdxArr(), getPtrVar(), idx);
+}
+
+ir::Expr SingletonIterator::getIdxArr() const {
+  return GetProperty::make(tensor, TensorProperty::Index, level);
+}
+
+ir::Stmt SingletonIterator::resizePtrStorage(ir::Expr size) const {
+  return Stmt();
+}
+
+ir::Stmt SingletonIterator::resizeIdxStorage(ir::Expr size) const {
+  return Allocate::make(getIdxArr(), size, true);
+}
+
+ir::Stmt SingletonIterator::advanceTo(ir::Expr idx) const {
+  return Stmt();
+}
+
+}}
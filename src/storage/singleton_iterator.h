@@ -0,0 +1,56 @@
+#ifndef TACO_STORAGE_SINGLETON_H
+#define TACO_STORAGE_SINGLETON_H
+
+#include <string>
+
+#include "iterator.h"
+#include "ir/ir.h"
+
+namespace taco {
+namespace storage {
+
+/// An iterator over a level that stores one coordinate per position of its
+/// parent level (e.g. the second level of COO). The level has no pos array:
+/// its positions are the positions of the parent and its idx array stores
+/// the coordinate of each.
+class SingletonIterator : public IteratorImpl {
+public:
+  SingletonIterator(std::string name, const ir::Expr& tensor, int level,
+                    Iterator previous);
+  virtual ~SingletonIterator() {};
+
+  bool isDense() const;
+
+  bool isRandomAccess() const;
+  bool isSequentialAccess() const;
+  bool isSingleton() const;
+
+  ir::Expr getPtrVar() const;
+  ir::Expr getIdxVar() const;
+
+  ir::Expr getIteratorVar() const;
+  ir::Expr begin() const;
+  ir::Expr end() const;
+
+  ir::Stmt initDerivedVars() const;
+
+  ir::Stmt storePtr() const;
+  ir::Stmt storeIdx(ir::Expr idx) const;
+
+  ir::Stmt resizePtrStorage(ir::Expr size) const;
+  ir::Stmt resizeIdxStorage(ir::Expr size) const;
+
+  ir::Stmt advanceTo(ir::Expr idx) const;
+
+private:
+  ir::Expr tensor;
+  int level;
+
+  ir::Expr ptrVar;
+  ir::Expr idxVar;
+
+  ir::Expr getIdxArr() const;
+};
+
+}}
+#endif
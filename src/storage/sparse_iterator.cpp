@@ -8,14 +8,20 @@ namespace taco {
 namespace storage {
 
 SparseIterator::SparseIterator(std::string name, const Expr& tensor, int level,
-                               Iterator previous)
+                               bool unique, Iterator previous)
     : IteratorImpl(previous, tensor) {
   this->tensor = tensor;
   this->level = level;
+  this->unique = unique;
+
+  // Positions are loaded from the pos array, so they are 64-bit if it is
+  const Var* tensorVar = tensor.as<Var>();
+  Type ptrType = getIndexType(tensorVar->format.getLevels()[level]
+                                 .getPosWidth());
 
   std::string idxVarName = name + util::toString(tensor);
   ptrVar = Var::make(util::toString(tensor) + std::to_string(level+1)+"_pos",
-                     Type(Type::Int));
+                     ptrType);
   idxVar = Var::make(idxVarName, Type(Type::Int));
 }
 
@@ -31,6 +37,10 @@ bool SparseIterator::isSequentialAccess() const {
   return true;
 }
 
+bool SparseIterator::isUnique() const {
+  return unique;
+}
+
 Expr SparseIterator::getPtrVar() const {
   return ptrVar;
 }
@@ -81,4 +91,36 @@ ir::Stmt SparseIterator::resizeIdxStorage(ir::Expr size) const {
   return Allocate::make(getIdxArr(), size, true);
 }
 
+ir::Stmt SparseIterator::advanceTo(ir::Expr idx) const {
+  // The search keeps idx[ptr] < idx and (hi == end or idx[hi] >= idx)
+  Expr ptr  = getPtrVar();
+  Expr end  = this->end();
+  Expr step = Var::make(util::toString(ptr) + "_step", Type(Type::Int));
+  Expr hi   = Var::make(util::toString(ptr) + "_hi",   ptr.type());
+  Expr mid  = Var::make(util::toString(ptr) + "_mid",  ptr.type());
+
+  // Gallop: double the step until an index is not smaller than idx
+  Stmt initStep = VarAssign::make(step, 1, true);
+  Stmt initHi   = VarAssign::make(hi, Add::make(ptr, 1), true);
+  Expr hiBefore = And::make(Lt::make(hi, end),
+                            Lt::make(Load::make(getIdxArr(), hi), idx));
+  Stmt gallop = While::make(hiBefore, Block::make({
+      VarAssign::make(ptr, hi),
+      VarAssign::make(step, Mul::make(step, 2)),
+      VarAssign::make(hi, Add::make(ptr, step))
+  }));
+  Stmt clampHi = VarAssign::make(hi, Min::make({hi, end}));
+
+  // Binary search between the last two steps
+  Stmt search = While::make(Lt::make(Add::make(ptr, 1), hi), Block::make({
+      VarAssign::make(mid, Div::make(Add::make(ptr, hi), 2), true),
+      IfThenElse::make(Lt::make(Load::make(getIdxArr(), mid), idx),
+                       VarAssign::make(ptr, mid),
+                       VarAssign::make(hi, mid))
+  }));
+
+  return Block::make({initStep, initHi, gallop, clampHi, search,
+                      VarAssign::make(ptr, hi)});
+}
+
 }}
@@ -12,13 +12,14 @@ namespace storage {
 class SparseIterator : public IteratorImpl {
 public:
   SparseIterator(std::string name, const ir::Expr& tensor, int level,
-                 Iterator previous);
+                 bool unique, Iterator previous);
   virtual ~SparseIterator() {};
 
   bool isDense() const;
 
   bool isRandomAccess() const;
   bool isSequentialAccess() const;
+  bool isUnique() const;
 
   ir::Expr getPtrVar() const;
   ir::Expr getIdxVar() const;
@@ -35,9 +36,12 @@ public:
   ir::Stmt resizePtrStorage(ir::Expr size) const;
   ir::Stmt resizeIdxStorage(ir::Expr size) const;
 
+  ir::Stmt advanceTo(ir::Expr idx) const;
+
 private:
   ir::Expr tensor;
   int level;
+  bool unique;
 
   ir::Expr ptrVar;
   ir::Expr idxVar;
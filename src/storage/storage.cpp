@@ -14,10 +14,11 @@ namespace storage {
 
 // class Storage
 struct Storage::Content {
-  Format               format;
+  Format                format;
+  ComponentType         ctype;
 
-  vector<vector<int*>> indices;
-  double*              values;
+  vector<vector<void*>> indices;
+  void*                 values;
 
   ~Content() {
     for (auto& index : indices) {
@@ -32,8 +33,10 @@ struct Storage::Content {
 Storage::Storage() : content(nullptr) {
 }
 
-Storage::Storage(const Format& format) : content(new Content) {
+Storage::Storage(const Format& format, const ComponentType& ctype)
+    : content(new Content) {
   content->format = format;
+  content->ctype = ctype;
   auto dimTypes = format.getDimensionTypes();
   content->indices.resize(dimTypes.size());
   for (size_t i = 0; i < content->indices.size(); i++) {
@@ -43,8 +46,16 @@ Storage::Storage(const Format& format) : content(new Content) {
         break;
       case DimensionType::Sparse:
       case DimensionType::Fixed:
+      case DimensionType::Hashed:
+      case DimensionType::Delta:
         content->indices[i].resize(2);
         break;
+      case DimensionType::Singleton:
+        content->indices[i].resize(1);
+        break;
+      case DimensionType::Bitmap:
+        content->indices[i].resize(3);
+        break;
     }
     for (size_t j = 0; j < content->indices[i].size(); j++) {
       content->indices[i][j] = nullptr;
@@ -54,7 +65,7 @@ Storage::Storage(const Format& format) : content(new Content) {
   content->values = nullptr;
 }
 
-void Storage::setDimensionIndex(size_t dimension, std::vector<int*> index) {
+void Storage::setDimensionIndex(size_t dimension, std::vector<void*> index) {
   taco_iassert(index.size() == content->indices[dimension].size()) <<
       "Setting the wrong number of indices (" <<
       index.size() << " != " << content->indices[dimension].size() << "). " <<
@@ -66,7 +77,7 @@ void Storage::setDimensionIndex(size_t dimension, std::vector<int*> index) {
   }
 }
 
-void Storage::setValues(double* values) {
+void Storage::setValues(void* values) {
   content->values = values;
 }
 
@@ -74,51 +85,156 @@ const Format& Storage::getFormat() const {
   return content->format;
 }
 
-const vector<int*>& Storage::getDimensionIndex(size_t dimension) const {
+const ComponentType& Storage::getComponentType() const {
+  return content->ctype;
+}
+
+const vector<void*>& Storage::getDimensionIndex(size_t dimension) const {
   return content->indices[dimension];
 }
 
-const double* Storage::getValues() const {
+/// Returns true if the given index array of the given dimension stores bytes,
+/// rather than values of the dimension's index width.
+static bool isByteArray(const Format& format, size_t dimension,
+                        size_t indexNumber) {
+  return format.getDimensionTypes()[dimension] == DimensionType::Delta &&
+         indexNumber == 1;
+}
+
+/// Returns the index width of the given index array of the given dimension.
+/// The idx arrays have the level's index width, and all other arrays (pos
+/// arrays and sizes) have the level's pos width.
+static IndexWidth getArrayWidth(const Format& format, size_t dimension,
+                                size_t indexNumber) {
+  const Level& level = format.getLevels()[dimension];
+  size_t idxNumber = 1;
+  switch (level.getType()) {
+    case DimensionType::Singleton:
+      idxNumber = 0;
+      break;
+    case DimensionType::Bitmap:
+      idxNumber = 2;
+      break;
+    default:
+      break;
+  }
+  return (indexNumber == idxNumber) ? level.getIndexWidth()
+                                    : level.getPosWidth();
+}
+
+int64_t Storage::getIndexValue(size_t dimension, size_t indexNumber,
+                               size_t pos) const {
+  const void* array = content->indices[dimension][indexNumber];
+  if (isByteArray(content->format, dimension, indexNumber)) {
+    return ((const uint8_t*)array)[pos];
+  }
+  switch (getArrayWidth(content->format, dimension, indexNumber)) {
+    case IndexWidth::UInt16:
+      return ((const uint16_t*)array)[pos];
+    case IndexWidth::Int32:
+      return ((const int32_t*)array)[pos];
+    case IndexWidth::Int64:
+      return ((const int64_t*)array)[pos];
+  }
+  taco_unreachable;
+  return 0;
+}
+
+const void* Storage::getValues() const {
   return content->values;
 }
 
-double* Storage::getValues() {
+void* Storage::getValues() {
   return content->values;
 }
 
+double Storage::getValue(size_t pos) const {
+  return getComponentValue(content->values, content->ctype, pos);
+}
+
 Storage::Size Storage::getSize() const {
   vector<vector<size_t>> numIndexVals(content->indices.size());
+  vector<vector<size_t>> numBytesPerIndexVal(content->indices.size());
 
   size_t numVals = 1;
   for (size_t i=0; i < content->indices.size(); ++i) {
-    auto& index = content->indices[i];
     switch (content->format.getDimensionTypes()[i]) {
       case DimensionType::Dense:
         numIndexVals[i].push_back(1);                  // size
-        numVals *= index[0][0];
+        numVals *= getIndexValue(i, 0, 0);
         break;
-      case DimensionType::Sparse:
+      case DimensionType::Sparse: {
+        size_t numPos = getIndexValue(i, 0, numVals);
         numIndexVals[i].push_back(numVals + 1);        // pos
-        numIndexVals[i].push_back(index[0][numVals]);  // idx
-        numVals = index[0][numVals];
+        numIndexVals[i].push_back(numPos);             // idx
+        numVals = numPos;
         break;
+      }
       case DimensionType::Fixed:
-        numVals *= index[0][0];
+      case DimensionType::Hashed:
+        numVals *= getIndexValue(i, 0, 0);
         numIndexVals[i].push_back(1);                  // pos
         numIndexVals[i].push_back(numVals);            // idx
         break;
+      case DimensionType::Singleton:
+        numIndexVals[i].push_back(numVals);            // idx
+        break;
+      case DimensionType::Bitmap: {
+        size_t numWords = numVals * ((getIndexValue(i, 0, 0) + 31) / 32);
+        numIndexVals[i].push_back(1);                  // size
+        numIndexVals[i].push_back(numWords + 1);       // pos
+        numIndexVals[i].push_back(numWords);           // bits
+        numVals = getIndexValue(i, 1, numWords);
+        break;
+      }
+      case DimensionType::Delta: {
+        size_t numPos = getIndexValue(i, 0, 2*numVals);
+        size_t numBytes = getIndexValue(i, 0, 2*numVals + 1);
+        numIndexVals[i].push_back(2*numVals + 2);      // pos
+        numIndexVals[i].push_back(numBytes);           // idx
+        numVals = numPos;
+        break;
+      }
+    }
+    for (size_t j = 0; j < numIndexVals[i].size(); j++) {
+      numBytesPerIndexVal[i].push_back(
+          isByteArray(content->format, i, j)
+          ? 1 : getNumBytes(getArrayWidth(content->format, i, j)));
     }
   }
 
-  return Storage::Size(numVals, numIndexVals);
+  return Storage::Size(numVals, numIndexVals, content->ctype.bytes(),
+                       numBytesPerIndexVal);
+}
+
+/// Returns the values of one of the index arrays of the given dimension.
+static vector<int64_t> getIndexArray(const Storage& storage, size_t dimension,
+                                     size_t indexNumber) {
+  size_t size = storage.getSize().numIndexValues(dimension, indexNumber);
+  vector<int64_t> indexArray(size);
+  for (size_t pos = 0; pos < size; pos++) {
+    indexArray[pos] = storage.getIndexValue(dimension, indexNumber, pos);
+  }
+  return indexArray;
 }
 
 std::ostream& operator<<(std::ostream& os, const Storage& storage) {
   auto format = storage.getFormat();
-  if (storage.getValues() == nullptr) {
+  bool pattern = storage.getComponentType() == ComponentType::Pattern;
+  if (storage.getValues() == nullptr && !pattern) {
     return os;
   }
 
+  // Pattern tensors have no value array, so they are packed iff their indices
+  // are
+  for (size_t i=0; pattern && i < format.getOrder(); ++i) {
+    for (void* indexArray : storage.getDimensionIndex(i)) {
+      if (indexArray == nullptr) {
+        return os;
+      }
+    }
+  }
+
   auto size = storage.getSize();
 
   // Print indices
@@ -126,29 +242,56 @@ std::ostream& operator<<(std::ostream& os, const Storage& storage) {
     os << "dimension " << to_string(i) << ":" << std::endl;
     switch (format.getDimensionTypes()[i]) {
       case DimensionType::Dense: {
-        os << "  size: " << *storage.getDimensionIndex(i)[0] << endl;
+        os << "  size: " << storage.getIndexValue(i, 0, 0) << endl;
         break;
       }
       case DimensionType::Sparse: {
-        auto pos = storage.getDimensionIndex(i)[0];
-        auto idx = storage.getDimensionIndex(i)[1];
         os << "  pos: "
-           << "[" + util::join(pos, pos+size.numIndexValues(i,0)) + "]" << endl;
+           << "[" + util::join(getIndexArray(storage, i, 0)) + "]" << endl;
         os << "  idx: "
-           << "[" + util::join(idx, idx+size.numIndexValues(i,1)) + "]" << endl;
+           << "[" + util::join(getIndexArray(storage, i, 1)) + "]" << endl;
         break;
       }
       case DimensionType::Fixed:
+      case DimensionType::Hashed: {
+        os << "  size: " << storage.getIndexValue(i, 0, 0) << endl;
+        os << "  idx: "
+           << "[" + util::join(getIndexArray(storage, i, 1)) + "]" << endl;
+        break;
+      }
+      case DimensionType::Singleton: {
+        os << "  idx: "
+           << "[" + util::join(getIndexArray(storage, i, 0)) + "]" << endl;
+        break;
+      }
+      case DimensionType::Delta: {
+        os << "  pos: "
+           << "[" + util::join(getIndexArray(storage, i, 0)) + "]" << endl;
+        os << "  idx: "
+           << "[" + util::join(getIndexArray(storage, i, 1)) + "]" << endl;
         break;
+      }
+      case DimensionType::Bitmap: {
+        os << "  size: " << storage.getIndexValue(i, 0, 0) << endl;
+        os << "  pos: "
+           << "[" + util::join(getIndexArray(storage, i, 1)) + "]" << endl;
+        os << "  bits: "
+           << "[" + util::join(getIndexArray(storage, i, 2)) + "]" << endl;
+        break;
+      }
     }
   }
 
   // Print values
-  auto values = storage.getValues();
+  if (pattern) {
+    return os << "values: pattern";
+  }
+  vector<double> values(size.numValues());
+  for (size_t pos = 0; pos < values.size(); pos++) {
+    values[pos] = storage.getValue(pos);
+  }
   os << "values: " << endl
-     << (values != nullptr
-         ? "  [" + util::join(values, values + size.numValues()) + "]"
-         : "none");
+     << "  [" + util::join(values) + "]";
 
   return os;
 }
@@ -177,14 +320,19 @@ size_t Storage::Size::numBytes() const {
   return cost;
 }
 size_t Storage::Size::numBytesPerValue() const {
-  return sizeof(double);
+  return numBytesPerVal;
 }
 
 size_t Storage::Size::numBytesPerIndexValue(size_t dim, size_t n) const {
-  return sizeof(int);
+  taco_iassert(dim < numBytesPerIndexVal.size());
+  taco_iassert(n < numBytesPerIndexVal[dim].size());
+  return numBytesPerIndexVal[dim][n];
 }
 
-Storage::Size::Size(size_t numVals, vector<vector<size_t>> numIndexVals)
- : numVals(numVals), numIndexVals(numIndexVals) {}
+Storage::Size::Size(size_t numVals, vector<vector<size_t>> numIndexVals,
+                    size_t numBytesPerVal,
+                    vector<vector<size_t>> numBytesPerIndexVal)
+ : numVals(numVals), numIndexVals(numIndexVals),
+   numBytesPerVal(numBytesPerVal), numBytesPerIndexVal(numBytesPerIndexVal) {}
 
 }}
@@ -5,7 +5,9 @@
 #ifndef TACO_TENSOR_T_DEFINED
 #define TACO_TENSOR_T_DEFINED
 
-typedef enum { taco_dim_dense, taco_dim_sparse } taco_dim_t;
+typedef enum { taco_dim_dense, taco_dim_sparse, taco_dim_fixed,
+               taco_dim_singleton, taco_dim_hashed,
+               taco_dim_bitmap, taco_dim_delta } taco_dim_t;
 
 typedef struct {
   int32_t     order;      // tensor order (number of dimensions)
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <sstream>
 #include <limits.h>
+#include <set>
 
 #include "taco/tensor.h"
 #include "taco/expr.h"
@@ -11,16 +12,17 @@
 #include "ir/ir.h"
 #include "taco/expr_nodes/expr_nodes.h"
 #include "taco/expr_nodes/expr_visitor.h"
+#include "taco/expr_nodes/expr_rewriter.h"
 #include "taco/storage/storage.h"
 #include "taco/storage/pack.h"
 #include "ir/ir.h"
 #include "lower/lower.h"
-#include "lower/iteration_schedule.h"
 #include "backends/module.h"
 #include "taco_tensor_t.h"
 #include "taco/io/tns_file_format.h"
 #include "taco/io/mtx_file_format.h"
 #include "taco/io/rb_file_format.h"
+#include "io/compressed_stream.h"
 #include "taco/util/strings.h"
 #include "taco/util/timers.h"
 #include "taco/util/name_generator.h"
@@ -32,56 +34,6 @@ using namespace taco::expr_nodes;
 
 namespace taco {
 
-// class ComponentType
-size_t ComponentType::bytes() const {
-  switch (this->kind) {
-    case Bool:
-      return sizeof(bool);
-    case Int:
-      return sizeof(int);
-    case Float:
-      return sizeof(float);
-    case Double:
-      return sizeof(double);
-    case Unknown:
-      break;
-  }
-  return UINT_MAX;
-}
-
-ComponentType::Kind ComponentType::getKind() const {
-  return kind;
-}
-
-bool operator==(const ComponentType& a, const ComponentType& b) {
-  return a.getKind() == b.getKind();
-}
-
-bool operator!=(const ComponentType& a, const ComponentType& b) {
-  return a.getKind() != b.getKind();
-}
-
-std::ostream& operator<<(std::ostream& os, const ComponentType& type) {
-  switch (type.getKind()) {
-    case ComponentType::Bool:
-      os << "bool";
-      break;
-    case ComponentType::Int:
-      os << "int";
-      break;
-    case ComponentType::Float:
-      os << "float";
-      break;
-    case ComponentType::Double:
-      os << "double";
-      break;
-    case ComponentType::Unknown:
-      break;
-  }
-  return os;
-}
-
-
 static const size_t DEFAULT_ALLOC_SIZE = (1 << 20);
 
 struct TensorBase::Content {
@@ -98,12 +50,26 @@ struct TensorBase::Content {
   size_t                   allocSize;
   size_t                   valuesSize;
 
-  lower::IterationSchedule schedule;
+  Schedule                 schedule;
   Stmt                     assembleFunc;
   Stmt                     computeFunc;
   shared_ptr<Module>       module;
+
+  /// The number of tensors compiled together into the module.
+  size_t                   groupSize;
 };
 
+/// Check that the coordinates of every level fit its index width.
+static void checkIndexWidths(const Format& format,
+                             const vector<int>& dimensions) {
+  for (auto& level : format.getLevels()) {
+    int dimension = dimensions[level.getDimension()];
+    taco_uassert(level.getIndexWidth() != UInt16 || dimension-1 <= USHRT_MAX) <<
+        "The coordinates of a dimension of size " << dimension << " do not " <<
+        "fit the " << level.getIndexWidth() << " index width of its level";
+  }
+}
+
 TensorBase::TensorBase() : TensorBase(ComponentType::Double) {
 }
 
@@ -132,24 +98,30 @@ TensorBase::TensorBase(string name, ComponentType ctype, vector<int> dimensions,
       "The number of format levels (" << format.getOrder() << ") " <<
       "must match the tensor order (" << dimensions.size() << "), " <<
       "or there must be a single level.";
-  taco_uassert(ctype == ComponentType::Double) <<
-      "Only double tensors currently supported";
+  taco_uassert(ctype != ComponentType::Unknown) <<
+      "Tensors must have a known component type";
 
   if (dimensions.size() == 0) {
     format = Format();
   }
   else if (dimensions.size() > 1 && format.getOrder() == 1) {
     DimensionType levelType = format.getLevels()[0].getType();
+    IndexWidth indexWidth = format.getLevels()[0].getIndexWidth();
     vector<DimensionType> levelTypes;
+    vector<int>           levelOrder;
+    vector<IndexWidth>    indexWidths;
     for (size_t i = 0; i < dimensions.size(); i++) {
       levelTypes.push_back(levelType);
+      levelOrder.push_back(i);
+      indexWidths.push_back(indexWidth);
     }
-    format = Format(levelTypes);
+    format = Format(levelTypes, levelOrder, indexWidths);
   }
+  checkIndexWidths(format, dimensions);
 
   content->name = name;
   content->dimensions = dimensions;
-  content->storage = Storage(format);
+  content->storage = Storage(format, ctype);
   content->ctype = ctype;
   this->setAllocSize(DEFAULT_ALLOC_SIZE);
 
@@ -164,6 +136,7 @@ TensorBase::TensorBase(string name, ComponentType ctype, vector<int> dimensions,
   }
   
   content->module = make_shared<Module>();
+  content->groupSize = 1;
 
   this->coordinateBuffer = shared_ptr<vector<char>>(new vector<char>);
   this->coordinateBufferUsed = 0;
@@ -199,9 +172,6 @@ void TensorBase::reserve(size_t numCoordinates) {
 void TensorBase::insert(const initializer_list<int>& coordinate, double value) {
   taco_uassert(coordinate.size() == getOrder()) <<
       "Wrong number of indices";
-  taco_uassert(getComponentType() == ComponentType::Double) <<
-      "Cannot insert a value of type '" << ComponentType::Double << "' " <<
-      "into a tensor with component type " << getComponentType();
   if ((coordinateBuffer->size() - coordinateBufferUsed) < coordinateSize) {
     coordinateBuffer->resize(coordinateBuffer->size() + coordinateSize);
   }
@@ -210,16 +180,17 @@ void TensorBase::insert(const initializer_list<int>& coordinate, double value) {
     *coordLoc = idx;
     coordLoc++;
   }
-  *((double*)coordLoc) = value;
+  setComponentValue(coordLoc, getComponentType(), 0, value);
   coordinateBufferUsed += coordinateSize;
 }
 
 void TensorBase::insert(const std::vector<int>& coordinate, double value) {
+  setComponentValue(insertCoordinate(coordinate), getComponentType(), 0, value);
+}
+
+void* TensorBase::insertCoordinate(const std::vector<int>& coordinate) {
   taco_uassert(coordinate.size() == getOrder()) <<
       "Wrong number of indices";
-  taco_uassert(getComponentType() == ComponentType::Double) <<
-      "Cannot insert a value of type '" << ComponentType::Double << "' " <<
-      "into a tensor with component type " << getComponentType();
   if ((coordinateBuffer->size() - coordinateBufferUsed) < coordinateSize) {
     coordinateBuffer->resize(coordinateBuffer->size() + coordinateSize);
   }
@@ -228,8 +199,8 @@ void TensorBase::insert(const std::vector<int>& coordinate, double value) {
     *coordLoc = idx;
     coordLoc++;
   }
-  *((double*)coordLoc) = value;
   coordinateBufferUsed += coordinateSize;
+  return coordLoc;
 }
 
 const ComponentType& TensorBase::getComponentType() const {
@@ -266,6 +237,8 @@ void TensorBase::setCSR(double* vals, int* rowPtr, int* colIdx) {
   taco_uassert(getFormat() == CSR) <<
       "setCSR: the tensor " << getName() << " is not in the CSR format, " <<
       "but instead " << getFormat();
+  taco_uassert(getComponentType() == ComponentType::Double) <<
+      "setCSR: the tensor " << getName() << " does not have double components";
   auto storage = getStorage();
   storage.setDimensionIndex(0, {util::copyToArray({getDimensions()[0]})});
   storage.setDimensionIndex(1, {rowPtr, colIdx});
@@ -275,15 +248,19 @@ void TensorBase::setCSR(double* vals, int* rowPtr, int* colIdx) {
 void TensorBase::getCSR(double** vals, int** rowPtr, int** colIdx) {
   taco_uassert(getFormat() == CSR) <<
       "getCSR: the tensor " << getName() << " is not defined in the CSR format";
+  taco_uassert(getComponentType() == ComponentType::Double) <<
+      "getCSR: the tensor " << getName() << " does not have double components";
   auto storage = getStorage();
-  *vals = storage.getValues();
-  *rowPtr = storage.getDimensionIndex(1)[0];
-  *colIdx = storage.getDimensionIndex(1)[1];
+  *vals = (double*)storage.getValues();
+  *rowPtr = (int*)storage.getDimensionIndex(1)[0];
+  *colIdx = (int*)storage.getDimensionIndex(1)[1];
 }
 
 void TensorBase::setCSC(double* vals, int* colPtr, int* rowIdx) {
   taco_uassert(getFormat() == CSC) <<
       "setCSC: the tensor " << getName() << " is not defined in the CSC format";
+  taco_uassert(getComponentType() == ComponentType::Double) <<
+      "setCSC: the tensor " << getName() << " does not have double components";
   auto storage = getStorage();
   std::vector<int> denseDim = {getDimensions()[1]};
   storage.setDimensionIndex(0, {util::copyToArray(denseDim)});
@@ -294,11 +271,13 @@ void TensorBase::setCSC(double* vals, int* colPtr, int* rowIdx) {
 void TensorBase::getCSC(double** vals, int** colPtr, int** rowIdx) {
   taco_uassert(getFormat() == CSC) <<
       "getCSC: the tensor " << getName() << " is not defined in the CSC format";
+  taco_uassert(getComponentType() == ComponentType::Double) <<
+      "getCSC: the tensor " << getName() << " does not have double components";
 
   auto storage = getStorage();
-  *vals = storage.getValues();
-  *colPtr = storage.getDimensionIndex(1)[0];
-  *rowIdx = storage.getDimensionIndex(1)[1];
+  *vals = (double*)storage.getValues();
+  *colPtr = (int*)storage.getDimensionIndex(1)[0];
+  *rowIdx = (int*)storage.getDimensionIndex(1)[1];
 }
 
 static int numIntegersToCompare = 0;
@@ -314,12 +293,6 @@ static int lexicographicalCmp(const void* a, const void* b) {
 
 /// Pack coordinates into a data structure given by the tensor format.
 void TensorBase::pack() {
-  taco_tassert(getComponentType() == ComponentType::Double)
-      << "make the packing machinery work with other primitive types later. "
-      << "Right now we're specializing to doubles so that we can use a "
-      << "resizable vector, but eventually we should use a two pass pack "
-      << "algorithm that figures out sizes first, and then packs the data";
-
   // Nothing to pack
   if (coordinateBufferUsed == 0) {
     return;
@@ -327,12 +300,18 @@ void TensorBase::pack() {
   const size_t order = getOrder();
 
 
-  // Pack scalars
+  // Pack scalars. Pattern scalars are one and have no value.
+  if (order == 0 && getComponentType() == ComponentType::Pattern) {
+    this->coordinateBuffer->clear();
+    this->coordinateBufferUsed = 0;
+    return;
+  }
   if (order == 0) {
-    content->storage.setValues((double*)malloc(getComponentType().bytes()));
+    size_t valueSize = getComponentType().bytes();
+    content->storage.setValues(malloc(valueSize));
     char* coordLoc = this->coordinateBuffer->data();
-    content->storage.getValues()[0] =
-        *(double*)&coordLoc[this->coordinateSize-getComponentType().bytes()];
+    memcpy(content->storage.getValues(),
+           &coordLoc[this->coordinateSize-valueSize], valueSize);
     this->coordinateBuffer->clear();
     return;
   }
@@ -384,14 +363,15 @@ void TensorBase::pack() {
     coordinates[i] = std::vector<int>(numCoordinates);
   }
 
-  std::vector<double> values(numCoordinates);
+  size_t valueSize = getComponentType().bytes();
+  std::vector<char> values(numCoordinates * valueSize);
   for (size_t i=0; i < numCoordinates; ++i) {
     int* coordLoc = (int*)&coordinatesPtr[i*coordSize];
     for (size_t d=0; d < order; ++d) {
       coordinates[d][i] = *coordLoc;
       coordLoc++;
     }
-    values[i] = *((double*)coordLoc);
+    memcpy(&values[i*valueSize], coordLoc, valueSize);
   }
   taco_iassert(coordinates.size() > 0);
   this->coordinateBuffer->clear();
@@ -400,7 +380,8 @@ void TensorBase::pack() {
 
   // Pack indices and values
   content->storage = storage::pack(permutedDimensions, getFormat(),
-                                   coordinates, values);
+                                   coordinates, values.data(),
+                                   getComponentType());
 
 //  std::cout << storage::packCode(getFormat()) << std::endl;
 }
@@ -408,7 +389,8 @@ void TensorBase::pack() {
 void TensorBase::zero() {
   auto resultStorage = getStorage();
   // Set values to 0.0 in case we are doing a += operation
-  memset(resultStorage.getValues(), 0, content->valuesSize * sizeof(double));
+  memset(resultStorage.getValues(), 0,
+         content->valuesSize * getComponentType().bytes());
 }
 
 Access TensorBase::operator()(const std::vector<Var>& indices) {
@@ -421,6 +403,11 @@ Access TensorBase::operator()(const std::vector<Var>& indices) {
 
 void TensorBase::compile() {
   taco_iassert(getExpr().defined()) << "No expression defined for tensor";
+  // The module of a group is shared with the other tensors of the group
+  if (content->groupSize > 1) {
+    content->module = make_shared<Module>();
+    content->groupSize = 1;
+  }
   content->assembleFunc = lower::lower(*this, "assemble", {lower::Assemble});
   content->computeFunc  = lower::lower(*this, "compute", {lower::Compute});
   content->module->addFunction(content->assembleFunc);
@@ -460,39 +447,84 @@ static taco_tensor_t* getTensorData(const TensorBase& tensor) {
         tensorData->indices[i][1] = (uint8_t*)dimIndex[1];  // idx array
         break;
       case DimensionType::Fixed:
-        taco_not_supported_yet;
+        tensorData->dim_types[i]  = taco_dim_fixed;
+        tensorData->indices[i]    = (uint8_t**)malloc(2 * sizeof(uint8_t**));
+        tensorData->indices[i][0] = (uint8_t*)dimIndex[0];  // segment size
+        tensorData->indices[i][1] = (uint8_t*)dimIndex[1];  // idx array
+        break;
+      case DimensionType::Hashed:
+        tensorData->dim_types[i]  = taco_dim_hashed;
+        tensorData->indices[i]    = (uint8_t**)malloc(2 * sizeof(uint8_t**));
+        tensorData->indices[i][0] = (uint8_t*)dimIndex[0];  // table size
+        tensorData->indices[i][1] = (uint8_t*)dimIndex[1];  // idx array
+        break;
+      case DimensionType::Bitmap:
+        tensorData->dim_types[i]  = taco_dim_bitmap;
+        tensorData->indices[i]    = (uint8_t**)malloc(3 * sizeof(uint8_t**));
+        tensorData->indices[i][0] = (uint8_t*)dimIndex[1];  // pos array
+        tensorData->indices[i][1] = (uint8_t*)dimIndex[2];  // bits array
+        tensorData->indices[i][2] = (uint8_t*)dimIndex[0];  // size
+        break;
+      case DimensionType::Delta:
+        tensorData->dim_types[i]  = taco_dim_delta;
+        tensorData->indices[i]    = (uint8_t**)malloc(2 * sizeof(uint8_t**));
+        tensorData->indices[i][0] = (uint8_t*)dimIndex[0];  // pos array
+        tensorData->indices[i][1] = (uint8_t*)dimIndex[1];  // idx bytes
+        break;
+      case DimensionType::Singleton:
+        tensorData->dim_types[i]  = taco_dim_singleton;
+        tensorData->indices[i]    = (uint8_t**)malloc(2 * sizeof(uint8_t**));
+        tensorData->indices[i][0] = nullptr;                // no pos array
+        tensorData->indices[i][1] = (uint8_t*)dimIndex[0];  // idx array
         break;
     }
   }
 
-  tensorData->csize = sizeof(double);
+  tensorData->csize = tensor.getComponentType().bytes();
   tensorData->vals  = (uint8_t*)storage.getValues();
 
   return tensorData;
 }
 
 static inline
-vector<void*> packArguments(const TensorBase& tensor) {
+vector<void*> packArguments(const vector<TensorBase>& tensors) {
   vector<void*> arguments;
 
-  // Pack the result tensor
-  arguments.push_back(getTensorData(tensor));
+  // Pack the result tensors
+  for (auto& tensor : tensors) {
+    arguments.push_back(getTensorData(tensor));
+  }
 
-  // Pack operand tensors
-  vector<TensorBase> operands = expr_nodes::getOperands(tensor.getExpr());
-  for (auto& operand : operands) {
-    arguments.push_back(getTensorData(operand));
+  // Pack operand tensors, in the order they are first used
+  set<TensorBase> packed;
+  for (auto& tensor : tensors) {
+    vector<TensorBase> operands = expr_nodes::getOperands(tensor.getExpr());
+    for (auto& operand : operands) {
+      if (!util::contains(packed, operand)) {
+        packed.insert(operand);
+        arguments.push_back(getTensorData(operand));
+      }
+    }
   }
 
   return arguments;
 }
 
+static inline
+vector<void*> packArguments(const TensorBase& tensor) {
+  return packArguments(vector<TensorBase>({tensor}));
+}
+
 void TensorBase::assemble() {
+  taco_uassert(content->groupSize == 1) << getName() << " was compiled " <<
+      "together with other tensors and must be assembled with them";
   this->content->arguments = packArguments(*this);
   this->assembleInternal();
 }
 
 void TensorBase::compute() {
+  taco_uassert(content->groupSize == 1) << getName() << " was compiled " <<
+      "together with other tensors and must be computed with them";
   this->content->arguments = packArguments(*this);
   this->zero();
   this->computeInternal();
@@ -506,6 +538,58 @@ void TensorBase::evaluate() {
   this->computeInternal();
 }
 
+void compile(vector<TensorBase> tensors) {
+  taco_uassert(tensors.size() > 0) << "No tensors to compile";
+  Stmt assembleFunc = lower::lower(tensors, "assemble", {lower::Assemble});
+  Stmt computeFunc  = lower::lower(tensors, "compute", {lower::Compute});
+  auto module = make_shared<Module>();
+  module->addFunction(assembleFunc);
+  module->addFunction(computeFunc);
+  module->compile();
+  for (auto& tensor : tensors) {
+    tensor.content->assembleFunc = assembleFunc;
+    tensor.content->computeFunc  = computeFunc;
+    tensor.content->module       = module;
+    tensor.content->groupSize    = tensors.size();
+  }
+}
+
+void assemble(vector<TensorBase> tensors) {
+  taco_uassert(tensors.size() > 0) << "No tensors to assemble";
+  for (auto& tensor : tensors) {
+    taco_uassert(tensor.content->module == tensors[0].content->module &&
+                 tensor.content->groupSize == tensors.size()) <<
+        "The tensors must be assembled in the group they were compiled in";
+  }
+  vector<void*> arguments = packArguments(tensors);
+  tensors[0].content->module->callFuncPacked("assemble", arguments.data());
+  for (size_t i = 0; i < tensors.size(); i++) {
+    tensors[i].content->arguments = arguments;
+    tensors[i].setAssembledStorage(arguments[i]);
+  }
+}
+
+void compute(vector<TensorBase> tensors) {
+  taco_uassert(tensors.size() > 0) << "No tensors to compute";
+  for (auto& tensor : tensors) {
+    taco_uassert(tensor.content->module == tensors[0].content->module &&
+                 tensor.content->groupSize == tensors.size()) <<
+        "The tensors must be computed in the group they were compiled in";
+  }
+  vector<void*> arguments = packArguments(tensors);
+  for (auto& tensor : tensors) {
+    tensor.content->arguments = arguments;
+    tensor.zero();
+  }
+  tensors[0].content->module->callFuncPacked("compute", arguments.data());
+}
+
+void evaluate(vector<TensorBase> tensors) {
+  compile(tensors);
+  assemble(tensors);
+  compute(tensors);
+}
+
 void TensorBase::setExpr(const vector<taco::Var>& indexVars, taco::Expr expr) {
   // The following are index expressions we don't currently support, but that
   // are planned for the future.
@@ -564,25 +648,49 @@ void TensorBase::setExpr(const vector<taco::Var>& indexVars, taco::Expr expr) {
 
   content->indexVars = indexVars;
   content->expr = expr;
+  content->schedule = Schedule();
 
   storage::Storage storage = getStorage();
   Format format = storage.getFormat();
+  checkIndexWidths(format, getDimensions());
   auto& levels = format.getLevels();
   for (size_t i=0; i < levels.size(); ++i) {
     Level level = levels[i];
+    size_t indexValueSize = getNumBytes(level.getIndexWidth());
+    size_t posValueSize   = getNumBytes(level.getPosWidth());
     switch (level.getType()) {
       case DimensionType::Dense:
         break;
       case DimensionType::Sparse: {
-        auto pos = (int*)malloc(getAllocSize() * sizeof(int));
-        auto idx = (int*)malloc(getAllocSize() * sizeof(int));
-        pos[0] = 0;
+        // The first segment starts at zero
+        auto pos = calloc(getAllocSize(), posValueSize);
+        auto idx = malloc(getAllocSize() * indexValueSize);
         storage.setDimensionIndex(i, {pos,idx});
         break;
       }
-      case DimensionType::Fixed: {
-        auto pos = (int*)malloc(sizeof(int));
-        auto idx = (int*)malloc(getAllocSize() * sizeof(int));
+      case DimensionType::Fixed:
+      case DimensionType::Hashed: {
+        auto pos = malloc(posValueSize);
+        auto idx = malloc(getAllocSize() * indexValueSize);
+        storage.setDimensionIndex(i, {pos,idx});
+        break;
+      }
+      case DimensionType::Singleton: {
+        auto idx = malloc(getAllocSize() * indexValueSize);
+        storage.setDimensionIndex(i, {idx});
+        break;
+      }
+      case DimensionType::Bitmap: {
+        auto size = (int*)malloc(sizeof(int));
+        auto pos  = (int*)malloc(getAllocSize() * sizeof(int));
+        auto bits = (int*)malloc(getAllocSize() * sizeof(int));
+        size[0] = getDimensions()[level.getDimension()];
+        storage.setDimensionIndex(i, {size,pos,bits});
+        break;
+      }
+      case DimensionType::Delta: {
+        auto pos = calloc(2 * getAllocSize(), posValueSize);
+        auto idx = malloc(getAllocSize());
         storage.setDimensionIndex(i, {pos,idx});
         break;
       }
@@ -590,6 +698,123 @@ void TensorBase::setExpr(const vector<taco::Var>& indexVars, taco::Expr expr) {
   }
 }
 
+void TensorBase::reorder(const vector<taco::Var>& order) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  content->schedule.reorder(order);
+}
+
+void TensorBase::split(taco::Var var, taco::Var outer, taco::Var inner,
+                       int factor) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  content->schedule.split(var, outer, inner, factor);
+}
+
+void TensorBase::parallelize(taco::Var var) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  content->schedule.parallelize(var);
+}
+
+void TensorBase::parallelizeNonzeros(taco::Var var) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  content->schedule.parallelizeNonzeros(var);
+}
+
+void TensorBase::vectorize(taco::Var var) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  content->schedule.vectorize(var);
+}
+
+void TensorBase::accumulate(ComponentType ctype) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  content->schedule.accumulate(ctype);
+}
+
+/// Replaces reads of a producer tensor with the producer's expression, with its
+/// free variables renamed to the variables of the read. The reduction
+/// variables of the producer are renamed to new variables for every read.
+struct FuseProducer : public ExprRewriter {
+  using ExprRewriter::visit;
+
+  TensorBase producer;
+  TensorBase consumer;
+  bool       hasReductions;
+  int        enclosingNonProducts = 0;
+
+  FuseProducer(TensorBase producer, TensorBase consumer)
+      : producer(producer), consumer(consumer), hasReductions(false) {
+    match(producer.getExpr(),
+      function<void(const ReadNode*)>([this](const ReadNode* op) {
+        for (auto& var : op->indexVars) {
+          hasReductions |= var.isReduction();
+        }
+      })
+    );
+  }
+
+  /// Renames the index variables of an expression's reads.
+  struct RenameVars : public ExprRewriter {
+    using ExprRewriter::visit;
+    map<taco::Var,taco::Var> renames;
+
+    void visit(const ReadNode* op) {
+      vector<taco::Var> indexVars;
+      for (auto& var : op->indexVars) {
+        if (!util::contains(renames, var)) {
+          taco_iassert(var.isReduction());
+          renames.insert({var, taco::Var(var.getName(), taco::Var::Sum)});
+        }
+        indexVars.push_back(renames.at(var));
+      }
+      expr = new ReadNode(op->tensor, indexVars);
+    }
+  };
+
+  void visit(const ReadNode* op) {
+    if (op->tensor != producer) {
+      expr = op;
+      return;
+    }
+    // Sums only distribute over products, so a producer that reduces can only
+    // be multiplied with the rest of the consumer's expression
+    taco_uassert(!hasReductions || enclosingNonProducts == 0) <<
+        "Cannot fuse " << producer.getName() << ", whose expression has " <<
+        "reduction variables, into " << consumer.getName() << " since it " <<
+        "is not only multiplied in " << consumer.getExpr();
+    RenameVars rename;
+    for (size_t i = 0; i < op->indexVars.size(); i++) {
+      rename.renames.insert({producer.getIndexVars()[i], op->indexVars[i]});
+    }
+    expr = rename.rewrite(producer.getExpr());
+  }
+
+  template <class T>
+  void visitNonProduct(const T* op) {
+    enclosingNonProducts++;
+    ExprRewriter::visit(op);
+    enclosingNonProducts--;
+  }
+
+  void visit(const SqrtNode* op) {visitNonProduct(op);}
+  void visit(const AddNode* op)  {visitNonProduct(op);}
+  void visit(const SubNode* op)  {visitNonProduct(op);}
+  void visit(const DivNode* op)  {visitNonProduct(op);}
+};
+
+void TensorBase::fuse(TensorBase producer) {
+  taco_uassert(getExpr().defined()) << "No expression defined for tensor";
+  taco_uassert(producer.getExpr().defined()) <<
+      "No expression defined for " << producer.getName();
+  vector<TensorBase> operands = expr_nodes::getOperands(getExpr());
+  taco_uassert(util::contains(operands, producer)) <<
+      producer.getName() << " is not an operand of " << getName() << "(" <<
+      util::join(getIndexVars()) << ") = " << getExpr();
+  content->expr = FuseProducer(producer, *this).rewrite(getExpr());
+}
+
+const Schedule& TensorBase::getSchedule() const {
+  return content->schedule;
+}
+
 void TensorBase::printComputeIR(ostream& os, bool color, bool simplify) const {
   IRPrinter printer(os, color, simplify);
   printer.print(content->computeFunc.as<Function>()->body);
@@ -610,6 +835,27 @@ void TensorBase::compileSource(std::string source) {
   content->module->compile();
 }
 
+template <typename T>
+static bool equalsValues(const TensorBase& a, const TensorBase& b) {
+  auto at = iterate<T>(a);
+  auto bt = iterate<T>(b);
+  auto ait = at.begin();
+  auto bit = bt.begin();
+
+  for (; ait != at.end() && bit != bt.end(); ++ait, ++bit) {
+    if (ait->first != bit->first) {
+      return false;
+    }
+    double aval = ait->second;
+    double bval = bit->second;
+    if (abs((aval - bval)/aval) > 10e-6) {
+      return false;
+    }
+  }
+
+  return (ait == at.end() && bit == bt.end());
+}
+
 bool equals(const TensorBase& a, const TensorBase& b) {
   // Component type must be the same
   if (a.getComponentType() != b.getComponentType()) {
@@ -627,21 +873,24 @@ bool equals(const TensorBase& a, const TensorBase& b) {
   }
 
   // Values must be the same
-  auto at = iterate<double>(a);
-  auto bt = iterate<double>(b);
-  auto ait = at.begin();
-  auto bit = bt.begin();
-
-  for (; ait != at.end() && bit != bt.end(); ++ait, ++bit) {
-    if (ait->first != bit->first) {
-      return false;
-    }
-    if (abs((ait->second - bit->second)/ait->second) > 10e-6) {
-      return false;
-    }
+  switch (a.getComponentType().getKind()) {
+    case ComponentType::Bool:
+      return equalsValues<bool>(a, b);
+    case ComponentType::Int:
+      return equalsValues<int>(a, b);
+    case ComponentType::Int64:
+      return equalsValues<int64_t>(a, b);
+    case ComponentType::Float:
+      return equalsValues<float>(a, b);
+    case ComponentType::Double:
+      return equalsValues<double>(a, b);
+    case ComponentType::Pattern:
+      return equalsValues<bool>(a, b);
+    case ComponentType::Unknown:
+      break;
   }
-
-  return (ait == at.end() && bit == bt.end());
+  taco_unreachable;
+  return false;
 }
 
 bool operator==(const TensorBase& a, const TensorBase& b) {
@@ -670,27 +919,38 @@ bool operator>=(const TensorBase& a, const TensorBase& b) {
 
 void TensorBase::assembleInternal() {
   content->module->callFuncPacked("assemble", content->arguments.data());
+  setAssembledStorage(content->arguments[0]);
+}
 
+void TensorBase::setAssembledStorage(void* data) {
   auto storage = getStorage();
   auto format = storage.getFormat();
-  taco_tensor_t* tensorData = ((taco_tensor_t*)content->arguments[0]);
+  taco_tensor_t* tensorData = (taco_tensor_t*)data;
   for (size_t i = 0; i < getOrder(); i++) {
     auto dimType  = format.getLevels()[i];
     switch (dimType.getType()) {
       case DimensionType::Dense:
         break;
       case DimensionType::Sparse:
-        storage.setDimensionIndex(i, {(int*)tensorData->indices[i][0],
-                                      (int*)tensorData->indices[i][1]});
-        break;
       case DimensionType::Fixed:
-        taco_not_supported_yet;
+      case DimensionType::Hashed:
+      case DimensionType::Delta:
+        storage.setDimensionIndex(i, {tensorData->indices[i][0],
+                                      tensorData->indices[i][1]});
+        break;
+      case DimensionType::Singleton:
+        storage.setDimensionIndex(i, {tensorData->indices[i][1]});
+        break;
+      case DimensionType::Bitmap:
+        storage.setDimensionIndex(i, {tensorData->indices[i][2],
+                                      tensorData->indices[i][0],
+                                      tensorData->indices[i][1]});
         break;
     }
   }
 
   content->valuesSize = storage.getSize().numValues();
-  storage.setValues((double*)malloc(content->valuesSize*sizeof(double)));
+  storage.setValues(malloc(content->valuesSize*getComponentType().bytes()));
   tensorData->vals = (uint8_t*)storage.getValues();
 }
 
@@ -711,7 +971,8 @@ ostream& operator<<(ostream& os, const TensorBase& tensor) {
   for (size_t i = 0; i < numCoordinates; i++) {
     int* ptr = (int*)&tensor.coordinateBuffer->data()[i*tensor.coordinateSize];
     os << "(" << util::join(ptr, ptr+tensor.getOrder()) << "): "
-       << ((double*)(ptr+tensor.getOrder()))[0] << std::endl;
+       << getComponentValue(ptr+tensor.getOrder(), tensor.getComponentType(), 0)
+       << std::endl;
   }
 
   // Print packed data
@@ -725,38 +986,52 @@ static string getExtension(string filename) {
 }
 
 template <typename T>
-TensorBase dispatchRead(T& file, FileType filetype, Format format, bool pack) {
+TensorBase dispatchRead(T& file, FileType filetype, Format format,
+                        const vector<CoordinateRange>& ranges, bool pack) {
   TensorBase tensor;
   switch (filetype) {
     case FileType::ttx:
     case FileType::mtx:
-      tensor = io::mtx::read(file, format, pack);
+      tensor = io::mtx::read(file, format, ranges, pack);
       break;
     case FileType::tns:
-      tensor = io::tns::read(file, format, pack);
+      tensor = io::tns::read(file, format, ranges, pack);
       break;
     case FileType::rb:
-      tensor = io::rb::read(file, format, pack);
+      tensor = io::rb::read(file, format, ranges, pack);
       break;
   }
   return tensor;
 }
 
 TensorBase read(std::string filename, Format format, bool pack) {
-  string extension = getExtension(filename);
+  return read(filename, format, {}, pack);
+}
+
+TensorBase read(string filename, FileType filetype, Format format, bool pack) {
+  return read(filename, filetype, format, {}, pack);
+}
+
+TensorBase read(istream& stream, FileType filetype,  Format format, bool pack) {
+  return dispatchRead(stream, filetype, format, {}, pack);
+}
+
+TensorBase read(std::string filename, Format format,
+                const vector<CoordinateRange>& ranges, bool pack) {
+  string extension = getExtension(io::getUncompressedName(filename));
 
   TensorBase tensor;
   if (extension == "ttx") {
-    tensor = dispatchRead(filename, FileType::ttx, format, pack);
+    tensor = read(filename, FileType::ttx, format, ranges, pack);
   }
   else if (extension == "tns") {
-    tensor = dispatchRead(filename, FileType::tns, format, pack);
+    tensor = read(filename, FileType::tns, format, ranges, pack);
   }
   else if (extension == "mtx") {
-    tensor = dispatchRead(filename, FileType::mtx, format, pack);
+    tensor = read(filename, FileType::mtx, format, ranges, pack);
   }
   else if (extension == "rb") {
-    tensor = dispatchRead(filename, FileType::rb, format, pack);
+    tensor = read(filename, FileType::rb, format, ranges, pack);
   }
   else {
     taco_uerror << "File extension not recognized: " << filename << std::endl;
@@ -769,12 +1044,89 @@ TensorBase read(std::string filename, Format format, bool pack) {
   return tensor;
 }
 
-TensorBase read(string filename, FileType filetype, Format format, bool pack) {
-  return dispatchRead(filename, filetype, format, pack);
+TensorBase read(string filename, FileType filetype, Format format,
+                const vector<CoordinateRange>& ranges, bool pack) {
+  // Compressed files are decompressed as they are parsed
+  if (io::isCompressed(filename)) {
+    io::DecompressStream stream(filename);
+    return dispatchRead(stream, filetype, format, ranges, pack);
+  }
+  return dispatchRead(filename, filetype, format, ranges, pack);
 }
 
-TensorBase read(istream& stream, FileType filetype,  Format format, bool pack) {
-  return dispatchRead(stream, filetype, format, pack);
+TensorBase read(istream& stream, FileType filetype, Format format,
+                const vector<CoordinateRange>& ranges, bool pack) {
+  return dispatchRead(stream, filetype, format, ranges, pack);
+}
+
+template <typename T>
+FileInfo dispatchProbe(T& file, FileType filetype) {
+  FileInfo info;
+  switch (filetype) {
+    case FileType::ttx:
+    case FileType::mtx:
+      info = io::mtx::probe(file);
+      break;
+    case FileType::tns:
+      info = io::tns::probe(file);
+      break;
+    case FileType::rb:
+      info = io::rb::probe(file);
+      break;
+  }
+  return info;
+}
+
+FileInfo probe(std::string filename) {
+  string extension = getExtension(io::getUncompressedName(filename));
+
+  FileInfo info;
+  if (extension == "ttx") {
+    info = probe(filename, FileType::ttx);
+  }
+  else if (extension == "tns") {
+    info = probe(filename, FileType::tns);
+  }
+  else if (extension == "mtx") {
+    info = probe(filename, FileType::mtx);
+  }
+  else if (extension == "rb") {
+    info = probe(filename, FileType::rb);
+  }
+  else {
+    taco_uerror << "File extension not recognized: " << filename << std::endl;
+  }
+  return info;
+}
+
+FileInfo probe(string filename, FileType filetype) {
+  if (io::isCompressed(filename)) {
+    io::DecompressStream stream(filename);
+    return dispatchProbe(stream, filetype);
+  }
+  return dispatchProbe(filename, filetype);
+}
+
+FileInfo probe(istream& stream, FileType filetype) {
+  return dispatchProbe(stream, filetype);
+}
+
+std::ostream& operator<<(std::ostream& os, const Symmetry& symmetry) {
+  switch (symmetry) {
+    case Symmetry::General:
+      os << "general";
+      break;
+    case Symmetry::Symmetric:
+      os << "symmetric";
+      break;
+    case Symmetry::SkewSymmetric:
+      os << "skew-symmetric";
+      break;
+    case Symmetry::Hermitian:
+      os << "hermitian";
+      break;
+  }
+  return os;
 }
 
 template <typename T>
@@ -829,4 +1181,119 @@ void packOperands(const TensorBase& tensor) {
   }
 }
 
+template <typename T>
+static set<vector<int>> getBlocksOf(const TensorBase& tensor, int blockSize) {
+  set<vector<int>> blocks;
+  for (auto& value : iterate<T>(tensor)) {
+    vector<int> block;
+    for (int coordinate : value.first) {
+      block.push_back(coordinate / blockSize);
+    }
+    blocks.insert(block);
+  }
+  return blocks;
+}
+
+/// Returns the blocks of the given size that hold nonzeros of a tensor.
+static set<vector<int>> getBlocks(const TensorBase& tensor, int blockSize) {
+  switch (tensor.getComponentType().getKind()) {
+    case ComponentType::Bool:
+    case ComponentType::Pattern:
+      return getBlocksOf<bool>(tensor, blockSize);
+    case ComponentType::Int:
+      return getBlocksOf<int>(tensor, blockSize);
+    case ComponentType::Int64:
+      return getBlocksOf<int64_t>(tensor, blockSize);
+    case ComponentType::Float:
+      return getBlocksOf<float>(tensor, blockSize);
+    case ComponentType::Double:
+      return getBlocksOf<double>(tensor, blockSize);
+    case ComponentType::Unknown:
+      break;
+  }
+  taco_unreachable;
+  return {};
+}
+
+int getBlockSize(const TensorBase& tensor) {
+  size_t numNonzeros = getBlocks(tensor, 1).size();
+
+  for (int blockSize = 16; blockSize > 1; blockSize /= 2) {
+    bool divides = true;
+    for (int dimension : tensor.getDimensions()) {
+      divides = divides && (dimension % blockSize == 0);
+    }
+    if (!divides) {
+      continue;
+    }
+
+    set<vector<int>> blocks = getBlocks(tensor, blockSize);
+    size_t blockVolume = 1;
+    for (size_t i = 0; i < tensor.getOrder(); i++) {
+      blockVolume *= blockSize;
+    }
+    if (blocks.size() * blockVolume <= 2 * numNonzeros) {
+      return blockSize;
+    }
+  }
+  return 1;
+}
+
+/// Inserts the components of a tensor into its blocked copy and packs it. The
+/// copy is packed through the typed tensor that the components were inserted
+/// into, since tensors count their own inserted coordinates.
+template <typename T>
+static TensorBase blockOf(const TensorBase& tensor, int blockSize,
+                          Tensor<T> blocked) {
+  size_t order = tensor.getOrder();
+  vector<int> coordinate(2*order);
+  for (auto& value : iterate<T>(tensor)) {
+    for (size_t i = 0; i < order; i++) {
+      coordinate[i]       = value.first[i] / blockSize;
+      coordinate[order+i] = value.first[i] % blockSize;
+    }
+    blocked.insert(coordinate, value.second);
+  }
+  blocked.pack();
+  return blocked;
+}
+
+TensorBase block(const TensorBase& tensor, int blockSize, Format format) {
+  size_t order = tensor.getOrder();
+  taco_uassert(format.getOrder() == 2*order) <<
+      "The format of a blocked tensor must have twice the order of the " <<
+      "tensor (" << format.getOrder() << " != " << 2*order << ")";
+  taco_uassert(blockSize > 0) << "Blocks must have a positive size";
+
+  vector<int> dimensions(2*order);
+  for (size_t i = 0; i < order; i++) {
+    int dimension = tensor.getDimensions()[i];
+    taco_uassert(dimension % blockSize == 0) <<
+        "Dimension " << i << " of " << tensor.getName() << " (" <<
+        dimension << ") is not a multiple of the block size " << blockSize;
+    dimensions[i]       = dimension / blockSize;
+    dimensions[order+i] = blockSize;
+  }
+
+  TensorBase blocked(tensor.getName(), tensor.getComponentType(), dimensions,
+                     format);
+  switch (tensor.getComponentType().getKind()) {
+    case ComponentType::Bool:
+    case ComponentType::Pattern:
+      return blockOf<bool>(tensor, blockSize, blocked);
+    case ComponentType::Int:
+      return blockOf<int>(tensor, blockSize, blocked);
+    case ComponentType::Int64:
+      return blockOf<int64_t>(tensor, blockSize, blocked);
+    case ComponentType::Float:
+      return blockOf<float>(tensor, blockSize, blocked);
+    case ComponentType::Double:
+      return blockOf<double>(tensor, blockSize, blocked);
+    case ComponentType::Unknown:
+      break;
+  }
+  taco_unreachable;
+  return blocked;
+}
+
 }
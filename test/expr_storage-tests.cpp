@@ -203,6 +203,104 @@ INSTANTIATE_TEST_CASE_P(vector_elmul, expr,
                       }
                     },
                     {40.0}
+                    ),
+           TestData(Tensor<double>("a",{5},Format({Sparse})),
+                    {i},
+                    d5a("b",Format({Bitmap}))(i) *
+                    d5b("c",Format({Bitmap}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,1},
+                        {1}
+                      }
+                    },
+                    {40.0}
+                    )
+           )
+);
+
+// Intersections of a very sparse vector with long vectors (galloping merge)
+INSTANTIATE_TEST_CASE_P(vector_elmul_skewed, expr,
+    Values(
+           TestData(Tensor<double>("a",{10000},Format({Sparse})),
+                    {i},
+                    dla("b",Format({Sparse}))(i) *
+                    dlc("c",Format({Sparse}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {0,6,9000}
+                      }
+                    },
+                    {0.0, 12.0, 36000.0}
+                    ),
+           TestData(Tensor<double>("a",{10000},Format({Sparse})),
+                    {i},
+                    dlc("b",Format({Sparse}))(i) *
+                    dla("c",Format({Sparse}))(i) *
+                    dlb("d",Format({Sparse}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {0,6,9000}
+                      }
+                    },
+                    {0.0, 72.0, 324000000.0}
+                    ),
+           TestData(Tensor<double>("a",{10000},Format({Sparse})),
+                    {i},
+                    dla("b",Format({Sparse}))(i) *
+                    dlc("c",Format({Hashed}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {0,6,9000}
+                      }
+                    },
+                    {0.0, 12.0, 36000.0}
+                    ),
+           TestData(Tensor<double>("a",{10000},Format({Sparse})),
+                    {i},
+                    dla("b",Format({Sparse}))(i) *
+                    dlc("c",Format({Bitmap}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {0,6,9000}
+                      }
+                    },
+                    {0.0, 12.0, 36000.0}
+                    ),
+           TestData(Tensor<double>("a",{10000},Format({Sparse})),
+                    {i},
+                    dla("b",Format({Sparse}))(i) *
+                    dlc("c",Format({Delta}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {0,6,9000}
+                      }
+                    },
+                    {0.0, 12.0, 36000.0}
+                    ),
+           TestData(Tensor<double>("a",{10000},Format({Sparse})),
+                    {i},
+                    dla("b",Format({Bitmap}))(i) *
+                    dlc("c",Format({Bitmap}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {0,6,9000}
+                      }
+                    },
+                    {0.0, 12.0, 36000.0}
                     )
            )
 );
@@ -258,6 +356,32 @@ INSTANTIATE_TEST_CASE_P(vector_add, expr,
                       }
                     },
                     {10.0, 22.0, 3.0}
+                    ),
+           TestData(Tensor<double>("a",{5},Format({Sparse})),
+                    {i},
+                    d5a("b",Format({Bitmap}))(i) +
+                    d5c("c",Format({Bitmap}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {1, 3, 4}
+                      }
+                    },
+                    {102.0, 200.0, 303.0}
+                    ),
+           TestData(Tensor<double>("a",{5},Format({Sparse})),
+                    {i},
+                    d5a("b",Format({Delta}))(i) +
+                    d5c("c",Format({Delta}))(i),
+                    {
+                      {
+                        // Sparse index
+                        {0,3},
+                        {1, 3, 4}
+                      }
+                    },
+                    {102.0, 200.0, 303.0}
                     )
            )
 );
@@ -501,6 +625,24 @@ INSTANTIATE_TEST_CASE_P(matrix_add, expr,
                     0,  0,  0,
                     3, 30,  4}
                   ),
+         TestData(Tensor<double>("A",{3,3},Format({Dense,Dense})),
+                  {i,j},
+                  d33a("B",Format({Dense,Fixed}))(i,j) +
+                  d33b("C",Format({Dense,Sparse}))(i,j),
+                  {
+                    {
+                      // Dense index
+                      {3}
+                    },
+                    {
+                      // Dense index
+                      {3}
+                    }
+                  },
+                  {10, 22,  0,
+                    0,  0,  0,
+                    3, 30,  4}
+                  ),
          TestData(Tensor<double>("A",{3,3},Format({Dense,Sparse})),
                   {i,j},
                   d33a("B",Format({Dense,Sparse}))(i,j) +
@@ -535,6 +677,25 @@ INSTANTIATE_TEST_CASE_P(matrix_add, expr,
                     }
                   },
                   {10.0, 22.0, 3.0, 30.0, 4.0}
+                  ),
+         TestData(Tensor<double>("A",{3,3},
+                                 Format({Sparse,Sparse}, {0,1}, {Int64,UInt16})),
+                  {i,j},
+                  d33a("B",Format({Sparse,Sparse}, {0,1}, {Int32,UInt16}))(i,j) +
+                  d33b("C",Format({Sparse,Sparse}, {0,1}, {Int64,Int64}))(i,j),
+                  {
+                    {
+                      // Sparse index
+                      {0,2},
+                      {0,2}
+                    },
+                    {
+                      // Sparse index
+                      {0,2,5},
+                      {0,1,0,1,2}
+                    }
+                  },
+                  {10.0, 22.0, 3.0, 30.0, 4.0}
                   )
          )
 );
@@ -742,9 +903,117 @@ INSTANTIATE_TEST_CASE_P(spmv, expr,
                     },
                     {0,0,18}
                     ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Sparse}, {0,1}, {Int32,UInt16}))(i,k) *
+                    d3b("c",Format({Sparse}, {0}, {Int64}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Sparse}))(i,k) *
+                    d3b("c",Format({Sparse}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Sparse, Singleton}))(i,k) *
+                    d3b("c",Format({Dense}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
            TestData(Tensor<double>("a",{3},Format({Dense})),
                     {i},
                     d33a("B",Format({Dense, Sparse}))(i,k) *
+                    d3b("c",Format({Hashed}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Hashed}))(i,k) *
+                    d3b("c",Format({Dense}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Bitmap}))(i,k) *
+                    d3b("c",Format({Dense}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Delta}))(i,k) *
+                    d3b("c",Format({Dense}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Delta}))(i,k) *
+                    d3b("c",Format({Sparse}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Fixed}))(i,k) *
+                    d3b("c",Format({Dense}))(k),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                    },
+                    {0,0,18}
+                    ),
+           TestData(Tensor<double>("a",{3},Format({Dense})),
+                    {i},
+                    d33a("B",Format({Dense, Fixed}))(i,k) *
                     d3b("c",Format({Sparse}))(k),
                     {
                       {
@@ -831,6 +1100,63 @@ INSTANTIATE_TEST_CASE_P(matrix_mul, expr,
            )
 );
 
+INSTANTIATE_TEST_CASE_P(spgemm, expr,
+    Values(
+           TestData(Tensor<double>("A",{3,3},Format({Dense,Sparse})),
+                    {i,j},
+                    d33a("B",Format({Dense, Sparse}))(i,k) *
+                    d33a("C",Format({Dense, Sparse}))(k,j),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                      {
+                        // Sparse index
+                        {0, 0, 0, 3},
+                        {0, 1, 2}
+                      }
+                    },
+                    {12, 6, 16}
+                    ),
+           TestData(Tensor<double>("A",{3,3},Format({Dense,Sparse})),
+                    {i,j},
+                    d33a("B",Format({Dense, Sparse}))(i,k) *
+                    d33a("C",Format({Dense, Hashed}))(k,j),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                      {
+                        // Sparse index
+                        {0, 0, 0, 3},
+                        {0, 1, 2}
+                      }
+                    },
+                    {12, 6, 16}
+                    ),
+           TestData(Tensor<double>("A",{3,3},Format({Sparse,Sparse})),
+                    {i,j},
+                    d33a("B",Format({Sparse, Sparse}))(i,k) *
+                    d33a("C",Format({Sparse, Sparse}))(k,j),
+                    {
+                      {
+                        // Sparse index
+                        {0, 1},
+                        {2}
+                      },
+                      {
+                        // Sparse index
+                        {0, 3},
+                        {0, 1, 2}
+                      }
+                    },
+                    {12, 6, 16}
+                    )
+           )
+);
+
 INSTANTIATE_TEST_CASE_P(tensor_vector_mul, expr,
     Values(
            TestData(Tensor<double>("A",{3,3},Format({Dense,Dense})),
@@ -956,6 +1282,24 @@ INSTANTIATE_TEST_CASE_P(mttkrp, expr,
                         {3}
                       }
                     },
+                    {  0,  80,   0,
+                     180,   0,   0}
+                    ),
+           TestData(Tensor<double>("A",{2,3},Format({Dense,Dense})),
+                    {i,j},
+                    d233a("B",Format({Sparse, Singleton, Singleton}))(i,k,l) *
+                    d33a("C",Format({Dense, Dense}, {1,0}))(k,j) *
+                    d33b("D",Format({Dense, Dense}, {1,0}))(l,j),
+                    {
+                      {
+                        // Dense index
+                        {2}
+                      },
+                      {
+                        // Dense index
+                        {3}
+                      }
+                    },
                     {  0,  80,   0,
                      180,   0,   0}
                     )
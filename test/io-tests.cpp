@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include "test.h"
 
 #include "taco/tensor.h"
@@ -108,3 +110,161 @@ TEST(io, ttxsparse) {
 
   ASSERT_TRUE(equals(expected, tensor));
 }
+
+TEST(io, probe) {
+  FileInfo tns = probe(testDataDirectory()+"3tensor.tns");
+  ASSERT_VECTOR_EQ({1073,1,7}, tns.dimensions);
+  ASSERT_EQ(3u, tns.nnz);
+
+  FileInfo mtx = probe(testDataDirectory()+"2tensor.mtx");
+  ASSERT_VECTOR_EQ({32,32}, mtx.dimensions);
+  ASSERT_EQ(3u, mtx.nnz);
+  ASSERT_EQ(ComponentType::Double, mtx.ctype);
+  ASSERT_TRUE(Symmetry::General == mtx.symmetry);
+
+  FileInfo ttx = probe(testDataDirectory()+"d432.ttx");
+  ASSERT_VECTOR_EQ({4,3,2}, ttx.dimensions);
+  ASSERT_EQ(24u, ttx.nnz);
+
+  FileInfo rb = probe(testDataDirectory()+"rua_32.rb");
+  ASSERT_VECTOR_EQ({32,32}, rb.dimensions);
+  ASSERT_EQ(126u, rb.nnz);
+  ASSERT_TRUE(Symmetry::General == rb.symmetry);
+}
+
+TEST(io, mtxsymmetric) {
+  TensorBase tensor = read(testDataDirectory()+"s33.mtx", CSR);
+
+  TensorBase expected(ComponentType::Double, {3,3}, CSR);
+  expected.insert({0, 0}, 1.0);
+  expected.insert({1, 0}, 2.0);
+  expected.insert({0, 1}, 2.0);
+  expected.insert({2, 0}, 3.0);
+  expected.insert({0, 2}, 3.0);
+  expected.insert({2, 2}, 4.0);
+  expected.pack();
+
+  ASSERT_TRUE(equals(expected, tensor));
+  ASSERT_TRUE(Symmetry::Symmetric ==
+              probe(testDataDirectory()+"s33.mtx").symmetry);
+}
+
+TEST(io, mtxpattern) {
+  TensorBase tensor = read(testDataDirectory()+"p33.mtx", CSR);
+
+  TensorBase expected(ComponentType::Double, {3,3}, CSR);
+  expected.insert({0, 1}, 1.0);
+  expected.insert({1, 2}, 1.0);
+  expected.insert({2, 0}, 1.0);
+  expected.pack();
+
+  ASSERT_TRUE(equals(expected, tensor));
+  ASSERT_EQ(ComponentType::Bool, probe(testDataDirectory()+"p33.mtx").ctype);
+}
+
+#ifdef TACO_ZLIB
+TEST(io, mtxgzip) {
+  TensorBase tensor = read(testDataDirectory()+"2tensor.mtx.gz", Sparse);
+  ASSERT_EQ("2tensor", tensor.getName());
+
+  TensorBase expected = read(testDataDirectory()+"2tensor.mtx", Sparse);
+  ASSERT_TRUE(equals(expected, tensor));
+
+  FileInfo info = probe(testDataDirectory()+"2tensor.mtx.gz");
+  ASSERT_VECTOR_EQ({32,32}, info.dimensions);
+  ASSERT_EQ(3u, info.nnz);
+}
+#endif
+
+TEST(io, ttxdensepermuted) {
+  for (auto dimOrder : std::vector<std::vector<int>>({{0,1,2}, {2,0,1},
+                                                      {1,2,0}})) {
+    Format format({Dense,Dense,Dense}, dimOrder);
+    TensorBase tensor = read(testDataDirectory()+"d432.ttx", format);
+    ASSERT_EQ(format, tensor.getFormat());
+
+    // Packed from coordinates
+    TensorBase expected = read(testDataDirectory()+"d432.ttx",
+                               Format({Sparse,Sparse,Sparse}, dimOrder));
+    ASSERT_TRUE(equals(expected, tensor));
+  }
+}
+
+TEST(io, mtxdense) {
+  std::stringstream stream;
+  stream << "%%MatrixMarket matrix array real general" << std::endl
+         << "2 3" << std::endl
+         << "1\n2\n3\n4\n5\n6" << std::endl;
+
+  for (auto format : {Format({Dense,Dense}), Format({Dense,Dense}, {1,0}),
+                      Format({Dense,Sparse})}) {
+    TensorBase expected(ComponentType::Double, {2,3}, format);
+    expected.insert({0, 0}, 1.0);
+    expected.insert({1, 0}, 2.0);
+    expected.insert({0, 1}, 3.0);
+    expected.insert({1, 1}, 4.0);
+    expected.insert({0, 2}, 5.0);
+    expected.insert({1, 2}, 6.0);
+    expected.pack();
+
+    stream.clear();
+    stream.seekg(0);
+    TensorBase tensor = read(stream, FileType::mtx, format);
+    ASSERT_TRUE(equals(expected, tensor));
+  }
+
+  // Row-major storage holds the transpose of the column-major file
+  stream.clear();
+  stream.seekg(0);
+  TensorBase rowMajor = read(stream, FileType::mtx, Format({Dense,Dense}));
+  ASSERT_ARRAY_EQ(std::vector<double>({1.0, 3.0, 5.0, 2.0, 4.0, 6.0}),
+                  {(double*)rowMajor.getStorage().getValues(), 6});
+}
+
+TEST(io, ranges) {
+  // Rows [0,2) and columns [0,32) of a matrix
+  TensorBase mtx = read(testDataDirectory()+"2tensor.mtx", Sparse,
+                        {CoordinateRange(0,2), CoordinateRange(0,32)});
+  ASSERT_VECTOR_EQ({2,32}, mtx.getDimensions());
+  TensorBase mtxExpected(ComponentType::Double, {2,32}, Sparse);
+  mtxExpected.insert({0, 0}, 101.0);
+  mtxExpected.insert({1, 0}, 102.0);
+  mtxExpected.pack();
+  ASSERT_TRUE(equals(mtxExpected, mtx));
+
+  // Coordinates are relative to the start of the ranges
+  TensorBase tns = read(testDataDirectory()+"3tensor.tns", Sparse,
+                        {CoordinateRange(800,1073), CoordinateRange(0,1),
+                         CoordinateRange(5,7)});
+  ASSERT_VECTOR_EQ({273,1,2}, tns.getDimensions());
+  TensorBase tnsExpected(ComponentType::Double, {273,1,2}, Sparse);
+  tnsExpected.insert({272, 0, 0}, 1.1);
+  tnsExpected.insert({80,  0, 1}, 1.0);
+  tnsExpected.pack();
+  ASSERT_TRUE(equals(tnsExpected, tns));
+
+  TensorBase ttx = read(testDataDirectory()+"d432.ttx", Dense,
+                        {CoordinateRange(1,3), CoordinateRange(2,3),
+                         CoordinateRange(0,2)});
+  ASSERT_VECTOR_EQ({2,1,2}, ttx.getDimensions());
+  TensorBase ttxExpected(ComponentType::Double, {2,1,2}, Dense);
+  ttxExpected.insert({0, 0, 0}, 10.0);
+  ttxExpected.insert({1, 0, 0}, 11.0);
+  ttxExpected.insert({0, 0, 1}, 22.0);
+  ttxExpected.insert({1, 0, 1}, 23.0);
+  ttxExpected.pack();
+  ASSERT_TRUE(equals(ttxExpected, ttx));
+
+  // The row blocks of an rb matrix add up to the whole matrix
+  TensorBase rb = read(testDataDirectory()+"rua_32.rb", CSC);
+  TensorBase top = read(testDataDirectory()+"rua_32.rb", CSC,
+                        {CoordinateRange(0,16), CoordinateRange(0,32)});
+  TensorBase bottom = read(testDataDirectory()+"rua_32.rb", CSC,
+                           {CoordinateRange(16,32), CoordinateRange(0,32)});
+  ASSERT_EQ(rb.getStorage().getSize().numValues(),
+            top.getStorage().getSize().numValues() +
+            bottom.getStorage().getSize().numValues());
+  TensorBase topExpected = read(testDataDirectory()+"rua_32.mtx", CSC,
+                                {CoordinateRange(0,16), CoordinateRange(0,32)});
+  ASSERT_TRUE(equals(topExpected, top));
+}
@@ -0,0 +1,278 @@
+#include "test.h"
+#include "taco/tensor.h"
+#include "taco/expr.h"
+
+#include <dlfcn.h>
+
+using namespace taco;
+
+static Var i("i"), j("j"), k("k", Var::Sum);
+
+static Tensor<double> makeMatrix(string name, vector<int> dims, Format format) {
+  Tensor<double> tensor(name, dims, format);
+  for (int r = 0; r < dims[0]; r++) {
+    for (int c = 0; c < dims[1]; c++) {
+      if ((r + 2*c) % 3 != 0) {
+        tensor.insert({r, c}, (double)((r*dims[1] + c) % 7 + 1));
+      }
+    }
+  }
+  tensor.pack();
+  return tensor;
+}
+
+static Tensor<double> makeVector(string name, int dim, Format format) {
+  Tensor<double> tensor(name, {dim}, format);
+  for (int r = 0; r < dim; r++) {
+    tensor.insert({r}, (double)(r % 5 + 1));
+  }
+  tensor.pack();
+  return tensor;
+}
+
+TEST(schedule, tiled_matrix_mul) {
+  Format dense({Dense,Dense});
+  Tensor<double> B = makeMatrix("B", {10,9}, dense);
+  Tensor<double> C = makeMatrix("C", {9,11}, dense);
+
+  Tensor<double> expected("expected", {10,11}, dense);
+  expected(i,j) = B(i,k) * C(k,j);
+  expected.evaluate();
+
+  Var i0("i0"), i1("i1"), j0("j0"), j1("j1");
+  Var k0("k0", Var::Sum), k1("k1", Var::Sum);
+  Tensor<double> A("A", {10,11}, dense);
+  A(i,j) = B(i,k) * C(k,j);
+  A.split(i, i0, i1, 4);
+  A.split(k, k0, k1, 2);
+  A.split(j, j0, j1, 4);
+  A.reorder({i0, k0, j0, i1, k1, j1});
+  A.evaluate();
+
+  ASSERT_TRUE(equals(expected, A));
+}
+
+TEST(schedule, split_spmv) {
+  Tensor<double> B = makeMatrix("B", {10,9}, Format({Dense,Sparse}));
+  Tensor<double> c = makeVector("c", 9, Format({Dense}));
+
+  Tensor<double> expected("expected", {10}, Format({Dense}));
+  expected(i) = B(i,k) * c(k);
+  expected.evaluate();
+
+  Var i0("i0"), i1("i1");
+  Tensor<double> a("a", {10}, Format({Dense}));
+  a(i) = B(i,k) * c(k);
+  a.split(i, i0, i1, 3);
+  a.parallelize(i0);
+  a.evaluate();
+
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(schedule, vectorize_inner_product) {
+  Format dense({Dense,Dense});
+  Tensor<double> B = makeMatrix("B", {10,9}, dense);
+  Tensor<double> c = makeVector("c", 9, Format({Dense}));
+
+  Tensor<double> expected("expected", {10}, Format({Dense}));
+  expected(i) = B(i,k) * c(k);
+  expected.evaluate();
+
+  Tensor<double> a("a", {10}, Format({Dense}));
+  a(i) = B(i,k) * c(k);
+  a.vectorize(k);
+  a.evaluate();
+
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(schedule, vectorize_dense_inner_loops) {
+  Format dense({Dense,Dense});
+  Tensor<double> B = makeMatrix("B", {10,9}, dense);
+  Tensor<double> c = makeVector("c", 9, Format({Dense}));
+
+  Tensor<double> a("a", {10}, Format({Dense}));
+  a(i) = B(i,k) * c(k);
+  a.compile();
+  ASSERT_NE(string::npos, a.getSource().find("#pragma omp simd reduction(+:"));
+
+  // Loops over sparse dimensions are not vectorized
+  Tensor<double> d = makeMatrix("D", {10,9}, Format({Dense,Sparse}));
+  Tensor<double> e("e", {10}, Format({Dense}));
+  e(i) = d(i,k) * c(k);
+  e.compile();
+  ASSERT_EQ(string::npos, e.getSource().find("#pragma omp simd"));
+}
+
+TEST(schedule, unrolled_sparse_reductions) {
+  // Rows of B have 0 to 12 nonzeros, so some reductions are shorter than the
+  // unroll factor and most leave a remainder
+  Tensor<double> B("B", {13,12}, Format({Dense,Sparse}));
+  for (int r = 0; r < 13; r++) {
+    for (int c = 0; c < r; c++) {
+      B.insert({r, c}, (double)(r + c % 3 + 1));
+    }
+  }
+  B.pack();
+  Tensor<double> c = makeVector("c", 12, Format({Dense}));
+
+  Tensor<double> expected("expected", {13}, Format({Dense}));
+  for (int r = 0; r < 13; r++) {
+    double sum = 0.0;
+    for (int col = 0; col < r; col++) {
+      sum += (r + col % 3 + 1) * (double)(col % 5 + 1);
+    }
+    expected.insert({r}, sum);
+  }
+  expected.pack();
+
+  Tensor<double> a("a", {13}, Format({Dense}));
+  a(i) = B(i,k) * c(k);
+  a.evaluate();
+  ASSERT_NE(string::npos, a.getSource().find("B2_pos_end"));
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(schedule, parallelize_nonzeros_spmv) {
+  // A skewed matrix whose first row holds most nonzeros, with empty rows, so
+  // that partitions start and end inside rows
+  int n = 300;
+  Tensor<double> B("B", {n,n}, Format({Dense,Sparse}));
+  for (int r = 0; r < n; r++) {
+    int rowSize = (r == 0) ? n : ((r % 7 == 0) ? 0 : r % 5 + 1);
+    for (int c = 0; c < rowSize; c++) {
+      B.insert({r, (c * 13 + r) % n}, (double)((r + c) % 9 + 1));
+    }
+  }
+  B.pack();
+  Tensor<double> c = makeVector("c", n, Format({Dense}));
+
+  Tensor<double> expected("expected", {n}, Format({Dense}));
+  expected(i) = B(i,k) * c(k);
+  expected.evaluate();
+
+  Tensor<double> a("a", {n}, Format({Dense}));
+  a(i) = B(i,k) * c(k);
+  a.parallelizeNonzeros(i);
+  a.evaluate();
+  ASSERT_NE(string::npos, a.getSource().find("i_carry_vals"));
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(schedule, parallel_reductions) {
+  Tensor<double> B = makeMatrix("B", {10,9}, Format({Dense,Sparse}));
+  Tensor<double> C = makeMatrix("C", {10,9}, Format({Dense,Dense}));
+  Tensor<double> d = makeVector("d", 10, Format({Dense}));
+  Var l("l", Var::Sum);
+
+  // Inner product into a scalar
+  double innerProduct = 0.0;
+  for (int row = 0; row < 10; row++) {
+    for (int col = 0; col < 9; col++) {
+      if ((row + 2*col) % 3 != 0) {
+        double val = (double)((row*9 + col) % 7 + 1);
+        innerProduct += val * val;
+      }
+    }
+  }
+
+  Tensor<double> a("a", {}, Format());
+  a() = B(k,l) * C(k,l);
+  a.evaluate();
+  ASSERT_NE(string::npos, a.getSource().find("reduction(+:a_vals[:1])"));
+  ASSERT_DOUBLE_EQ(innerProduct, a.begin()->second);
+
+  // Column-wise reduction into a vector
+  Tensor<double> expectedColumns("expectedColumns", {9}, Format({Dense}));
+  for (int col = 0; col < 9; col++) {
+    double sum = 0.0;
+    for (int row = 0; row < 10; row++) {
+      if ((row + 2*col) % 3 != 0) {
+        sum += (double)((row*9 + col) % 7 + 1) * (double)(row % 5 + 1);
+      }
+    }
+    expectedColumns.insert({col}, sum);
+  }
+  expectedColumns.pack();
+
+  Tensor<double> e("e", {9}, Format({Dense}));
+  e(j) = B(k,j) * d(k);
+  e.parallelize(k);
+  e.evaluate();
+  ASSERT_NE(string::npos, e.getSource().find("reduction(+:e_vals[:9])"));
+  ASSERT_TRUE(equals(expectedColumns, e));
+}
+
+TEST(schedule, serial_delta_loops) {
+  Format dcsr({Sparse,Sparse});
+  Tensor<double> B = makeMatrix("B", {10,9}, dcsr);
+  Tensor<double> Z = makeMatrix("Z", {10,9}, Format({Delta,Delta}));
+  Tensor<double> x = makeVector("x", 9, Format({Dense}));
+
+  Tensor<double> expected("expected", {10}, Format({Dense}));
+  expected(i) = B(i,k) * x(k);
+  expected.evaluate();
+
+  // The root loop decodes the indices of Z in order, so it is not parallel
+  Tensor<double> y("y", {10}, Format({Dense}));
+  y(i) = Z(i,k) * x(k);
+  y.evaluate();
+  ASSERT_EQ(string::npos, y.getSource().find("#pragma omp parallel"));
+  ASSERT_TRUE(equals(expected, y));
+}
+
+TEST(schedule, parallel_reduction_runtime) {
+  Tensor<double> B = makeMatrix("B", {10,9}, Format({Dense,Sparse}));
+  Tensor<double> c = makeVector("c", 9, Format({Dense}));
+
+  double sum = 0.0;
+  for (auto& component : B) {
+    sum += component.second * (double)(component.first[1] % 5 + 1);
+  }
+
+  Var l("l", Var::Sum);
+  Tensor<double> a("a", {}, Format());
+  a() = B(k,l) * c(l);
+  a.evaluate();
+  ASSERT_NE(string::npos, a.getSource().find("#pragma omp parallel for"));
+  ASSERT_DOUBLE_EQ(sum, a.begin()->second);
+
+  // Kernels with parallel loops are linked with the OpenMP runtime, unless
+  // the flags they are compiled with are overridden
+  if (getenv("TACO_CFLAGS") == nullptr) {
+    ASSERT_TRUE(dlopen("libgomp.so.1", RTLD_LAZY | RTLD_NOLOAD) != nullptr ||
+                dlopen("libomp.so", RTLD_LAZY | RTLD_NOLOAD) != nullptr);
+  }
+}
+
+TEST(schedule, accumulate_in_double) {
+  // A float accumulator rounds off the small products added to 1, while a
+  // double accumulator keeps them
+  int n = 4000;
+  Tensor<float> B("B", {2,n}, Format({Dense,Sparse}));
+  Tensor<float> c("c", {n}, Format({Dense}));
+  double sum = 0.0;
+  for (int col = 0; col < n; col++) {
+    float val = (col == 0) ? 1.0f : 1e-7f;
+    B.insert({0, col}, val);
+    c.insert({col}, 1.0f);
+    sum += val;
+  }
+  B.pack();
+  c.pack();
+
+  Tensor<float> a("a", {2}, Format({Dense}));
+  a(i) = B(i,k) * c(k);
+  a.accumulate(ComponentType::Double);
+  a.evaluate();
+  ASSERT_NE(string::npos, a.getSource().find("double tk"));
+  ASSERT_NE(string::npos, a.getSource().find("float* restrict a_vals"));
+  ASSERT_FLOAT_EQ((float)sum, a.begin()->second);
+
+  Tensor<float> f("f", {2}, Format({Dense}));
+  f(i) = B(i,k) * c(k);
+  f.evaluate();
+  ASSERT_NE(string::npos, f.getSource().find("float tk"));
+  ASSERT_GT(std::abs((float)sum - f.begin()->second), 1e-6);
+}
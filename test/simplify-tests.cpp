@@ -0,0 +1,83 @@
+#include "test.h"
+#include "ir/ir.h"
+#include "ir/simplify.h"
+
+using namespace taco::ir;
+
+static Expr iB    = Var::make("iB", Type(Type::Int));
+static Expr jB    = Var::make("jB", Type(Type::Int));
+static Expr B2Pos = Var::make("B2_pos", Type(Type::Int), true);
+static Expr aVals = Var::make("a_vals", Type(Type::Float, 64), true);
+
+TEST(simplify, hoist_invariant_end) {
+  // for (int jB = 0; jB < B2_pos[iB + 1]; jB++) { a_vals[jB] = 1.0; }
+  Expr end = Load::make(B2Pos, Add::make(iB, 1));
+  Stmt store = Store::make(aVals, jB, Literal::make(1.0));
+  Stmt loop = For::make(jB, 0, end, 1, store);
+
+  // int jB_end = B2_pos[iB + 1];
+  // for (int jB = 0; jB < jB_end; jB++) { a_vals[jB] = 1.0; }
+  Stmt hoisted = hoistLoopInvariants(loop);
+  ASSERT_TRUE(isa<Block>(hoisted));
+  auto& contents = to<Block>(hoisted)->contents;
+  ASSERT_EQ(2u, contents.size());
+  ASSERT_TRUE(isa<VarAssign>(contents[0]));
+  auto decl = to<VarAssign>(contents[0]);
+  ASSERT_TRUE(decl->is_decl);
+  ASSERT_EQ("jB_end", to<Var>(decl->lhs)->name);
+  ASSERT_EQ(end, decl->rhs);
+  ASSERT_TRUE(isa<For>(contents[1]));
+  ASSERT_EQ(decl->lhs, to<For>(contents[1])->end);
+}
+
+TEST(simplify, no_hoist_modified_end) {
+  // for (int jB = 0; jB < B2_pos[iB]; jB++) { iB = iB + 1; }
+  Expr end = Load::make(B2Pos, iB);
+  Stmt assign = VarAssign::make(iB, Add::make(iB, 1));
+  Stmt loop = For::make(jB, 0, end, 1, assign);
+  ASSERT_EQ(loop, hoistLoopInvariants(loop));
+
+  // for (int jB = 0; jB < B2_pos[iB]; jB++) { B2_pos[jB] = 0; }
+  Stmt store = Store::make(B2Pos, jB, 0);
+  Stmt storeLoop = For::make(jB, 0, end, 1, store);
+  ASSERT_EQ(storeLoop, hoistLoopInvariants(storeLoop));
+}
+
+TEST(simplify, eliminate_repeated_load) {
+  // int x = B2_pos[iB + 1];
+  // int y = B2_pos[iB + 1];
+  // a_vals[x] = 1.0; a_vals[y] = 2.0;
+  Expr x = Var::make("x", Type(Type::Int));
+  Expr y = Var::make("y", Type(Type::Int));
+  Stmt block = Block::make({
+      VarAssign::make(x, Load::make(B2Pos, Add::make(iB, 1)), true),
+      VarAssign::make(y, Load::make(B2Pos, Add::make(iB, 1)), true),
+      Store::make(aVals, x, Literal::make(1.0)),
+      Store::make(aVals, y, Literal::make(2.0))
+  });
+
+  // int y = x;
+  Stmt eliminated = eliminateCommonSubexpressions(block);
+  auto& contents = to<Block>(eliminated)->contents;
+  ASSERT_EQ(4u, contents.size());
+  ASSERT_TRUE(isa<Load>(to<VarAssign>(contents[0])->rhs));
+  ASSERT_EQ(x, to<VarAssign>(contents[1])->rhs);
+
+  // The copy is then propagated, leaving one temporary
+  Stmt simplified = simplify(block);
+  auto& simplifiedContents = to<Block>(simplified)->contents;
+  ASSERT_EQ(3u, simplifiedContents.size());
+  ASSERT_EQ(x, to<Store>(simplifiedContents[2])->loc);
+}
+
+TEST(simplify, no_eliminate_across_store) {
+  // The second load reads a value stored after the first load
+  Expr x = Var::make("x", Type(Type::Int));
+  Expr y = Var::make("y", Type(Type::Int));
+  Stmt block = Block::make({
+      VarAssign::make(x, Load::make(B2Pos, iB), true),
+      Store::make(B2Pos, iB, 0),
+      VarAssign::make(y, Load::make(B2Pos, iB), true)
+  });
+  ASSERT_EQ(block, eliminateCommonSubexpressions(block));
+}
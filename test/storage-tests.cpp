@@ -19,6 +19,13 @@ using taco::Format;
 const auto Dense = taco::DimensionType::Dense;
 const auto Sparse = taco::DimensionType::Sparse;
 const auto Fixed = taco::DimensionType::Fixed;
+const auto Singleton = taco::DimensionType::Singleton;
+const auto Hashed = taco::DimensionType::Hashed;
+const auto Bitmap = taco::DimensionType::Bitmap;
+const auto Delta = taco::DimensionType::Delta;
+const auto UInt16 = taco::IndexWidth::UInt16;
+const auto Int32 = taco::IndexWidth::Int32;
+const auto Int64 = taco::IndexWidth::Int64;
 
 struct TestData {
   TestData(Tensor<double> tensor,
@@ -123,6 +130,47 @@ INSTANTIATE_TEST_CASE_P(vector, storage,
                       },
                     },
                     {2, 3}
+                    ),
+            TestData(d5a("a", Format({Hashed})),
+                    {
+                      {
+                        // Hashed index
+                        {4},
+                        {4,1,-1,-1}
+                      },
+                    },
+                    {3, 2, 0, 0}
+                    ),
+            TestData(d5a("a", Format({Bitmap})),
+                    {
+                      {
+                        // Bitmap index
+                        {5},
+                        {0,2},
+                        {18}
+                      },
+                    },
+                    {2, 3}
+                    ),
+            TestData(d5a("a", Format({Delta})),
+                    {
+                      {
+                        // Delta index
+                        {0,0,2,2},
+                        {1,3}
+                      },
+                    },
+                    {2, 3}
+                    ),
+            TestData(dlc("a", Format({Delta})),
+                    {
+                      {
+                        // Delta index: deltas 0, 6, 4993, 4001 and 999
+                        {0,0,5,8},
+                        {0,6,129,39,161,31,231,7}
+                      },
+                    },
+                    {1, 2, 3, 4, 5}
                     )
            )
 );
@@ -216,11 +264,72 @@ INSTANTIATE_TEST_CASE_P(fixed, storage,
                      {
                          // Fixed index
                          {2},
-                         {1, 1, 0, 0, 0, 2},
+                         {1, 1, -1, -1, 0, 2},
                      }
                  },
                  {2, 0, 0, 0, 3, 4}
         ),
+        TestData(d33a("A", Format({Sparse,Singleton})),  // COO
+                 {
+                     {
+                         // Sparse index
+                         {0, 3},
+                         {0, 2, 2},
+                     },
+                     {
+                         // Singleton index
+                         {1, 0, 2}
+                     }
+                 },
+                 {2, 3, 4}
+        ),
+        TestData(d33a("A", Format({Dense,Hashed})),
+                 {
+                     {
+                         // Dense index
+                         {3}
+                     },
+                     {
+                         // Hashed index
+                         {4},
+                         {-1, 1, -1, -1,
+                          -1,-1, -1, -1,
+                           0,-1,  2, -1},
+                     }
+                 },
+                 {0, 2, 0, 0,
+                  0, 0, 0, 0,
+                  3, 0, 4, 0}
+        ),
+        TestData(d33a("A", Format({Dense,Bitmap})),
+                 {
+                     {
+                         // Dense index
+                         {3}
+                     },
+                     {
+                         // Bitmap index
+                         {3},
+                         {0, 1, 1, 3},
+                         {2, 0, 5}
+                     }
+                 },
+                 {2, 3, 4}
+        ),
+        TestData(d33a("A", Format({Dense,Delta})),
+                 {
+                     {
+                         // Dense index
+                         {3}
+                     },
+                     {
+                         // Delta index
+                         {0,0, 1,1, 1,1, 3,3},
+                         {1, 0, 2}
+                     }
+                 },
+                 {2, 3, 4}
+        ),
         TestData(d33a("A", Format({Fixed,Dense})),
                  {
                      {
@@ -398,7 +507,7 @@ INSTANTIATE_TEST_CASE_P(fixed, storage,
                      {
                          // Fixed index
                          {2},
-                         {0, 1, 0, 0, 2, 2, 1, 1, 0, 0, 0, 2}
+                         {0, 1, -1, -1, 2, 2, 1, 1, -1, -1, 0, 2}
                      }
                  },
                  {2, 3, 0, 0, 4, 0, 5, 0, 0, 0, 6, 7}
@@ -435,7 +544,7 @@ INSTANTIATE_TEST_CASE_P(fixed, storage,
                      {
                          // Fixed index
                          {2},
-                         {0, 1, 0, 0, 2, 2, 1, 1, 0, 0, 0, 2}
+                         {0, 1, -1, -1, 2, 2, 1, 1, -1, -1, 0, 2}
                      }
                  },
                  {2, 3, 0, 0, 4, 0, 5, 0, 0, 0, 6, 7}
@@ -527,6 +636,53 @@ INSTANTIATE_TEST_CASE_P(matrix_blocked, storage,
            )
 );
 
+INSTANTIATE_TEST_CASE_P(index_width, storage,
+    Values(TestData(d33a("A", Format({Dense,Sparse}, {0,1}, {Int32,UInt16})),
+                    {
+                      {
+                        // Dense index
+                        {3}
+                      },
+                      {
+                        // Sparse index
+                        {0, 1, 1, 3},
+                        {1, 0, 2},
+                      }
+                    },
+                    {2, 3, 4}
+                    ),
+           TestData(d33a("A", Format({Sparse,Sparse}, {0,1}, {Int64,UInt16})),
+                    {
+                      {
+                        // Sparse index
+                        {0, 2},
+                        {0, 2},
+                      },
+                      {
+                        // Sparse index
+                        {0, 1, 3},
+                        {1, 0, 2},
+                      }
+                    },
+                    {2, 3, 4}
+                    ),
+           TestData(d33a("A", Format({Sparse,Singleton}, {0,1}, {Int64,UInt16})),
+                    {
+                      {
+                        // Sparse index
+                        {0, 3},
+                        {0, 2, 2},
+                      },
+                      {
+                        // Singleton index
+                        {1, 0, 2},
+                      }
+                    },
+                    {2, 3, 4}
+                    )
+           )
+);
+
 INSTANTIATE_TEST_CASE_P(matrix_col, storage,
     Values(TestData(d33a("A", Format({Dense,Dense}, {1,0})),
                     {
@@ -1,6 +1,9 @@
 #include "test.h"
 #include "taco/tensor.h"
 
+#include <limits>
+#include <map>
+#include <sstream>
 #include <vector>
 #include "taco/util/collections.h"
 
@@ -36,3 +39,521 @@ TEST(tensor, double_vector) {
     ASSERT_EQ(vals.at(val.first), val.second);
   }
 }
+
+TEST(tensor, float_scalar) {
+  Tensor<float> a(4.2f);
+  ASSERT_EQ(ComponentType::Float, a.getComponentType());
+  ASSERT_FLOAT_EQ(4.2f, a.begin()->second);
+}
+
+template <typename T>
+static void testSpMV(ComponentType ctype) {
+  Var i("i"), j("j", Var::Sum);
+  Tensor<T> B("B", {3,3}, Format({Dense,Sparse}));
+  Tensor<T> c("c", {3}, Format({Dense}));
+  Tensor<T> a("a", {3}, Format({Dense}));
+  ASSERT_EQ(ctype, a.getComponentType());
+  B.insert({0,1}, 2);
+  B.insert({2,0}, 3);
+  B.insert({2,2}, 4);
+  B.pack();
+  ASSERT_EQ(sizeof(T), B.getStorage().getSize().numBytesPerValue());
+  c.insert({0}, 1);
+  c.insert({2}, 1);
+  c.pack();
+
+  a(i) = B(i,j) * c(j);
+  a.evaluate();
+
+  Tensor<T> expected("expected", {3}, Format({Dense}));
+  expected.insert({2}, 7);
+  expected.pack();
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(tensor, component_types) {
+  testSpMV<double>(ComponentType::Double);
+  testSpMV<float>(ComponentType::Float);
+  testSpMV<int>(ComponentType::Int);
+  testSpMV<int64_t>(ComponentType::Int64);
+}
+
+TEST(tensor, int64_components) {
+  // 2^53 + 1 is the smallest integer that a double cannot hold
+  const int64_t big = (int64_t(1) << 53) + 1;
+  Var i("i"), j("j", Var::Sum);
+  Tensor<int64_t> B("B", {2,2}, Format({Dense,Sparse}));
+  Tensor<int64_t> c("c", {2}, Format({Dense}));
+  Tensor<int64_t> a("a", {2}, Format({Dense}));
+  B.insert({0,0}, big);
+  B.insert({1,1}, int64_t(1) << 60);
+  B.pack();
+  c.insert({0}, 1);
+  c.insert({1}, 1);
+  c.pack();
+
+  a(i) = B(i,j) * c(j);
+  a.evaluate();
+  ASSERT_ARRAY_EQ(vector<int64_t>({big, int64_t(1) << 60}),
+                  {(int64_t*)a.getStorage().getValues(), 2});
+
+  // Values inserted as doubles must be integers in the range of int64_t
+  TensorBase d("d", ComponentType::Int64, {2}, Format({Dense}));
+  d.insert({0}, 1e18);
+  d.insert({1}, -9223372036854775808.0);
+  d.pack();
+  ASSERT_ARRAY_EQ(vector<int64_t>({1000000000000000000,
+                                   std::numeric_limits<int64_t>::min()}),
+                  {(int64_t*)d.getStorage().getValues(), 2});
+  TensorBase e("e", ComponentType::Int64, {2}, Format({Dense}));
+  ASSERT_DEATH(e.insert({0}, 1e19), "not an integer in the range");
+  ASSERT_DEATH(e.insert({0}, 0.5), "not an integer in the range");
+}
+
+TEST(tensor, bool_components) {
+  Var i("i"), j("j", Var::Sum);
+  Tensor<bool> B("B", {3,3}, Format({Dense,Sparse}));
+  Tensor<bool> c("c", {3}, Format({Dense}));
+  Tensor<bool> a("a", {3}, Format({Dense}));
+  B.insert({0,1}, true);
+  B.insert({2,0}, true);
+  B.insert({2,2}, true);
+  B.pack();
+  c.insert({0}, true);
+  c.insert({2}, true);
+  c.pack();
+
+  // Sums and products of booleans are their logical or and and
+  a(i) = B(i,j) * c(j);
+  a.evaluate();
+  ASSERT_ARRAY_EQ(vector<bool>({false, false, true}),
+                  {(bool*)a.getStorage().getValues(), 3});
+}
+
+TEST(tensor, pattern_components) {
+  Var i("i"), j("j", Var::Sum);
+  TensorBase B("B", ComponentType::Pattern, {3,3}, Format({Dense,Sparse}));
+  Tensor<double> c("c", {3}, Format({Dense}));
+  Tensor<double> a("a", {3}, Format({Dense}));
+  B.insert({0,1}, 1.0);
+  B.insert({2,0}, 1.0);
+  B.insert({2,2}, 1.0);
+  B.pack();
+  c.insert({0}, 2.0);
+  c.insert({1}, 3.0);
+  c.insert({2}, 4.0);
+  c.pack();
+
+  // Pattern tensors store no values, and their components are one
+  ASSERT_EQ(nullptr, B.getStorage().getValues());
+  ASSERT_EQ(0u, B.getStorage().getSize().numBytesPerValue());
+  for (auto& component : iterate<double>(B)) {
+    ASSERT_EQ(1.0, component.second);
+  }
+
+  a(i) = B(i,j) * c(j);
+  a.evaluate();
+  ASSERT_EQ(string::npos, a.getSource().find("B_vals"));
+  ASSERT_ARRAY_EQ(vector<double>({3.0, 0.0, 6.0}),
+                  {(double*)a.getStorage().getValues(), 3});
+}
+
+TEST(tensor, fixed_iteration) {
+  // Rows of different lengths, including an empty row, are padded to three
+  map<vector<int>, double> vals = {{{0,0}, 1.0}, {{0,2}, 2.0}, {{0,5}, 3.0},
+                                   {{1,4}, 4.0},
+                                   {{3,0}, 5.0}, {{3,1}, 6.0}};
+
+  Tensor<double> A({4,6}, Format({Dense,Fixed}));
+  Tensor<double> B({4,6}, Format({Dense,Sparse}));
+  for (auto& val : vals) {
+    A.insert(val.first, val.second);
+    B.insert(val.first, val.second);
+  }
+  A.pack();
+  B.pack();
+
+  size_t count = 0;
+  for (auto& val : A) {
+    ASSERT_TRUE(util::contains(vals, val.first));
+    ASSERT_EQ(vals.at(val.first), val.second);
+    count++;
+  }
+  ASSERT_EQ(vals.size(), count);
+  ASSERT_TRUE(equals(A, B));
+  ASSERT_TRUE(equals(B, A));
+}
+
+TEST(tensor, fixed_empty_segments) {
+  Var i("i"), j("j"), k("k", Var::Sum);
+  Tensor<double> B("B", {3,4}, Format({Dense,Fixed}));
+  B.insert({0,1}, 2.0);
+  B.insert({0,3}, 3.0);
+  B.insert({2,0}, 0.0);
+  B.pack();
+
+  // The empty row is padded with index -1, so it is told apart from the row
+  // that stores a zero at column 0
+  ASSERT_EQ(-1, B.getStorage().getIndexValue(1, 1, 2));
+  ASSERT_EQ(-1, B.getStorage().getIndexValue(1, 1, 3));
+  vector<vector<int>> coordinates;
+  for (auto& component : B) {
+    coordinates.push_back(component.first);
+  }
+  ASSERT_EQ(vector<vector<int>>({{0,1}, {0,3}, {2,0}}), coordinates);
+
+  // Results store no entries for the empty row
+  Tensor<double> A("A", {3,4}, Format({Dense,Sparse}));
+  A(i,j) = B(i,j) * B(i,j);
+  A.evaluate();
+  ASSERT_EQ(2, A.getStorage().getIndexValue(1, 0, 2));
+  ASSERT_EQ(3u, A.getStorage().getSize().numValues());
+
+  // Reductions skip the padding of the empty row
+  Tensor<double> x("x", {4}, Format({Dense}));
+  for (int c = 0; c < 4; c++) {
+    x.insert({c}, (double)(c + 1));
+  }
+  x.pack();
+  Tensor<double> y("y", {3}, Format({Dense}));
+  y(i) = B(i,k) * x(k);
+  y.evaluate();
+  ASSERT_ARRAY_EQ(vector<double>({16.0, 0.0, 0.0}),
+                  {(double*)y.getStorage().getValues(), 3});
+
+  ASSERT_DEATH(Format({Dense,Fixed}, {0,1}, {IndexWidth::Int32,
+                                              IndexWidth::UInt16}),
+               "cannot have the uint16 index width");
+}
+
+TEST(tensor, hashed_iteration) {
+  map<vector<int>, double> vals = {{{1}, 1.0}, {{4}, 2.0}, {{6}, 3.0}};
+
+  Tensor<double> a({8}, Format({Hashed}));
+  Tensor<double> b({8}, Format({Sparse}));
+  for (auto& val : vals) {
+    a.insert(val.first, val.second);
+    b.insert(val.first, val.second);
+  }
+  a.pack();
+  b.pack();
+
+  // Iteration ends after the stored entries, not after the table slots
+  size_t count = 0;
+  for (auto& val : a) {
+    ASSERT_TRUE(util::contains(vals, val.first));
+    ASSERT_EQ(vals.at(val.first), val.second);
+    count++;
+  }
+  ASSERT_EQ(vals.size(), count);
+  ASSERT_TRUE(equals(a, b));
+  ASSERT_TRUE(equals(b, a));
+}
+
+TEST(tensor, narrow_index_width_result) {
+  // The result has more than 2^16 positions, which its UInt16 pos array
+  // could not hold, so only its idx array is 16-bit
+  Var i("i"), j("j");
+  Tensor<double> D("D", {300,300}, Format({Dense,Sparse}));
+  for (int r = 0; r < 300; r++) {
+    for (int c = 0; c < 300; c++) {
+      D.insert({r,c}, (double)(r + c + 1));
+    }
+  }
+  D.pack();
+
+  Tensor<double> E("E", {300,300}, Format({Dense,Sparse}, {0,1},
+                                          {IndexWidth::Int32,
+                                           IndexWidth::UInt16}));
+  E(i,j) = D(i,j) * D(i,j);
+  E.evaluate();
+
+  ASSERT_EQ(90000u, E.getStorage().getSize().numValues());
+  ASSERT_EQ(4u, E.getStorage().getSize().numBytesPerIndexValue(1,0));
+  ASSERT_EQ(2u, E.getStorage().getSize().numBytesPerIndexValue(1,1));
+  ASSERT_EQ(90000, E.getStorage().getIndexValue(1, 0, 300));
+  for (auto& component : E) {
+    double d = component.first[0] + component.first[1] + 1;
+    ASSERT_EQ(d*d, component.second);
+  }
+}
+
+TEST(tensor, narrow_index_width_too_small) {
+  // Coordinates up to 65535 fit 16 bits, but 69999 does not
+  Format narrow({Sparse}, {0}, {IndexWidth::UInt16});
+  Tensor<double> a("a", {65536}, narrow);
+  a.insert({65535}, 1.0);
+  a.pack();
+  ASSERT_EQ(65535, a.getStorage().getIndexValue(0, 1, 0));
+  ASSERT_DEATH(Tensor<double>("b", {70000}, narrow),
+               "do not fit the uint16 index width");
+}
+
+static size_t countLoops(string source) {
+  size_t loops = 0;
+  for (string loop : {"for (", "while ("}) {
+    for (size_t pos = source.find(loop); pos != string::npos;
+         pos = source.find(loop, pos+1)) {
+      loops++;
+    }
+  }
+  return loops;
+}
+
+TEST(tensor, galloping_source) {
+  Var i("i");
+  Tensor<double> b("b", {10000}, Format({Sparse}));
+  Tensor<double> c("c", {10000}, Format({Sparse}));
+  b.insert({6}, 1.0);
+  b.insert({9000}, 2.0);
+  b.pack();
+  for (int k = 0; k < 10000; k += 3) {
+    c.insert({k}, 1.0);
+  }
+  c.pack();
+
+  Tensor<double> a("a", {10000}, Format({Sparse}));
+  a(i) = b(i) * c(i);
+  a.compile();
+
+  // The search loops of the galloping merge have else branches, and every
+  // closing brace and else of the kernels is on a line of its own
+  string source = a.getSource();
+  string kernels = source.substr(source.find("int assemble("));
+  ASSERT_NE(string::npos, kernels.find("else {"));
+  std::istringstream lines(kernels);
+  for (string line; std::getline(lines, line);) {
+    ASSERT_TRUE(line.empty() || line.back() != ' ') << line;
+    size_t brace = line.find_first_of("}");
+    ASSERT_TRUE(brace == string::npos ||
+                brace == line.find_first_not_of(' ')) << line;
+    size_t elseBranch = line.find("else");
+    ASSERT_TRUE(elseBranch == string::npos ||
+                elseBranch == line.find_first_not_of(' ')) << line;
+  }
+}
+
+TEST(tensor, multiple_outputs) {
+  Var i("i"), j("j", Var::Sum);
+  Format csr({Dense,Sparse});
+  Format dv({Dense});
+
+  Tensor<double> B("B", {10,9}, csr);
+  Tensor<double> c("c", {9}, dv);
+  Tensor<double> e("e", {10}, dv);
+  for (int r = 0; r < 10; r++) {
+    for (int col = 0; col < 9; col++) {
+      if ((r + 2*col) % 3 != 0) {
+        B.insert({r, col}, (double)((r*9 + col) % 7 + 1));
+      }
+    }
+    e.insert({r}, (double)(r + 1));
+  }
+  for (int col = 0; col < 9; col++) {
+    c.insert({col}, (double)(col % 5 + 1));
+  }
+  B.pack();
+  c.pack();
+  e.pack();
+
+  Tensor<double> aExpected("aExpected", {10}, dv);
+  aExpected(i) = B(i,j) * c(j);
+  aExpected.evaluate();
+  Tensor<double> dExpected("dExpected", {10}, dv);
+  dExpected(i) = B(i,j) * c(j) + e(i);
+  dExpected.evaluate();
+
+  Tensor<double> a("a", {10}, dv);
+  a(i) = B(i,j) * c(j);
+  Tensor<double> d("d", {10}, dv);
+  d(i) = B(i,j) * c(j) + e(i);
+  evaluate({a, d});
+  ASSERT_TRUE(equals(aExpected, a));
+  ASSERT_TRUE(equals(dExpected, d));
+
+  // The rows of B are traversed once, by loops that a and d share
+  ASSERT_EQ(a.getSource(), d.getSource());
+  ASSERT_EQ(countLoops(aExpected.getSource()), countLoops(a.getSource()));
+
+  Tensor<double> C("C", {10,9}, csr);
+  for (int r = 0; r < 10; r++) {
+    for (int col = 0; col < 9; col++) {
+      if ((r + col) % 2 == 0) {
+        C.insert({r, col}, (double)(r + col + 1));
+      }
+    }
+  }
+  C.pack();
+
+  Var k("k");
+  Tensor<double> AExpected("AExpected", {10,9}, csr);
+  AExpected(i,k) = B(i,k) * C(i,k);
+  AExpected.evaluate();
+  Tensor<double> DExpected("DExpected", {10,9}, csr);
+  DExpected(i,k) = -(B(i,k) * C(i,k));
+  DExpected.evaluate();
+
+  Tensor<double> A("A", {10,9}, csr);
+  A(i,k) = B(i,k) * C(i,k);
+  Tensor<double> D("D", {10,9}, csr);
+  D(i,k) = -(B(i,k) * C(i,k));
+  evaluate({A, D});
+  ASSERT_TRUE(equals(AExpected, A));
+  ASSERT_TRUE(equals(DExpected, D));
+  ASSERT_EQ(countLoops(AExpected.getSource()), countLoops(A.getSource()));
+}
+
+TEST(tensor, multiple_outputs_single_compute) {
+  Var i("i"), j("j", Var::Sum);
+  Format dv({Dense});
+
+  Tensor<double> B("B", {4,3}, Format({Dense,Sparse}));
+  Tensor<double> c("c", {3}, dv);
+  for (int r = 0; r < 4; r++) {
+    B.insert({r, r % 3}, (double)(r + 1));
+  }
+  for (int col = 0; col < 3; col++) {
+    c.insert({col}, (double)(col + 1));
+  }
+  B.pack();
+  c.pack();
+
+  Tensor<double> expected("expected", {4}, dv);
+  expected(i) = B(i,j) * c(j);
+  expected.evaluate();
+
+  Tensor<double> a("a", {4}, dv);
+  a(i) = B(i,j) * c(j);
+  Tensor<double> d("d", {4}, dv);
+  d(i) = -(B(i,j) * c(j));
+  compile({a, d});
+
+  // The group kernel takes the arguments of every tensor in the group
+  ASSERT_DEATH(a.compute(), "must be computed with them");
+  ASSERT_DEATH(assemble({a}), "group they were compiled in");
+
+  // Tensors of different groups of the same size are not a group
+  Tensor<double> e("e", {4}, dv);
+  e(i) = B(i,j) * c(j);
+  Tensor<double> f("f", {4}, dv);
+  f(i) = -(B(i,j) * c(j));
+  compile({e, f});
+  ASSERT_DEATH(compute({a, e}), "group they were compiled in");
+
+  // Compiling a tensor of the group by itself gives it its own kernel
+  a.compile();
+  a.assemble();
+  a.compute();
+  ASSERT_TRUE(equals(expected, a));
+}
+
+TEST(tensor, fused_producer) {
+  Var i("i"), j("j", Var::Sum), k("k", Var::Sum);
+  Format csr({Dense,Sparse});
+  Format dv({Dense});
+
+  Tensor<double> B("B", {10,8}, csr);
+  Tensor<double> C("C", {8,9}, csr);
+  Tensor<double> x("x", {9}, dv);
+  for (int r = 0; r < 10; r++) {
+    for (int col = 0; col < 8; col++) {
+      if ((r + 2*col) % 3 != 0) {
+        B.insert({r, col}, (double)((r*8 + col) % 7 + 1));
+      }
+    }
+  }
+  for (int r = 0; r < 8; r++) {
+    for (int col = 0; col < 9; col++) {
+      if ((r + col) % 2 == 0) {
+        C.insert({r, col}, (double)(r + col + 1));
+      }
+    }
+  }
+  for (int col = 0; col < 9; col++) {
+    x.insert({col}, (double)(col % 5 + 1));
+  }
+  B.pack();
+  C.pack();
+  x.pack();
+
+  Var jT("j"), kT("k", Var::Sum);
+  Tensor<double> TExpected("TExpected", {10,9}, Format({Dense,Dense}));
+  TExpected(i,jT) = B(i,kT) * C(kT,jT);
+  TExpected.evaluate();
+  Tensor<double> expected("expected", {10}, dv);
+  expected(i) = TExpected(i,j) * x(j);
+  expected.evaluate();
+
+  // The intermediate is never assembled or computed
+  Tensor<double> T("T", {10,9}, csr);
+  T(i,jT) = B(i,kT) * C(kT,jT);
+  Tensor<double> y("y", {10}, dv);
+  y(i) = T(i,j) * x(j);
+  y.fuse(T);
+  y.evaluate();
+  ASSERT_TRUE(equals(expected, y));
+  ASSERT_EQ(string::npos, y.getSource().find("T_vals"));
+}
+
+TEST(tensor, blocked) {
+  Var i("i"), j("j", Var::Sum);
+  Var ib("ib"), ii("ii"), jb("jb", Var::Sum), jj("jj", Var::Sum);
+  Format csr({Dense,Sparse});
+  Format dv({Dense});
+
+  // Two dense 4x4 blocks and a block with two nonzeros
+  Tensor<double> A("A", {12,12}, csr);
+  for (int r = 0; r < 4; r++) {
+    for (int c = 0; c < 4; c++) {
+      A.insert({r, 4+c},   (double)(r*4 + c + 1));
+      A.insert({8+r, c},   (double)(r + c + 2));
+    }
+  }
+  A.insert({5, 9}, 3.0);
+  A.insert({4, 8}, 1.5);
+  A.pack();
+  Tensor<double> x("x", {12}, dv);
+  for (int c = 0; c < 12; c++) {
+    x.insert({c}, (double)(c % 5 + 1));
+  }
+  x.pack();
+  ASSERT_EQ(4, getBlockSize(A));
+  ASSERT_EQ(4, getBlockSize(x));
+
+  Tensor<double> y("y", {12}, dv);
+  y(i) = A(i,j) * x(j);
+  y.evaluate();
+
+  Tensor<double> B = block(A, 4, BCSR);
+  Tensor<double> xb = block(x, 4, Format({Dense,Dense}));
+  Tensor<double> yb("y", {3,4}, Format({Dense,Dense}));
+  yb(ib,ii) = B(ib,jb,ii,jj) * xb(jb,jj);
+  yb.evaluate();
+  ASSERT_TRUE(equals(block(y, 4, Format({Dense,Dense})), yb));
+
+  // Only the block rows and the blocks in them are iterated over
+  ASSERT_EQ(2u, countLoops(yb.getSource()));
+
+  // Tensors of other component types are blocked too
+  Tensor<float> F("F", {12,12}, csr);
+  for (auto& value : A) {
+    F.insert(value.first, (float)value.second);
+  }
+  F.pack();
+  ASSERT_EQ(4, getBlockSize(F));
+  Tensor<float> FB = block(F, 4, BCSR);
+  ASSERT_EQ(ComponentType::Float, FB.getComponentType());
+  ASSERT_EQ(48u, FB.getStorage().getSize().numValues());
+  map<vector<int>,float> nonzeros;
+  for (auto& value : FB) {
+    if (value.second != 0.0f) {
+      nonzeros[{value.first[0]*4 + value.first[2],
+                value.first[1]*4 + value.first[3]}] = value.second;
+    }
+  }
+  map<vector<int>,float> expected;
+  for (auto& value : A) {
+    expected[value.first] = (float)value.second;
+  }
+  ASSERT_EQ(expected, nonzeros);
+}
@@ -80,27 +80,58 @@ void ASSERT_STORAGE_EQUALS(vector<vector<vector<int>>> expectedIndices,
     auto expectedIndex = expectedIndices[i];
     auto index = storage.getDimensionIndex(i);
 
+    // Index arrays store values of the level's index width
+    auto indexArray = [&](size_t n) {
+      vector<int> values(size.numIndexValues(i,n));
+      for (size_t pos = 0; pos < values.size(); ++pos) {
+        values[pos] = (int)storage.getIndexValue(i, n, pos);
+      }
+      return values;
+    };
+
     switch (levels[i].getType()) {
       case DimensionType::Dense: {
         taco_iassert(expectedIndex.size() == 1) <<
             "Dense indices have a ptr array";
         ASSERT_EQ(1u, index.size());
-        ASSERT_ARRAY_EQ(expectedIndex[0], {index[0], size.numIndexValues(i,0)});
+        ASSERT_VECTOR_EQ(expectedIndex[0], indexArray(0));
         break;
       }
       case DimensionType::Sparse:
-      case DimensionType::Fixed: {
+      case DimensionType::Fixed:
+      case DimensionType::Hashed:
+      case DimensionType::Delta: {
         taco_iassert(expectedIndex.size() == 2);
         ASSERT_EQ(2u, index.size());
-        ASSERT_ARRAY_EQ(expectedIndex[0], {index[0], size.numIndexValues(i,0)});
-        ASSERT_ARRAY_EQ(expectedIndex[1], {index[1], size.numIndexValues(i,1)});
+        ASSERT_VECTOR_EQ(expectedIndex[0], indexArray(0));
+        ASSERT_VECTOR_EQ(expectedIndex[1], indexArray(1));
+        break;
+      }
+      case DimensionType::Singleton: {
+        taco_iassert(expectedIndex.size() == 1) <<
+            "Singleton indices have an idx array";
+        ASSERT_EQ(1u, index.size());
+        ASSERT_VECTOR_EQ(expectedIndex[0], indexArray(0));
+        break;
+      }
+      case DimensionType::Bitmap: {
+        taco_iassert(expectedIndex.size() == 3) <<
+            "Bitmap indices have a size, a pos and a bits array";
+        ASSERT_EQ(3u, index.size());
+        ASSERT_VECTOR_EQ(expectedIndex[0], indexArray(0));
+        ASSERT_VECTOR_EQ(expectedIndex[1], indexArray(1));
+        ASSERT_VECTOR_EQ(expectedIndex[2], indexArray(2));
         break;
       }
     }
   }
 
   ASSERT_EQ(expectedValues.size(), storage.getSize().numValues());
-  ASSERT_ARRAY_EQ(expectedValues, {storage.getValues(), size.numValues()});
+  vector<double> values(size.numValues());
+  for (size_t pos = 0; pos < values.size(); pos++) {
+    values[pos] = storage.getValue(pos);
+  }
+  ASSERT_ARRAY_EQ(expectedValues, {values.data(), values.size()});
 }
 
 }}
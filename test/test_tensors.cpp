@@ -186,6 +186,16 @@ TensorData<double> dlb_data() {
   return TensorData<double>({10000}, valsList);
 }
 
+TensorData<double> dlc_data() {
+  return TensorData<double>({10000}, {
+    {{0},    1},
+    {{6},    2},
+    {{4999}, 3},
+    {{9000}, 4},
+    {{9999}, 5}
+  });
+}
+
 TensorData<double> d33a_data() {
   return TensorData<double>({3,3}, {
     {{0,1}, 2},
@@ -402,6 +412,10 @@ Tensor<double> dlb(std::string name, Format format) {
   return dlb_data().makeTensor(name, format);
 }
 
+Tensor<double> dlc(std::string name, Format format) {
+  return dlc_data().makeTensor(name, format);
+}
+
 Tensor<double> d33a(std::string name, Format format) {
   return d33a_data().makeTensor(name, format);
 }
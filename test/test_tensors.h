@@ -109,6 +109,7 @@ TensorData<double> d8c_data();
 
 TensorData<double> dla_data();
 TensorData<double> dlb_data();
+TensorData<double> dlc_data();
 
 TensorData<double> d33a_data();
 TensorData<double> d33at_data();
@@ -151,6 +152,7 @@ Tensor<double> d8c(std::string name, Format format);
 
 Tensor<double> dla(std::string name, Format format);
 Tensor<double> dlb(std::string name, Format format);
+Tensor<double> dlc(std::string name, Format format);
 
 Tensor<double> d33a(std::string name, Format format);
 Tensor<double> d33at(std::string name, Format format);
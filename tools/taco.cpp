@@ -85,9 +85,10 @@ static void printUsageInfo() {
   cout << endl;
   printFlag("f=<format>",
             "Specify the format of a tensor in the expression. Formats are "
-            "specified per dimension using d (dense) and s (sparse). "
-            "All formats default to dense. "
-            "Examples: A:ds, b:d and D:sss.");
+            "specified per dimension using d (dense), s (sparse), f "
+            "(fixed), q (singleton), h (hashed), b (bitmap) and z (delta). "
+            "All formats default to dense. Examples: A:ds, b:d, D:sss, E:df "
+            "(ELL), F:sq (COO), g:h, H:db and I:dz.");
   cout << endl;
   printFlag("i=<file>",
             "Read a matrix from file in HB or MTX file format.");
@@ -214,6 +215,21 @@ int main(int argc, char* argv[]) {
           case 's':
             levelTypes.push_back(DimensionType::Sparse);
             break;
+          case 'f':
+            levelTypes.push_back(DimensionType::Fixed);
+            break;
+          case 'q':
+            levelTypes.push_back(DimensionType::Singleton);
+            break;
+          case 'h':
+            levelTypes.push_back(DimensionType::Hashed);
+            break;
+          case 'b':
+            levelTypes.push_back(DimensionType::Bitmap);
+            break;
+          case 'z':
+            levelTypes.push_back(DimensionType::Delta);
+            break;
           default:
             return reportError("Incorrect format descriptor", 3);
             break;